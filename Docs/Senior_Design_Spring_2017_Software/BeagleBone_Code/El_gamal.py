@@ -26,16 +26,42 @@ import binascii
 import serial
 import datetime
 import time
+import threading
+import key_store
+import node_protocol
 
+KEY_STORE_PATH = "node_keys.db"
+TEXT_KEYS_PATH = "test_keys.txt"
  
 
 
-UART.setup("UART1")
-ser = serial.Serial(port = "/dev/ttyO1", baudrate=9600)
-ser.close()
-ser.open()
-if ser.isOpen():
-    print "Serial is open!"
+ser = None      #coordinator serial port, opened by the first send_rekey() without a port
+store = None    #node key store, opened by the first lookup and kept for the process
+store_lock = threading.Lock()
+
+
+def open_serial():
+    #The port is opened on first use, so gateway.py can import this module next to
+    #its own port without the import rekeying the node
+    global ser
+    if ser is None:
+        UART.setup("UART1")
+        ser = serial.Serial(port = "/dev/ttyO1", baudrate=node_protocol.BAUD)
+        ser.close()
+        ser.open()
+        if ser.isOpen():
+            print "Serial is open!"
+    return ser
+
+
+def open_store():
+    #One mmap of the key store per process. Reopening it for every lookup costs
+    #more than the lookup itself, and gateway.py and the pool look keys up often.
+    global store
+    with store_lock:
+        if store is None:
+            store = key_store.KeyStore.open_or_convert(KEY_STORE_PATH, TEXT_KEYS_PATH)
+    return store
 
 Pcurve  = 6277101735386680763835789423207666416083908700390324961279    
 N       = 0xFFFFFFFFFFFFFFFFFFFFFFFE26F2FC170F69466A74DEFD8D            
@@ -214,58 +240,71 @@ setup_new_node()
 
 
 
-def get_public_key():
-    #y_val = int(text_file.readline(),16)
-    
-    text_file=open("test_keys.txt",'r')
-    line =  text_file.readline()
-    line = line.split(';')
-    
-    x_val = line[1]
-    y_val = line[2] 
-    
-    print(x_val)
-    print(y_val)
-    new_x = int(x_val,16)
-    new_y = int(y_val,16)
-    Y = (new_x,new_y) 
+def get_public_key(serial=None):
+    #Node public keys live in the binary key store, keyed by the node's XBee
+    #serial number (SH << 32 | SL). The store is built from test_keys.txt the
+    #first time it is needed. Without a serial the first provisioned node is used.
+    keys = open_store()
+    if serial is None:
+        serial = keys.first_serial()
+    Y = keys.public_key(serial)
+
+    print("Node %016X" % serial)
+    print(hex(Y[0]))
+    print(hex(Y[1]))
     return Y
 
 
-def setup_and_rekey(Node_Public_Key, N): #Function returns R, C, and the 128-bit session key
-    
-    k = 636970447367871056343245836125454310096609638400 #message private key
-    
-    
-
-    message_generator = random.randint(2000,N-1 )
-    #message_generator=10
-    print "This is the random message generator %s\n" %message_generator
+def save_session_key(serial, session_key):
+    #Record the session key handed to a node so the coordinator can look it up later
+    keys = open_store()
+    if serial is None:
+        serial = keys.first_serial()
+    return keys.set_session_key(serial, int(session_key.rstrip('L'), 16))
+
+
+def send_rekey(R, C, benchmark=False, port=None):
+    #Send R and C to the node as '3' + R.x + R.y + C.x + C.y, 24 bytes each, big endian.
+    #The node recovers M = C - kR and derives the same session key as setup_and_rekey.
+    #With benchmark=True the node ('4') times its FPGA and software engines instead and
+    #answers with "SW <us> FPGA <us> MATCH|DIFF".
+    #port: anything with write(), /dev/ttyO1 if not given
+    frame = b'4' if benchmark else b'3'
+    for value in (R[0], R[1], C[0], C[1]):
+        frame += key_store.int_to_bytes(value, key_store.COORD_BYTES)
+    (port or open_serial()).write(frame)
+
+
+def new_ephemeral(rng=random.SystemRandom()):
+    #The part of a rekey that needs no node data: message key k and R = kG, message M = mG
+    #and the session key taken from M. rekey_pool.py computes these ahead of time.
+    #Returns (k, R, M, session key hex string)
+    k = rng.randint(1, N - 1)                          #message private key, fresh every rekey
+    R = EccMultiply(GPoint, k)                          # R = message Public key
+    message_generator = rng.randint(2000, N - 1)
     M = EccMultiply(GPoint, message_generator)
+    f = str(hex(M[0]))[0:34]                            #first 32 hex digits, the node derives the same
+    return (k, R, M, f)
 
-    f = str(hex(M[0]))[0:34]
-    session_key = int(f,16)
+
+def setup_and_rekey(Node_Public_Key, N, pool=None): #Function returns R, C, and the 128-bit session key
+    #pool: a rekey_pool.EphemeralPool, without one k, R and M are computed here. Either way
+    #only C = kY + M depends on the node
+    k, R, M, f = pool.take() if pool is not None else new_ephemeral()
     print("my session key")
     print(f)
-    
-    
-   # ser.write(f) set as my session key
-    print "This  the message %s\n" %message_generator
-
-    R = EccMultiply(GPoint,k)           # R = message Public key 
 
     C = ECadd(EccMultiply(Node_Public_Key,k), M)
-    
-    
-    
-    
+
     return [R,C,f]
     
 
-print("Rewriting Keys")
+if __name__ == '__main__':
+    print("Rewriting Keys")
 
-Public_key = get_public_key()
+    Public_key = get_public_key()
 
-var =setup_and_rekey(Public_key,N)
-print(var[2])
+    var =setup_and_rekey(Public_key,N)
+    print(var[2])
+    save_session_key(None, var[2])
 
@@ -0,0 +1,454 @@
+#Coordinator gateway: a local request API in front of the coordinator serial port.
+#
+#Replaces the Dropbox round trip (user.txt / keys.txt -> download.py -> pyinotify ->
+#user_request.py / keys_request.py -> /dev/ttyO1) for local clients. One process owns
+#the serial port: it writes the node commands (node_protocol.py) and the rekey frame
+#(El_gamal.py), reads everything the node sends like receive.py does, saves the images
+#and answers the request that caused them with their image IDs.
+#
+#Requests, the same over both interfaces:
+#   status | capture [count] | rekey [node serial hex] | command <name> [value] | pool
+#   (command takes the node_protocol.py names: quality 20, resolution 320x240, energy ...)
+#   (pool: depth and refill rate of the precomputed rekey values, rekey_pool.py)
+#
+#Unix socket (default /tmp/coordinator.sock), one request per line, one JSON line back:
+#   echo "capture 2" | socat - UNIX-CONNECT:/tmp/coordinator.sock
+#HTTP (default 127.0.0.1:8080), GET or POST, JSON back, images by ID:
+#   curl "http://127.0.0.1:8080/capture?count=2"
+#   curl "http://127.0.0.1:8080/command?name=quality&value=20"
+#   curl -o image.jpg "http://127.0.0.1:8080/images/<id>"
+#
+#An image ID is <date>-<time>-<node ID>, the file is <images>/<id>.jpg. A capture answers
+#with the IDs of the images that arrive after the node's answer; images still queued in
+#the node's flash from before are sent first and are reported in their place.
+#
+#--mirror keeps the cloud path as an asynchronous side channel: saved images are uploaded
+#with dropbox_uploader.sh and user.txt / keys.txt are polled and run as requests, off the
+#path of the local requests.
+#
+#Testing without a node, against a pty:
+#   socat -d -d pty,raw,echo=0 pty,raw,echo=0       (prints two /dev/pts/N)
+#   python gateway.py --port /dev/pts/N              (a node emulator on the other end)
+#
+#Works with Python 2.7 (BeagleBone) and Python 3, rekey needs El_gamal.py (Python 2.7).
+#
+#Usage:
+#   python gateway.py [--port /dev/ttyO1] [--socket PATH] [--http HOST:PORT] [--images DIR] [--mirror]
+
+import datetime
+import json
+import os
+import subprocess
+import sys
+import threading
+import time
+
+import serial
+
+import node_protocol
+
+try:
+    import Queue as queue
+    import SocketServer as socketserver
+    from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+    from urlparse import urlparse, parse_qs
+except ImportError:
+    import queue
+    import socketserver
+    from http.server import BaseHTTPRequestHandler, HTTPServer
+    from urllib.parse import urlparse, parse_qs
+
+DEFAULT_PORT = '/dev/ttyO1'
+DEFAULT_SOCKET = '/tmp/coordinator.sock'
+DEFAULT_HTTP = '127.0.0.1:8080'
+DEFAULT_IMAGES = 'IMAGES'
+
+REPLY_TIMEOUT = 30          #s, a capture answers after the frames are in the node's flash
+IMAGE_TIMEOUT = 60          #s per image, 60 kB take about 14 s at the 35 kbit/s the radio gets through
+REKEY_TIMEOUT = 30          #s, decryption and the ATEE / ATKY guard times of apply_session_key()
+OK_COUNT = 3                #"OK"s apply_session_key() sends to the coordinator
+
+UPLOADER = '/root/Dropbox-Uploader/dropbox_uploader.sh'
+CLOUD_FOLDER = 'senior_design Team Folder/IMAGES'
+POLL_INTERVAL = 10          #s between user.txt / keys.txt downloads with --mirror
+
+
+class GatewayError(Exception):
+    pass
+
+
+class Gateway(object):
+    #Serial port owner. The reader thread parses the stream, requests wait on the condition
+
+    def __init__(self, ser, image_dir, on_image=None, pool=None):
+        self.ser = ser
+        self.image_dir = image_dir
+        self.on_image = on_image            #called with the path of every saved image
+        self.pool = pool                    #rekey_pool.EphemeralPool, None where El_gamal.py does not load
+        self.write_lock = threading.Lock()
+        self.request_lock = threading.Lock()    #the node runs one command at a time
+        self.cond = threading.Condition()
+        self.replies = []                   #(opcode, payload, trailer) not collected yet
+        self.images = []                    #IDs saved since the current request started
+        self.ok_count = 0
+        self.image_seq = None               #sequence number of the IMAGE frame announced last
+        self.running = True
+        if not os.path.isdir(image_dir):
+            os.makedirs(image_dir)
+
+    def write(self, data):
+        with self.write_lock:
+            self.ser.write(data)
+
+    # ---------------------------------------------------------------- reader
+
+    def read_loop(self):
+        last = None
+        while self.running:
+            byte = bytearray(self.ser.read(1))
+            if not byte:
+                continue
+            b = byte[0]
+            if b == node_protocol.IMAGE_MARKER:
+                self.read_image()
+            elif b == node_protocol.SOF:
+                self.read_reply()
+            elif last == ord('O') and b == ord('K'):
+                with self.cond:
+                    self.ok_count += 1
+                    self.cond.notify_all()
+            last = b
+
+    def read_reply(self):
+        reply = node_protocol.read_frame(self.ser, sof_read=True)
+        if reply is None or reply[0] is None:
+            return
+        opcode, payload = reply
+        if opcode == node_protocol.IMAGE:
+            self.image_seq, length = node_protocol.image_info(payload)
+            return
+        if not opcode & node_protocol.REPLY:
+            return
+        trailer = b''
+        if opcode & ~node_protocol.REPLY == node_protocol.ENERGY and len(payload) >= 3 and payload[0] == 0:
+            trailer = node_protocol.read_payload(self.ser, payload[1] << 8 | payload[2])    #report text after the answer
+        with self.cond:
+            self.replies.append((opcode & ~node_protocol.REPLY, payload, trailer))
+            self.cond.notify_all()
+
+    def read_image(self):
+        #Header (marker already read), then the JPEG, like receive.py
+        header = bytearray([node_protocol.IMAGE_MARKER]) + bytearray(self.ser.read(node_protocol.IMAGE_HEADER_LEN - 1))
+        info = node_protocol.parse_image_header(header)
+        seq, self.image_seq = self.image_seq, None
+        if info is None:
+            print('bad image header')
+            return
+        payload = node_protocol.read_payload(self.ser, info['length'])    #longer than the port timeout
+        if not node_protocol.image_ok(info, payload):
+            print('image of %d bytes, %d read, CRC error' % (info['length'], len(payload)))
+            return      #not acknowledged, a queued image comes again
+
+        image_id = self.new_id(info['node'])
+        path = os.path.join(self.image_dir, image_id + '.jpg')
+        with open(path, 'wb') as f:
+            f.write(payload)
+        if seq is not None:
+            self.write(node_protocol.ack_frame(seq))
+        print('image %s from node %08X, %d bytes' % (image_id, info['node'], info['length']))
+
+        with self.cond:
+            self.images.append(image_id)
+            self.cond.notify_all()
+        if self.on_image:
+            self.on_image(path)
+
+    def new_id(self, node):
+        stamp = datetime.datetime.now().strftime('%Y%m%d-%H%M%S')
+        image_id = '%s-%08X' % (stamp, node)
+        n = 1
+        while os.path.exists(os.path.join(self.image_dir, image_id + '.jpg')):
+            n += 1      #burst, more than one image of the node within the second
+            image_id = '%s-%08X-%d' % (stamp, node, n)
+        return image_id
+
+    # ---------------------------------------------------------------- requests
+
+    def wait(self, ready, timeout):
+        #Wait on the condition until ready() (called with it held) is true, False on timeout
+        deadline = time.time() + timeout
+        with self.cond:
+            while not ready():
+                left = deadline - time.time()
+                if left <= 0:
+                    return False
+                self.cond.wait(left)
+        return True
+
+    def command(self, name, value=None):
+        #One node_protocol.py command, returns its answer as a dict
+        frame = node_protocol.command_frame(name, value)
+        opcode = bytearray(frame)[1]
+        with self.request_lock:
+            with self.cond:
+                self.replies = []
+                self.images = []
+            self.write(frame)
+            return self.collect(opcode)
+
+    def collect(self, opcode):
+        found = []
+
+        def ready():
+            for reply in self.replies:
+                if reply[0] == opcode:
+                    found.append(reply)
+                    return True
+            return False
+
+        if not self.wait(ready, REPLY_TIMEOUT):
+            raise GatewayError('no answer from the node')
+        opcode, payload, trailer = found[0]
+        status = payload[0] if payload else len(node_protocol.STATUS_NAMES)
+        result = {'status': node_protocol.STATUS_NAMES[status] if status < len(node_protocol.STATUS_NAMES) else status,
+                  'answer': node_protocol.describe(opcode | node_protocol.REPLY, payload),
+                  'data': list(payload[1:])}
+        if trailer:
+            result['report'] = trailer.decode('ascii', 'replace')
+        return result
+
+    def capture(self, count=None):
+        #CAPTURE, then the images it produced, returns the answer with their IDs
+        with self.request_lock:
+            with self.cond:
+                self.replies = []
+                self.images = []
+            self.write(node_protocol.command_frame('capture', count))
+            result = self.collect(node_protocol.CAPTURE)
+            expected = result['data'][0] if result['data'] else 0
+            self.wait(lambda: len(self.images) >= expected, IMAGE_TIMEOUT * max(expected, 1))
+            with self.cond:
+                result['images'] = self.images[:expected]
+            if len(result['images']) < expected:
+                result['status'] = 'TIMEOUT'
+            return result
+
+    def rekey(self, node=None):
+        #Fresh session key for a node (hex serial, the first provisioned node if None),
+        #done when the node sends its OKs
+        import El_gamal      #Python 2.7 only, loaded for the first rekey
+
+        serial_no = int(node, 16) if node else None
+        with self.request_lock:
+            public_key = El_gamal.get_public_key(serial_no)
+            R, C, session_key = El_gamal.setup_and_rekey(public_key, El_gamal.N, self.pool)
+            El_gamal.save_session_key(serial_no, session_key)
+            with self.cond:
+                self.ok_count = 0
+            El_gamal.send_rekey(R, C, port=self)
+            if not self.wait(lambda: self.ok_count >= OK_COUNT, REKEY_TIMEOUT):
+                return {'status': 'TIMEOUT', 'answer': 'node did not confirm the key'}
+        return {'status': 'OK', 'answer': 'session key loaded'}
+
+    def run(self, words):
+        #Dispatch a request given as words, e.g. ['capture', '2']
+        if not words:
+            raise GatewayError('empty request')
+        name, args = words[0], words[1:]
+        if name == 'status':
+            return self.command('status')
+        if name == 'capture':
+            return self.capture(args[0] if args else None)
+        if name == 'rekey':
+            return self.rekey(args[0] if args else None)
+        if name == 'command' and args:
+            return self.command(args[0], args[1] if len(args) > 1 else None)
+        if name == 'pool':
+            if self.pool is None:
+                raise GatewayError('no rekey pool, El_gamal.py needs Python 2.7')
+            result = self.pool.metrics()
+            result['status'] = 'OK'
+            return result
+        raise GatewayError('unknown request ' + ' '.join(words))
+
+
+def answer(gateway, words):
+    #Request to a JSON-able dict, errors included
+    try:
+        return gateway.run(words)
+    except (GatewayError, ValueError, IndexError, KeyError) as e:
+        return {'status': 'ERROR', 'answer': str(e)}
+
+
+# -------------------------------------------------------------------- servers
+
+class SocketHandler(socketserver.StreamRequestHandler):
+    def handle(self):
+        for line in self.rfile:
+            words = line.decode('ascii', 'replace').split()
+            if not words:
+                continue
+            result = answer(self.server.gateway, words)
+            try:
+                self.wfile.write((json.dumps(result) + '\n').encode('ascii'))
+            except (IOError, OSError):
+                return      #client gone before the node answered
+
+
+class SocketServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+
+class HttpHandler(BaseHTTPRequestHandler):
+    def do_GET(self):
+        url = urlparse(self.path)
+        query = dict((k, v[0]) for k, v in parse_qs(url.query).items())
+        parts = [p for p in url.path.split('/') if p]
+        if len(parts) == 2 and parts[0] == 'images':
+            return self.send_image(parts[1])
+
+        words = parts[:1]
+        if parts[:1] == ['capture'] and 'count' in query:
+            words.append(query['count'])
+        elif parts[:1] == ['rekey'] and 'node' in query:
+            words.append(query['node'])
+        elif parts[:1] == ['command']:
+            words += [query.get('name', '')] + ([query['value']] if 'value' in query else [])
+        result = answer(self.server.gateway, words)
+        self.send(200 if result['status'] != 'ERROR' else 400, 'application/json', json.dumps(result).encode('ascii'))
+
+    do_POST = do_GET
+
+    def send_image(self, image_id):
+        path = os.path.join(self.server.gateway.image_dir, os.path.basename(image_id) + '.jpg')
+        if not os.path.isfile(path):
+            return self.send(404, 'application/json', b'{"status": "ERROR", "answer": "no such image"}')
+        with open(path, 'rb') as f:
+            self.send(200, 'image/jpeg', f.read())
+
+    def send(self, code, content_type, body):
+        self.send_response(code)
+        self.send_header('Content-Type', content_type)
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, fmt, *args):
+        pass
+
+
+class HttpServer(socketserver.ThreadingMixIn, HTTPServer):
+    daemon_threads = True
+
+
+# -------------------------------------------------------------------- cloud mirror
+
+class Mirror(object):
+    #Dropbox side channel: uploads saved images and polls user.txt / keys.txt, in its own
+    #threads so a slow or missing cloud never delays a local request
+
+    def __init__(self, gateway, work_dir):
+        self.gateway = gateway
+        self.work_dir = work_dir
+        self.uploads = queue.Queue()
+
+    def start(self):
+        for target in (self.upload_loop, self.poll_loop):
+            t = threading.Thread(target=target)
+            t.daemon = True
+            t.start()
+
+    def uploader(self, *args):
+        return subprocess.call([UPLOADER] + list(args)) == 0
+
+    def upload_loop(self):
+        while True:
+            path = self.uploads.get()
+            if not self.uploader('-s', 'upload', path, CLOUD_FOLDER + '/'):
+                print('mirror: upload of %s failed' % path)
+
+    def fetch(self, name):
+        #Download and delete a request file, returns its first line or None
+        local = os.path.join(self.work_dir, name)
+        if os.path.exists(local):
+            os.remove(local)
+        if not self.uploader('-q', 'download', CLOUD_FOLDER + '/' + name, local) or not os.path.exists(local):
+            return None
+        with open(local) as f:
+            line = f.readline()
+        os.remove(local)
+        self.uploader('-q', 'delete', CLOUD_FOLDER + '/' + name)
+        return line
+
+    def poll_loop(self):
+        while True:
+            line = self.fetch('user.txt')
+            if line and line.startswith('5'):
+                print('mirror: capture %s' % answer(self.gateway, ['capture']))
+            elif line and line.startswith('7'):
+                print('mirror: %s' % answer(self.gateway, ['command'] + line.split()[1:]))
+            if self.fetch('keys.txt') is not None:
+                print('mirror: rekey %s' % answer(self.gateway, ['rekey']))
+            time.sleep(POLL_INTERVAL)
+
+
+def main(argv):
+    options = {'--port': DEFAULT_PORT, '--socket': DEFAULT_SOCKET, '--http': DEFAULT_HTTP,
+               '--images': DEFAULT_IMAGES}
+    mirror = False
+    args = argv[1:]
+    while args:
+        arg = args.pop(0)
+        if arg == '--mirror':
+            mirror = True
+        elif arg in options and args:
+            options[arg] = args.pop(0)
+        else:
+            print('usage: python gateway.py [--port /dev/ttyO1] [--socket PATH] [--http HOST:PORT]'
+                  ' [--images DIR] [--mirror]')
+            return 1
+
+    if options['--port'] == DEFAULT_PORT:
+        import Adafruit_BBIO.UART as UART
+        UART.setup("UART1")
+    ser = serial.Serial(port=options['--port'], baudrate=node_protocol.BAUD, timeout=1)     #1 s without a byte ends a read
+    try:
+        import rekey_pool
+        pool = rekey_pool.EphemeralPool().start()     #k, R and M ready before the first rekey
+    except (ImportError, SyntaxError):
+        pool = None
+    gateway = Gateway(ser, options['--images'], pool=pool)
+
+    if mirror:
+        cloud = Mirror(gateway, os.path.dirname(os.path.abspath(options['--images'])))
+        gateway.on_image = cloud.uploads.put
+        cloud.start()
+
+    reader = threading.Thread(target=gateway.read_loop)
+    reader.daemon = True
+    reader.start()
+
+    if os.path.exists(options['--socket']):
+        os.remove(options['--socket'])
+    unix = SocketServer(options['--socket'], SocketHandler)
+    unix.gateway = gateway
+    t = threading.Thread(target=unix.serve_forever)
+    t.daemon = True
+    t.start()
+
+    host, port = options['--http'].rsplit(':', 1)
+    http = HttpServer((host, int(port)), HttpHandler)
+    http.gateway = gateway
+    print('gateway on %s, %s and http://%s' % (options['--port'], options['--socket'], options['--http']))
+    try:
+        http.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        gateway.running = False
+        os.remove(options['--socket'])
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
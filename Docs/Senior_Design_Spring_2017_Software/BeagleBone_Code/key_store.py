@@ -0,0 +1,330 @@
+#Binary node key store for the coordinator.
+#
+#Replaces the flat test_keys.txt scan with a memory-mapped file keyed by the
+#64-bit XBee serial number (SH << 32 | SL) that every node sends at boot.
+#Lookups hash the serial into an open addressing table that lives in the file
+#itself, so finding a node's public key and session key is O(1) and touches a
+#single 80 byte slot.
+#
+#File layout (little endian):
+#   header  : magic, version, slot size, capacity, count           (64 bytes)
+#   slots   : capacity * SLOT_SIZE, linear probing on serial hash
+#
+#Slot layout:
+#   serial (u64) | state (u8) | pad | key epoch (u32) | X (24) | Y (24) | session key (16)
+#
+#Works with Python 2.7 (BeagleBone) and Python 3.
+#
+#Usage:
+#   python key_store.py convert test_keys.txt node_keys.db
+#   python key_store.py sync test_keys.txt node_keys.db
+#   python key_store.py lookup node_keys.db 0013A20040E5F131
+#   python key_store.py list node_keys.db
+
+import mmap
+import os
+import struct
+import sys
+
+MAGIC = b'NKS1'
+VERSION = 1
+
+HEADER_FMT = '<4sHHII'
+HEADER_SIZE = 64
+SLOT_FMT = '<QB3xI24s24s16s'
+SLOT_SIZE = struct.calcsize(SLOT_FMT)   # 80 bytes
+
+STATE_EMPTY = 0
+STATE_VALID = 1
+
+COORD_BYTES = 24        # P-192 coordinate
+SESSION_KEY_BYTES = 16  # 128-bit XBee link key
+
+DEFAULT_CAPACITY = 64   # slots, always a power of two
+MAX_LOAD = 0.5          # grow the table before probe chains get long
+
+_OFF_STATE = 8          # byte offset of the state flag inside a slot
+_OFF_EPOCH = 12
+_OFF_SESSION = 12 + 4 + 2 * COORD_BYTES
+
+
+def serial_from_parts(sh, sl):
+    #SH/SL as sent by the node (ATSH/ATSL hex strings) to a 64-bit serial
+    return (int(sh, 16) << 32) | int(sl, 16)
+
+
+def int_to_bytes(value, length):
+    out = bytearray(length)
+    for i in range(length - 1, -1, -1):
+        out[i] = value & 0xFF
+        value >>= 8
+    return bytes(out)
+
+
+def bytes_to_int(data):
+    value = 0
+    for b in bytearray(data):
+        value = (value << 8) | b
+    return value
+
+
+def _hash(serial, bits):
+    #Fibonacci hashing, the XBee serials share their upper 32 bits (0013A200)
+    return ((serial * 0x9E3779B97F4A7C15) & 0xFFFFFFFFFFFFFFFF) >> (64 - bits)
+
+
+class NodeRecord(object):
+    def __init__(self, serial, public_key, session_key, key_epoch):
+        self.serial = serial
+        self.public_key = public_key    # (X, Y) as integers
+        self.session_key = session_key  # integer, 0 if never rekeyed
+        self.key_epoch = key_epoch      # incremented on every session key change
+
+    def __repr__(self):
+        return 'NodeRecord(%016X, epoch %d)' % (self.serial, self.key_epoch)
+
+
+class KeyStore(object):
+
+    def __init__(self, path):
+        self.path = path
+        self._file = open(path, 'r+b')
+        self._map = mmap.mmap(self._file.fileno(), 0)
+        magic, version, slot_size, capacity, count = struct.unpack_from(HEADER_FMT, self._map, 0)
+        if magic != MAGIC or version != VERSION or slot_size != SLOT_SIZE:
+            self.close()
+            raise ValueError('%s is not a node key store' % path)
+        self.capacity = capacity
+        self.count = count
+        self._bits = capacity.bit_length() - 1
+
+    @staticmethod
+    def create(path, capacity=DEFAULT_CAPACITY, records=()):
+        #The table is built in a temporary file and renamed into place, so a
+        #crash while creating or growing never leaves a half written store.
+        if capacity & (capacity - 1):
+            raise ValueError('capacity must be a power of two')
+        tmp_path = path + '.tmp'
+        f = open(tmp_path, 'wb')
+        header = struct.pack(HEADER_FMT, MAGIC, VERSION, SLOT_SIZE, capacity, 0)
+        f.write(header + b'\0' * (HEADER_SIZE - len(header)))
+        f.write(b'\0' * (SLOT_SIZE * capacity))
+        f.close()
+        store = KeyStore(tmp_path)
+        for record in records:
+            store._insert_record(record)
+        store._map.flush()
+        os.fsync(store._file.fileno())
+        store.close()
+        os.rename(tmp_path, path)
+        return KeyStore(path)
+
+    @staticmethod
+    def open_or_convert(path, text_path):
+        #Open the binary store, building it from the text key file on first use.
+        #Nodes provisioned or re-keyed in the text file since then are taken over
+        if not os.path.exists(path):
+            convert(text_path, path)
+            return KeyStore(path)
+        store = KeyStore(path)
+        store.sync(text_path)
+        return store
+
+    def close(self):
+        if self._map is not None:
+            self._map.close()
+            self._map = None
+        if self._file is not None:
+            self._file.close()
+            self._file = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __len__(self):
+        return self.count
+
+    #Slot helpers
+
+    def _slot_offset(self, index):
+        return HEADER_SIZE + index * SLOT_SIZE
+
+    def _find(self, serial):
+        #Returns (slot offset, found); offset is the insertion point when not found
+        mask = self.capacity - 1
+        index = _hash(serial, self._bits)
+        for _ in range(self.capacity):
+            off = self._slot_offset(index)
+            slot_serial, state = struct.unpack_from('<QB', self._map, off)
+            if state == STATE_EMPTY:
+                return off, False
+            if slot_serial == serial:
+                return off, True
+            index = (index + 1) & mask
+        return None, False
+
+    def _write_count(self, count):
+        self.count = count
+        struct.pack_into('<I', self._map, 12, count)
+
+    #Public interface
+
+    def lookup(self, serial):
+        off, found = self._find(serial)
+        if not found:
+            return None
+        serial, state, epoch, x, y, session = struct.unpack_from(SLOT_FMT, self._map, off)
+        return NodeRecord(serial, (bytes_to_int(x), bytes_to_int(y)), bytes_to_int(session), epoch)
+
+    def public_key(self, serial):
+        off, found = self._find(serial)
+        if not found:
+            raise KeyError('unknown node %016X' % serial)
+        x = self._map[off + 16:off + 16 + COORD_BYTES]
+        y = self._map[off + 16 + COORD_BYTES:off + 16 + 2 * COORD_BYTES]
+        return (bytes_to_int(x), bytes_to_int(y))
+
+    def first_serial(self):
+        #Stand-in for the old "first line of test_keys.txt" behaviour
+        for index in range(self.capacity):
+            slot_serial, state = struct.unpack_from('<QB', self._map, self._slot_offset(index))
+            if state == STATE_VALID:
+                return slot_serial
+        raise KeyError('key store is empty')
+
+    def serials(self):
+        for index in range(self.capacity):
+            slot_serial, state = struct.unpack_from('<QB', self._map, self._slot_offset(index))
+            if state == STATE_VALID:
+                yield slot_serial
+
+    def append(self, serial, public_key):
+        #Provision a new node. The slot body is written and flushed before the
+        #state byte flips to valid, so a crash never exposes a partial record.
+        if (self.count + 1) > self.capacity * MAX_LOAD:
+            self._grow()
+        off, found = self._find(serial)
+        if found:
+            raise KeyError('node %016X already provisioned' % serial)
+        body = struct.pack(SLOT_FMT, serial, STATE_EMPTY, 0,
+                           int_to_bytes(public_key[0], COORD_BYTES),
+                           int_to_bytes(public_key[1], COORD_BYTES),
+                           b'\0' * SESSION_KEY_BYTES)
+        self._map[off:off + SLOT_SIZE] = body
+        self._map.flush()
+        self._map[off + _OFF_STATE:off + _OFF_STATE + 1] = struct.pack('<B', STATE_VALID)
+        self._write_count(self.count + 1)
+        self._map.flush()
+
+    def set_public_key(self, serial, public_key):
+        #Re-provision a node with a new key pair, its session key is kept
+        off, found = self._find(serial)
+        if not found:
+            raise KeyError('unknown node %016X' % serial)
+        self._map[off + 16:off + 16 + 2 * COORD_BYTES] = \
+            int_to_bytes(public_key[0], COORD_BYTES) + int_to_bytes(public_key[1], COORD_BYTES)
+        self._map.flush()
+
+    def sync(self, text_path):
+        #Take over the public keys of a test_keys.txt file, returns the number of changed nodes
+        changed = 0
+        for serial, public_key in parse_text_keys(text_path):
+            off, found = self._find(serial)
+            if not found:
+                self.append(serial, public_key)
+            elif self.public_key(serial) != public_key:
+                self.set_public_key(serial, public_key)
+            else:
+                continue
+            changed += 1
+        return changed
+
+    def set_session_key(self, serial, session_key):
+        off, found = self._find(serial)
+        if not found:
+            raise KeyError('unknown node %016X' % serial)
+        epoch = struct.unpack_from('<I', self._map, off + _OFF_EPOCH)[0] + 1
+        self._map[off + _OFF_SESSION:off + _OFF_SESSION + SESSION_KEY_BYTES] = \
+            int_to_bytes(session_key, SESSION_KEY_BYTES)
+        struct.pack_into('<I', self._map, off + _OFF_EPOCH, epoch)
+        self._map.flush()
+        return epoch
+
+    def _grow(self):
+        #Rehash into a table twice the size and swap it in with an atomic rename
+        records = [self.lookup(serial) for serial in self.serials()]
+        capacity = self.capacity * 2
+        self.close()
+        bigger = KeyStore.create(self.path, capacity, records)
+        self._file, self._map = bigger._file, bigger._map
+        self.capacity, self.count, self._bits = bigger.capacity, bigger.count, bigger._bits
+
+    def _insert_record(self, record):
+        off, found = self._find(record.serial)
+        self._map[off:off + SLOT_SIZE] = struct.pack(
+            SLOT_FMT, record.serial, STATE_VALID, record.key_epoch,
+            int_to_bytes(record.public_key[0], COORD_BYTES),
+            int_to_bytes(record.public_key[1], COORD_BYTES),
+            int_to_bytes(record.session_key, SESSION_KEY_BYTES))
+        self._write_count(self.count + 1)
+
+
+def parse_text_keys(text_path):
+    #test_keys.txt format, one node per line: SH;SL;0xX;0xY
+    nodes = []
+    for line in open(text_path, 'r'):
+        line = line.strip()
+        if not line:
+            continue
+        fields = line.split(';')
+        serial = serial_from_parts(fields[0], fields[1])
+        nodes.append((serial, (int(fields[2], 16), int(fields[3], 16))))
+    return nodes
+
+
+def convert(text_path, store_path):
+    nodes = parse_text_keys(text_path)
+    capacity = DEFAULT_CAPACITY
+    while len(nodes) > capacity * MAX_LOAD:
+        capacity *= 2
+    store = KeyStore.create(store_path, capacity)
+    for serial, public_key in nodes:
+        store.append(serial, public_key)
+    count = len(store)
+    store.close()
+    return count
+
+
+def main(argv):
+    if len(argv) == 4 and argv[1] == 'convert':
+        print('Converted %d node(s) into %s' % (convert(argv[2], argv[3]), argv[3]))
+    elif len(argv) == 4 and argv[1] == 'sync':
+        with KeyStore(argv[3]) as store:
+            print('Updated %d node(s) in %s' % (store.sync(argv[2]), argv[3]))
+    elif len(argv) == 4 and argv[1] == 'lookup':
+        with KeyStore(argv[2]) as store:
+            record = store.lookup(int(argv[3], 16))
+            if record is None:
+                print('Node %s not found' % argv[3])
+                return 1
+            print('X: 0x%048X' % record.public_key[0])
+            print('Y: 0x%048X' % record.public_key[1])
+            print('Session key: 0x%032X (epoch %d)' % (record.session_key, record.key_epoch))
+    elif len(argv) == 3 and argv[1] == 'list':
+        with KeyStore(argv[2]) as store:
+            for serial in store.serials():
+                print('%016X' % serial)
+    else:
+        print('usage: key_store.py convert <test_keys.txt> <store>')
+        print('       key_store.py sync <test_keys.txt> <store>')
+        print('       key_store.py lookup <store> <serial hex>')
+        print('       key_store.py list <store>')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
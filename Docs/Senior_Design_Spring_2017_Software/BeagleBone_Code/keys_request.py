@@ -5,6 +5,7 @@ import functools
 import sys
 import os
 from El_gamal import *
+import rekey_pool
 
 delete_keys = '/root/Dropbox-Uploader/dropbox_uploader.sh delete "senior_design Team Folder/IMAGES/keys.txt" '
 
@@ -12,6 +13,8 @@ wm = pyinotify.WatchManager()  # Watch Manager
 
 mask = pyinotify.IN_DELETE | pyinotify.IN_CLOSE_WRITE  | pyinotify.IN_MOVED_TO # watched events
 
+pool = rekey_pool.EphemeralPool().start()   # k, R and M of the next rekeys, computed while waiting for keys.txt
+
 
 
 
@@ -24,8 +27,11 @@ def user_request2():
         print("Rewriting Keys")
         
         Public_key = get_public_key()
-        var =setup_and_rekey(Public_key,N)
+        var =setup_and_rekey(Public_key,N,pool)
         print(var[2])
+        print(pool.metrics())
+        save_session_key(None, var[2])
+        send_rekey(var[0], var[1])
 
         
        
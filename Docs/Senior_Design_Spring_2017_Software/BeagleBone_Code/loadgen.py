@@ -0,0 +1,365 @@
+#Load generator for the coordinator: emulates N end devices on the coordinator's serial
+#line so receiver changes (receive.py, gateway.py) can be benchmarked without a field
+#deployment.
+#
+#Every emulated node speaks the firmware protocol:
+#   - at boot the SH / SL address as ASCII hex, like init_XBEE()
+#   - images as an IMAGE frame (sequence number, length) and the 0x10 image header with
+#     the JPEG, like flash_log.c; the image counts as delivered when the coordinator
+#     answers with IMAGE_ACK
+#   - three "OK"s after a '3' rekey frame, like apply_session_key()
+#
+#The coordinator XBee delivers RF packets of all nodes on one UART. The generator does
+#the same: node streams are cut into packets of --chunk bytes (0 = whole messages) and
+#sent round-robin, paced to --baud. --loss drops packets, the damaged image is never
+#acknowledged and counts as a drop. Triggers are random per node (--rate images per
+#minute), --seed makes a run repeatable.
+#
+#Latency is end to end: from the trigger (image ready on the node) to the IMAGE_ACK,
+#queueing behind other nodes on the line included. Sequence numbers carry the node
+#index in the top byte, so a broadcast ACK identifies its node.
+#
+#Transports:
+#   --pty              a pty pair, the receiver opens the printed path within --wait s (default)
+#   --connect H:P      TCP to e.g. socat tcp-listen:P,reuseaddr /dev/ttyO1,raw,b115200
+#
+#Usage:
+#   python loadgen.py --nodes 8 --rate 2 --duration 120 --images IMAGES --baud 115200
+#   python gateway.py --port /dev/pts/N            (in a second shell, path from above)
+#
+#Works with Python 2.7 (BeagleBone) and Python 3.
+
+import binascii
+import glob
+import heapq
+import os
+import random
+import socket
+import struct
+import sys
+import threading
+import time
+
+import node_protocol
+
+SH = '0013A200'             #serial high of the emulated modules, the node sends 6 digits
+SL_BASE = 0x40E50000        #serial low of node i is SL_BASE + i, also its node ID
+REKEY_FRAME_LEN = 1 + 4 * 24    #'3' + R.x + R.y + C.x + C.y
+OK_GAP = 1.25               #s between the OKs of apply_session_key(), GUARD_MS
+RF_PAYLOAD = 84             #bytes of one ZigBee packet without fragmentation
+PACE_BYTES = 64             #bytes per write, a whole message is paced to --baud as well
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(round(p / 100.0 * (len(values) - 1))))]
+
+
+def synthetic_jpeg(size, rng):
+    #SOI, random bytes without markers, EOI: enough for a receiver that checks the CRC
+    body = bytearray(rng.randint(0, 0xFE) for _ in range(max(size - 4, 0)))
+    return bytes(bytearray([0xFF, 0xD8]) + body + bytearray([0xFF, 0xD9]))
+
+
+def image_message(node_id, seq, jpeg, ms):
+    #IMAGE frame, image header and JPEG as the node's flash log sends them
+    header = node_protocol.IMAGE_HEADER.pack(node_protocol.IMAGE_MARKER, 1, node_id, ms & 0xFFFFFFFF,
+                                             4, 12, len(jpeg), binascii.crc32(jpeg) & 0xFFFFFFFF)
+    header += struct.pack('>H', node_protocol.crc16(header))
+    return node_protocol.build_frame(node_protocol.IMAGE, struct.pack('>II', seq, len(jpeg))) + header + jpeg
+
+
+class Node(object):
+    def __init__(self, index):
+        self.index = index
+        self.node_id = SL_BASE + index
+        self.seq = 0
+        self.queue = []             #messages not yet on the line, bytes
+        self.outstanding = {}       #seq -> (trigger time, bytes)
+        self.latencies = []
+        self.sent = 0
+        self.acked = 0
+        self.acked_bytes = 0
+        self.dropped = 0
+
+    def boot_message(self):
+        return (SH[2:] + '%08X' % self.node_id).encode('ascii')
+
+    def next_seq(self):
+        self.seq = (self.seq + 1) & 0xFFFFFF
+        return self.index << 24 | self.seq
+
+
+class Line(object):
+    #The coordinator UART: a pty master or a TCP socket
+    def __init__(self, connect=None):
+        self.sock = None
+        if connect:
+            host, port = connect.rsplit(':', 1)
+            self.sock = socket.create_connection((host, int(port)))
+            self.name = connect
+        else:
+            import pty
+            import tty
+            self.master, self.slave = pty.openpty()
+            tty.setraw(self.slave)          #no echo, no line discipline, like the UART
+            self.name = os.ttyname(self.slave)
+
+    def write(self, data):
+        if self.sock:
+            self.sock.sendall(data)
+        else:
+            os.write(self.master, data)
+
+    def read(self):
+        if self.sock:
+            return self.sock.recv(4096)
+        return os.read(self.master, 4096)
+
+
+class LoadGenerator(object):
+    def __init__(self, line, nodes, options):
+        self.line = line
+        self.nodes = [Node(i) for i in range(nodes)]
+        self.opt = options
+        self.rng = random.Random(options['seed'])             #samples and triggers
+        self.loss_rng = random.Random(options['seed'] + 1)    #packet loss, its own stream
+        self.lock = threading.Condition()
+        self.samples = self.load_samples()
+        self.line_bytes = 0
+        self.lost_packets = 0
+        self.unknown_acks = 0
+        self.rekeys = 0
+        self.running = True
+
+    def load_samples(self):
+        paths = sorted(glob.glob(os.path.join(self.opt['images'], '*.jpg'))) if self.opt['images'] else []
+        samples = []
+        for path in paths:
+            with open(path, 'rb') as f:
+                samples.append(f.read())
+        return samples or [synthetic_jpeg(self.opt['size'], self.rng)]
+
+    # ------------------------------------------------------------ sending
+
+    def packets(self):
+        #Next packet of the round-robin over the nodes with queued bytes, None if idle
+        chunk = self.opt['chunk']
+        with self.lock:
+            for _ in range(len(self.nodes)):
+                node = self.nodes[self.turn % len(self.nodes)]
+                self.turn += 1
+                if node.queue:
+                    message = node.queue[0]
+                    n = len(message) if chunk == 0 else min(chunk, len(message))
+                    node.queue[0] = message[n:]
+                    if not node.queue[0]:
+                        node.queue.pop(0)
+                    return message[:n]
+        return None
+
+    def send_loop(self):
+        #Paced writer: a byte takes 10 bit times on the line
+        self.turn = 0
+        byte_time = 10.0 / self.opt['baud']
+        next_free = time.time()
+        while self.running:
+            packet = self.packets()
+            if packet is None:
+                time.sleep(0.002)
+                next_free = max(next_free, time.time())
+                continue
+            lost = self.loss_rng.random() < self.opt['loss']
+            if lost:
+                with self.lock:
+                    self.lost_packets += 1
+            for i in range(0, len(packet), PACE_BYTES):
+                piece = packet[i:i + PACE_BYTES]
+                if not lost:
+                    self.line.write(piece)
+                next_free += len(piece) * byte_time
+                delay = next_free - time.time()
+                if delay > 0:
+                    time.sleep(delay)
+            with self.lock:
+                self.line_bytes += len(packet)
+
+    def trigger(self, node, now, start):
+        jpeg = self.samples[self.rng.randrange(len(self.samples))]
+        with self.lock:
+            seq = node.next_seq()
+            node.outstanding[seq] = (now, len(jpeg))
+            node.queue.append(image_message(node.node_id, seq, jpeg, int((now - start) * 1000)))
+            node.sent += 1
+
+    def schedule_loop(self, start):
+        #Poisson triggers per node for the duration of the run
+        rate = self.opt['rate'] / 60.0
+        events = []
+        for node in self.nodes:
+            if rate > 0:
+                heapq.heappush(events, (start + self.rng.expovariate(rate), node.index))
+        end = start + self.opt['duration']
+        while events and self.running:
+            when, index = heapq.heappop(events)
+            if when >= end:
+                break
+            delay = when - time.time()
+            if delay > 0:
+                time.sleep(delay)
+            self.trigger(self.nodes[index], time.time(), start)
+            heapq.heappush(events, (when + self.rng.expovariate(rate), index))
+
+    # ------------------------------------------------------------ receiving
+
+    def receive_loop(self):
+        #Coordinator to nodes: IMAGE_ACK frames and '3' rekey frames
+        buf = bytearray()
+        while self.running:
+            try:
+                data = self.line.read()
+            except OSError:
+                break
+            if not data:
+                break
+            buf += bytearray(data)
+            buf = self.parse(buf)
+
+    def parse(self, buf):
+        while buf:
+            if buf[0] == node_protocol.SOF:
+                if len(buf) < node_protocol.HEADER_LEN or len(buf) < node_protocol.HEADER_LEN + buf[2] + 2:
+                    return buf
+                length = buf[2]
+                frame = buf[:node_protocol.HEADER_LEN + length + 2]
+                buf = buf[len(frame):]
+                body = bytes(frame[1:-2])
+                if node_protocol.crc16(body) == (frame[-2] << 8 | frame[-1]) and frame[1] == node_protocol.IMAGE_ACK:
+                    self.ack(struct.unpack('>I', bytes(frame[3:7]))[0])
+            elif buf[0] == ord('3'):
+                if len(buf) < REKEY_FRAME_LEN:
+                    return buf
+                buf = buf[REKEY_FRAME_LEN:]
+                self.rekey()
+            else:
+                buf = buf[1:]       #'5' and other ASCII commands are not emulated
+        return buf
+
+    def ack(self, seq):
+        now = time.time()
+        with self.lock:
+            index = seq >> 24
+            node = self.nodes[index] if index < len(self.nodes) else None
+            if node is None or seq not in node.outstanding:
+                self.unknown_acks += 1      #duplicate, or an image of an earlier run
+                return
+            trigger, size = node.outstanding.pop(seq)
+            node.latencies.append(now - trigger)
+            node.acked += 1
+            node.acked_bytes += size
+            self.lock.notify_all()
+
+    def rekey(self):
+        #Every node hears the broadcast, node 0 plays the one the key was meant for
+        def answer():
+            for _ in range(3):
+                time.sleep(OK_GAP)
+                with self.lock:
+                    self.nodes[0].queue.append(b'OK')
+        with self.lock:
+            self.rekeys += 1
+        t = threading.Thread(target=answer)
+        t.daemon = True
+        t.start()
+
+    # ------------------------------------------------------------ run
+
+    def run(self):
+        for target in (self.send_loop, self.receive_loop):
+            t = threading.Thread(target=target)
+            t.daemon = True
+            t.start()
+
+        with self.lock:
+            for node in self.nodes:
+                node.queue.append(node.boot_message())
+
+        start = time.time()
+        self.schedule_loop(start)
+        sent_end = time.time()
+
+        #wait for the ACKs of the last images
+        deadline = time.time() + self.opt['ack_timeout']
+        with self.lock:
+            while any(n.outstanding or n.queue for n in self.nodes) and time.time() < deadline:
+                self.lock.wait(0.2)
+            elapsed = time.time() - start
+            for node in self.nodes:
+                node.dropped = len(node.outstanding)
+        self.running = False
+        return self.report(elapsed, sent_end - start)
+
+    def report(self, elapsed, offered_time):
+        lines = []
+        total = {'sent': 0, 'acked': 0, 'dropped': 0, 'bytes': 0}
+        latencies = []
+        lines.append('%d nodes, %.1f images/min each, %d s, %d baud, chunk %d, loss %.3f, seed %s'
+                     % (len(self.nodes), self.opt['rate'], self.opt['duration'], self.opt['baud'],
+                        self.opt['chunk'], self.opt['loss'], self.opt['seed']))
+        lines.append('node      sent acked dropped   p50_ms   p90_ms   p99_ms   max_ms')
+        for node in self.nodes:
+            ms = [1000 * l for l in node.latencies]
+            lines.append('%08X %5d %5d %7d %8.0f %8.0f %8.0f %8.0f'
+                         % (node.node_id, node.sent, node.acked, node.dropped, percentile(ms, 50),
+                            percentile(ms, 90), percentile(ms, 99), max(ms) if ms else 0))
+            total['sent'] += node.sent
+            total['acked'] += node.acked
+            total['dropped'] += node.dropped
+            total['bytes'] += node.acked_bytes
+            latencies += ms
+        lines.append('all      %5d %5d %7d %8.0f %8.0f %8.0f %8.0f'
+                     % (total['sent'], total['acked'], total['dropped'], percentile(latencies, 50),
+                        percentile(latencies, 90), percentile(latencies, 99), max(latencies) if latencies else 0))
+        capacity = self.opt['baud'] / 10.0 * elapsed
+        lines.append('throughput %.0f JPEG bytes/s, %.2f images/s, line %.0f%% busy, %d packets lost,'
+                     ' %d unknown ACKs, %d rekeys answered'
+                     % (total['bytes'] / elapsed, total['acked'] / elapsed, 100.0 * self.line_bytes / capacity,
+                        self.lost_packets, self.unknown_acks, self.rekeys))
+        return '\n'.join(lines)
+
+
+def main(argv):
+    options = {'nodes': 4, 'rate': 1.0, 'duration': 60, 'baud': node_protocol.BAUD, 'chunk': RF_PAYLOAD,
+               'loss': 0.0, 'images': None, 'size': 20000, 'seed': 1, 'ack_timeout': 30.0,
+               'wait': 10.0, 'connect': None}
+    types = {'nodes': int, 'rate': float, 'duration': int, 'baud': int, 'chunk': int, 'loss': float,
+             'size': int, 'seed': int, 'ack_timeout': float, 'wait': float}
+    args = argv[1:]
+    while args:
+        arg = args.pop(0)
+        key = arg[2:].replace('-', '_')
+        if arg == '--pty':
+            options['connect'] = None
+        elif arg.startswith('--') and key in options and args:
+            value = args.pop(0)
+            options[key] = types[key](value) if key in types else value
+        else:
+            print('usage: python loadgen.py [--nodes N] [--rate images/min] [--duration s] [--baud B]'
+                  ' [--chunk bytes] [--loss p] [--images DIR | --size bytes] [--seed S]'
+                  ' [--ack-timeout s] [--wait s] [--pty | --connect host:port]')
+            return 1
+
+    line = Line(options['connect'])
+    if options['connect'] is None:
+        print('coordinator line: %s, starting in %.0f s' % (line.name, options['wait']))
+        sys.stdout.flush()
+        time.sleep(options['wait'])     #time to start the receiver on the pty
+    generator = LoadGenerator(line, options['nodes'], options)
+    print(generator.run())
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
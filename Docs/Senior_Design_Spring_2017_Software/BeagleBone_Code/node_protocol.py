@@ -0,0 +1,227 @@
+#Coordinator side of the binary node command protocol (MSP432_code/node_cmd.h).
+#
+#Frame, both directions:
+#   SOF | opcode | length | params (length bytes) | CRC-16 high | CRC-16 low
+#CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF) over opcode, length and params.
+#The node answers with opcode | REPLY, a status byte and the data of the command.
+#Images queued in the node's flash are announced with an IMAGE frame (sequence number,
+#length) before the 0x10 image bytes and stay queued until IMAGE_ACK carries that number.
+#
+#Works with Python 2.7 (BeagleBone) and Python 3.
+#
+#Usage:
+#   python node_protocol.py status
+#   python node_protocol.py capture [count]
+#   python node_protocol.py resolution 320x240
+#   python node_protocol.py quality 20
+#   python node_protocol.py budget 20000     (JPEG bytes per image, 0 = fixed quality)
+#   python node_protocol.py burst 3
+#   python node_protocol.py engine fpga
+#   python node_protocol.py zonebench        (JPEG bytes per PIR zone alert against the full frame)
+#   python node_protocol.py boot             (network join path, time to join and to the first image)
+#   python node_protocol.py energy [reset]   (energy per phase, mJ per image and per rekey, MSP432_code/energy.h)
+
+import binascii
+import struct
+import sys
+
+#Serial rate of the coordinator XBee. The nodes negotiate their own side at boot; the
+#coordinator module is set once to the same rate (ATBD7, ATWR) so it does not throttle images.
+BAUD = 115200
+
+SOF = 0xA5
+REPLY = 0x80
+HEADER_LEN = 3
+MAX_PARAMS = 64
+
+STATUS = 0x01
+CAPTURE = 0x02
+SET_RESOLUTION = 0x03
+SET_QUALITY = 0x04
+SET_BURST = 0x05
+SET_ENGINE = 0x06
+IMAGE_ACK = 0x07
+SET_BUDGET = 0x08
+ZONE_BENCH = 0x09
+BOOT_STATS = 0x0A
+ENERGY = 0x0B                       #the report text follows the answer frame
+
+IMAGE = 0x40                        #sent by the node, not an answer
+
+#Header in front of every image (MSP432_code/image_header.h), the JPEG follows unchanged
+IMAGE_MARKER = 0x10
+IMAGE_HEADER_LEN = 22
+IMAGE_HEADER = struct.Struct('>BBIIBBII')   #marker, version, node ID, time, resolution, quality, length, CRC-32
+
+STATUS_NAMES = ['OK', 'BAD_CRC', 'BAD_OPCODE', 'BAD_LENGTH', 'BAD_PARAM', 'BUSY', 'FAILED']
+
+#OV2640_RES_* order in ov2640_driver.h
+RESOLUTIONS = ['160x120', '176x144', '320x240', '352x288', '640x480',
+               '800x600', '1024x768', '1280x1024', '1600x1200']
+
+ENGINES = ['software', 'fpga']      #REKEY_ENGINE_SOFTWARE, REKEY_ENGINE_FPGA
+
+JOIN_PATHS = ['scan', 'cached', 'kept']     #XBEE_JOIN_* in xbee_driver.h
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in bytearray(data):
+        crc ^= byte << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+
+def build_frame(opcode, params=b''):
+    params = bytes(bytearray(params))
+    if len(params) > MAX_PARAMS:
+        raise ValueError('at most %d parameter bytes' % MAX_PARAMS)
+    body = bytes(bytearray([opcode, len(params)])) + params
+    return bytes(bytearray([SOF])) + body + struct.pack('>H', crc16(body))
+
+
+def read_frame(ser, sof_read=False):
+    #Read one frame from the serial port, returns (opcode, payload), (None, None) on a bad
+    #CRC (e.g. an 0xA5 inside image data) and None on a read timeout.
+    #sof_read: the caller already consumed the SOF byte while scanning the stream
+    while not sof_read:
+        byte = bytearray(ser.read(1))
+        if not byte:
+            return None
+        sof_read = byte[0] == SOF
+    header = bytearray(ser.read(2))
+    if len(header) < 2:
+        return None
+    payload = bytearray(ser.read(header[1]))
+    crc = bytearray(ser.read(2))
+    if len(payload) < header[1] or len(crc) < 2:
+        return None
+    if crc16(bytes(header + payload)) != (crc[0] << 8 | crc[1]):
+        return None, None
+    return header[0], payload
+
+
+def describe(opcode, payload):
+    #Human readable form of an answer frame
+    op = opcode & ~REPLY
+    status = payload[0] if payload else len(STATUS_NAMES)
+    text = STATUS_NAMES[status] if status < len(STATUS_NAMES) else 'status %d' % status
+    data = payload[1:]
+    if op == STATUS and status == 0 and len(data) >= 5:
+        res = RESOLUTIONS[data[1]] if data[1] < len(RESOLUTIONS) else str(data[1])
+        engine = ENGINES[data[4]] if data[4] < len(ENGINES) else str(data[4])
+        text += ' version %d resolution %s quality %d burst %d engine %s' % (data[0], res, data[2], data[3], engine)
+        if len(data) >= 6:
+            text += ' queued %d' % data[5]
+        if len(data) >= 8:
+            text += ' budget %d' % (data[6] << 8 | data[7])
+    elif op == CAPTURE and data:
+        text += ' images %d' % data[0]
+    elif op == ZONE_BENCH and len(data) >= 3:
+        sizes = [data[i] << 16 | data[i + 1] << 8 | data[i + 2] for i in range(0, len(data) - 2, 3)]
+        text += ' full frame %d bytes' % sizes[0]
+        for zone, size in enumerate(sizes[1:]):
+            text += ', zone %d %d bytes (%d%%)' % (zone, size, 100 * size // max(sizes[0], 1))
+    elif op == BOOT_STATS and len(data) >= 9:
+        path = JOIN_PATHS[data[0]] if data[0] < len(JOIN_PATHS) else str(data[0])
+        join_ms, image_ms = struct.unpack('>II', bytes(data[1:9]))
+        text += ' join %s after %d ms' % (path, join_ms)
+        text += ', first image after %d ms' % image_ms if image_ms else ', no image yet'
+    elif op == ENERGY and len(data) >= 2:
+        text += ' report %d bytes' % (data[0] << 8 | data[1])
+    return 'opcode 0x%02X: %s' % (op, text)
+
+
+def image_info(payload):
+    #(sequence number, length) of an IMAGE frame
+    return struct.unpack('>II', bytes(payload[:8]))
+
+
+def parse_image_header(header):
+    #Fields of an image header as a dict, None if its CRC-16 does not match
+    header = bytearray(header)
+    if len(header) < IMAGE_HEADER_LEN or header[0] != IMAGE_MARKER:
+        return None
+    if crc16(bytes(header[:20])) != (header[20] << 8 | header[21]):
+        return None
+    marker, version, node, ms, res, quality, length, crc = IMAGE_HEADER.unpack(bytes(header[:20]))
+    return {'version': version, 'node': node, 'time_ms': ms, 'resolution': res,
+            'quality': quality, 'length': length, 'crc32': crc}
+
+
+def read_payload(ser, length):
+    #Read length bytes however long they take. A read returns what came within the port
+    #timeout, so reading goes on while bytes arrive and ends after a timeout without any
+    data = bytearray()
+    while len(data) < length:
+        chunk = bytearray(ser.read(length - len(data)))
+        if not chunk:
+            break
+        data += chunk
+    return bytes(data)
+
+
+def image_ok(info, payload):
+    #True if the JPEG bytes match the length and CRC-32 of their header
+    return len(payload) == info['length'] and binascii.crc32(bytes(payload)) & 0xFFFFFFFF == info['crc32']
+
+
+def ack_frame(seq):
+    #Acknowledge of a queued image, the node drops it from its flash
+    return build_frame(IMAGE_ACK, struct.pack('>I', seq))
+
+
+def command_frame(name, value=None):
+    #Frame for a command given by name, value as typed by the operator
+    if name == 'status':
+        return build_frame(STATUS)
+    if name == 'capture':
+        return build_frame(CAPTURE, [int(value)] if value is not None else [])
+    if name == 'resolution':
+        return build_frame(SET_RESOLUTION, [RESOLUTIONS.index(value)])
+    if name == 'quality':
+        return build_frame(SET_QUALITY, [int(value)])
+    if name == 'budget':
+        return build_frame(SET_BUDGET, struct.pack('>H', int(value)))
+    if name == 'zonebench':
+        return build_frame(ZONE_BENCH)
+    if name == 'boot':
+        return build_frame(BOOT_STATS)
+    if name == 'energy':
+        return build_frame(ENERGY, [1] if value == 'reset' else [])
+    if name == 'burst':
+        return build_frame(SET_BURST, [int(value)])
+    if name == 'engine':
+        return build_frame(SET_ENGINE, [ENGINES.index(value)])
+    raise ValueError('unknown command ' + name)
+
+
+def main(argv):
+    import serial
+
+    if len(argv) < 2:
+        print('usage: python node_protocol.py status | capture [count] | resolution WxH | quality 1-63'
+              ' | budget bytes | burst count | engine software|fpga | zonebench | boot | energy [reset]')
+        return 1
+    frame = command_frame(argv[1], argv[2] if len(argv) > 2 else None)
+    ser = serial.Serial(port="/dev/ttyO1", baudrate=BAUD, timeout=30)
+    ser.write(frame)
+    while True:
+        reply = read_frame(ser)
+        if reply is None:
+            print('no answer')
+            return 1
+        if reply[0] is not None and reply[0] & REPLY:
+            print(describe(reply[0], reply[1]))
+            if reply[0] & ~REPLY == ENERGY and len(reply[1]) >= 3 and reply[1][0] == 0:
+                text = ser.read(reply[1][1] << 8 | reply[1][2])
+                sys.stdout.write(text.decode('ascii', 'replace'))
+            return 0 if reply[1] and reply[1][0] == 0 else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
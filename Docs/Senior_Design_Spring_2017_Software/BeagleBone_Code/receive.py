@@ -5,13 +5,14 @@ import binascii
 import serial
 import datetime
 import time
+import node_protocol
  
 UART.setup("UART1")
 
 num = 1
 
  
-ser = serial.Serial(port = "/dev/ttyO1", baudrate=9600)
+ser = serial.Serial(port = "/dev/ttyO1", baudrate=node_protocol.BAUD, timeout=5)     #5 s without a byte ends a read instead of blocking
 ser.close()
 ser.open()
 if ser.isOpen():
@@ -20,26 +21,30 @@ if ser.isOpen():
 
 finished = 0;
 
+image_seq = None    #sequence number of the queued image announced last, acknowledged once it is read
+
 
 
 def read_image():
-    current_byte = 0;
-    last_byte = 0;
+    #Header (marker already read), then the JPEG, read until all of it is in. Returns True if the image was saved
+    header = bytearray([node_protocol.IMAGE_MARKER]) + bytearray(ser.read(node_protocol.IMAGE_HEADER_LEN - 1))
+    info = node_protocol.parse_image_header(header)
+    if info is None:
+        print ("Bad image header")
+        return False
+
+    payload = node_protocol.read_payload(ser, info['length'])
+    if not node_protocol.image_ok(info, payload):
+        print ("Image %d of %d bytes, CRC error" % (len(payload), info['length']))
+        return False
+
     print('Timestamp: {:%Y+-%b-%d %H:%M:%S}'.format(datetime.datetime.now()))
     get_time = ('{:%Y-%b-%d %H:%M:%S}'.format(datetime.datetime.now()))
-    f = open('IMAGES/'+ get_time +  '.jpg' , 'w')
-    i = 0
-
-    while(1):
-        last_byte = current_byte
-        current_byte = ser.read().encode('hex')
-            
-        if( last_byte == "ff" and current_byte == "d9"):
-            print ("Image Received")
-            f.close()
-            return
-        
-        f.write(binascii.unhexlify(current_byte))
+    f = open('IMAGES/'+ get_time +  '.jpg' , 'wb')
+    f.write(payload)
+    f.close()
+    print ("Image Received from node %08X, %d bytes" % (info['node'], info['length']))
+    return True
         
         
 
@@ -48,12 +53,20 @@ def read_image():
 while(1):
     
 
-    if(ser.read().encode('hex') == "10"):
+    byte = ser.read().encode('hex')
+    if(byte == "10"):
         print ("Reading Image")
-        read_image()
+        if read_image() and image_seq is not None:
+            ser.write(node_protocol.ack_frame(image_seq))     #a damaged image is not acknowledged, the node sends it again
+        image_seq = None
      
         
         print ("Finished Receiving")
-  
-	
-)
\ No newline at end of file
+
+    elif(byte == "a5"):     #answer to a binary command (node_protocol.py)
+        reply = node_protocol.read_frame(ser, sof_read=True)
+        if reply is not None and reply[0] == node_protocol.IMAGE:
+            image_seq, length = node_protocol.image_info(reply[1])
+            print ("Queued image %d, %d bytes" % (image_seq, length))
+        elif reply is not None and reply[0] is not None:
+            print (node_protocol.describe(reply[0], reply[1]))
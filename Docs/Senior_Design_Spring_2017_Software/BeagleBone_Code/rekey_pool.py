@@ -0,0 +1,120 @@
+#Pool of precomputed ephemeral ElGamal values for the coordinator's rekeys.
+#
+#A rekey (El_gamal.setup_and_rekey) needs a fresh message key k with R = kG and a
+#message M = mG with its session key. None of these depend on the node, so a background
+#thread keeps up to `capacity` of them ready. When a keys.txt event or a gateway rekey
+#arrives only C = kY + M is left: one variable base multiplication and one addition.
+#An empty pool is not an error, the tuple is then computed on the spot and counted as a
+#miss. Every tuple is handed out once.
+#
+#metrics() gives the pool depth and how fast the worker refills it:
+#   depth, capacity         tuples ready, pool size
+#   produced, taken, misses tuples computed by the worker, handed out, computed on the spot
+#   refill_per_s            tuples per second of worker time (two fixed base multiplications each)
+#   fill_ms                 mean worker time per tuple
+#
+#Needs El_gamal.py, Python 2.7 like it.
+#
+#Usage:
+#   python rekey_pool.py [capacity]      fill a pool, then time rekeys with and without it
+
+import sys
+import threading
+import time
+
+import El_gamal
+
+DEFAULT_CAPACITY = 8
+
+
+class EphemeralPool(object):
+    def __init__(self, capacity=DEFAULT_CAPACITY):
+        self.capacity = capacity
+        self.items = []
+        self.cond = threading.Condition()
+        self.produced = 0
+        self.taken = 0
+        self.misses = 0
+        self.fill_seconds = 0.0
+        self.running = False
+
+    def start(self):
+        self.running = True
+        worker = threading.Thread(target=self.fill_loop)
+        worker.daemon = True
+        worker.start()
+        return self
+
+    def stop(self):
+        with self.cond:
+            self.running = False
+            self.cond.notify_all()
+
+    def fill_loop(self):
+        while True:
+            with self.cond:
+                while self.running and len(self.items) >= self.capacity:
+                    self.cond.wait()
+                if not self.running:
+                    return
+            start = time.time()
+            item = El_gamal.new_ephemeral()         #outside the lock, take() never waits on it
+            spent = time.time() - start
+            with self.cond:
+                self.items.append(item)
+                self.produced += 1
+                self.fill_seconds += spent
+                self.cond.notify_all()
+
+    def take(self):
+        #(k, R, M, session key) for one rekey, computed now if the pool is empty
+        with self.cond:
+            self.taken += 1
+            if self.items:
+                item = self.items.pop(0)
+                self.cond.notify_all()      #wake the worker to refill
+                return item
+            self.misses += 1
+        return El_gamal.new_ephemeral()
+
+    def wait_full(self, timeout=None):
+        deadline = None if timeout is None else time.time() + timeout
+        with self.cond:
+            while len(self.items) < self.capacity:
+                left = None if deadline is None else deadline - time.time()
+                if left is not None and left <= 0:
+                    return False
+                self.cond.wait(left)
+        return True
+
+    def metrics(self):
+        with self.cond:
+            return {'depth': len(self.items), 'capacity': self.capacity, 'produced': self.produced,
+                    'taken': self.taken, 'misses': self.misses,
+                    'refill_per_s': self.produced / self.fill_seconds if self.fill_seconds else 0.0,
+                    'fill_ms': 1000 * self.fill_seconds / self.produced if self.produced else 0.0}
+
+
+def main(argv):
+    capacity = int(argv[1]) if len(argv) > 1 else DEFAULT_CAPACITY
+    public_key = El_gamal.get_public_key()
+
+    start = time.time()
+    El_gamal.setup_and_rekey(public_key, El_gamal.N)
+    inline = time.time() - start
+
+    pool = EphemeralPool(capacity).start()
+    pool.wait_full()
+    start = time.time()
+    El_gamal.setup_and_rekey(public_key, El_gamal.N, pool)
+    pooled = time.time() - start
+    pool.stop()
+
+    print('rekey without pool %.1f ms, with pool %.1f ms' % (1000 * inline, 1000 * pooled))
+    print(' '.join('%s=%s' % (k, ('%.2f' % v) if isinstance(v, float) else v)
+                   for k, v in sorted(pool.metrics().items())))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -10,11 +10,12 @@ import serial
 import datetime
 import time
 import os
+import node_protocol
 
  
 #ser = serial.Serial(port = "/dev/ttyO1", baudrate=9600)
  
-ser = serial.Serial(port = "/dev/ttyO1", baudrate=9600)
+ser = serial.Serial(port = "/dev/ttyO1", baudrate=node_protocol.BAUD)
 ser.close()
 ser.open()
 if ser.isOpen():
@@ -53,6 +54,16 @@ def user_request():
       
     elif (command.startswith('6')):  
         print("key change request")
+
+    elif (command.startswith('7')):
+        #capture parameters from the app, e.g. "7 quality 20" or "7 resolution 320x240"
+        words = command.split()
+        print("node command " + " ".join(words[1:]))
+        try:
+            ser.write(node_protocol.command_frame(words[1], words[2] if len(words) > 2 else None))
+        except (IndexError, ValueError) as e:
+            print("bad node command: %s" % e)
+        os.remove('USER/user.txt')
         
 
        
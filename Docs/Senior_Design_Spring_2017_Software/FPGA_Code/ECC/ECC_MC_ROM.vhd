@@ -98,7 +98,7 @@ end ECC_MC_ROM;
  
 architecture behave of ECC_MC_ROM is
  
-type ECC_MC_ROMTABLE is array (0 to 116) of std_logic_vector (26 downto 0);
+type ECC_MC_ROMTABLE is array (0 to 118) of std_logic_vector (26 downto 0);
  -- internal table
 constant romdata : ECC_MC_ROMTABLE := (
 "101000001010000000000000010", --0
@@ -217,7 +217,9 @@ constant romdata : ECC_MC_ROMTABLE := (
 "101110101011000000000000010", --113
 "001101101011000000000000010", --114
 "001010010010000000000000010", --115
-"001110010011000000000000010"  --116
+"001110010011000000000000010", --116
+"101100110011000000000000101", --117 NEG_P: T3 = y - y
+"001110110011000000000000101"  --118 NEG_P: y = T3 - y
 );
  
 begin
@@ -227,4 +229,4 @@ begin
 	dout <= romdata(to_integer(unsigned(addr)));
 end process;
  
-end behave;
\ No newline at end of file
+end behave;
\ No newline at end of file
@@ -2,6 +2,17 @@
 --! @file       ECC_Mult_LW_Scheduler.vhd
 --! @brief      ECC Multiplier Scheduler for LW
 --!
+--!             G_NAF = false: Montgomery ladder, one point addition and one
+--!             doubling per scalar bit whatever the bit value.
+--!             G_NAF = true : binary NAF, double always / add sometimes
+--!             (IEEE P1363 A.10.3). h = 3k is computed word by word after k is
+--!             loaded and stored in the upper half of the k slot, the digit of
+--!             bit i is h_i - k_i. A negative digit adds -P by negating Py
+--!             before and after the addition (NEG_P). About 1/3 of the bits
+--!             need an addition, but the operation sequence depends on k, see
+--!             Testbench/ecc_sweep.py. Needs field_words <= 2^(G_N-1)
+--!             (P-192, P-224 and P-256 at every G_W).
+--!
 --! @author     Ahmed Ferozpuri
 --! @copyright  Copyright (c) 2016 Cryptographic Engineering Research Group
 --!             ECE Department, George Mason University Fairfax, VA, U.S.A.
@@ -15,7 +26,8 @@ use ieee.numeric_std.all;
 entity ECC_Mult_LW_Scheduler is
     generic (
         G_N                 : integer := 3;
-        G_W                 : integer := 64
+        G_W                 : integer := 64;
+        G_NAF               : boolean := false
     );
     port (
         --! Global
@@ -88,6 +100,8 @@ architecture structure of ECC_Mult_LW_Scheduler is
    constant PTOA_END_ADDR      : std_logic_vector := "1110010"; --114
    constant MTON_START_ADDR    : std_logic_vector := "1110011"; --115
    constant MTON_END_ADDR      : std_logic_vector := "1110100"; --116
+   constant NEG_P_START_ADDR   : std_logic_vector := "1110101"; --117
+   constant NEG_P_END_ADDR     : std_logic_vector := "1110110"; --118
    type EXEC_EPM_STATE IS (IDLE,
                      LOAD_FIELD_SIZE, FIELD_DATA_LOCK, LOAD_FIELD_DATA_1, LOAD_FIELD_DATA_2, FB_GEN_2, GEN_2, START_M_2, WAIT_M_2,
                      CURVE_DATA_LOCK, LOAD_CURVE_DATA,
@@ -101,7 +115,10 @@ architecture structure of ECC_Mult_LW_Scheduler is
                      WAIT_1_R2, WML_INIT_T2, L_INIT_T2, INIT_T2,
                      WML_S3, L_WML_S3, L_S3, START_S3_S, S3_S, START_S3_M, S3_M, START_S3_FINAL, S3_FINAL, FB_GEN_1_MTON, GEN_1_MTON,
                      START_S4, S4,
-                     WML_OUTPUT_X, W_OUTPUT_X, OUTPUT_X, W_OUTPUT_Y, OUTPUT_Y);
+                     WML_OUTPUT_X, W_OUTPUT_X, OUTPUT_X, W_OUTPUT_Y, OUTPUT_Y,
+                     NAF_H_LOCK, L_NAF_H, NAF_H,
+                     NAF_TOP, NAF_WML, NAF_L_K, NAF_L_H, NAF_S, NAF_NEXT,
+                     START_NAF_D, NAF_D, START_NAF_N1, NAF_N1, START_NAF_A, NAF_A, START_NAF_N2, NAF_N2);
    
    signal mc_state, mc_nstate                                : EXEC_EPM_STATE;
    signal PC_en, PC_ld, PC_rst                               : std_logic;
@@ -131,6 +148,14 @@ architecture structure of ECC_Mult_LW_Scheduler is
    signal shift_reg_msb_1, shift_reg_msb_2                   : std_logic;
    signal init_curve_flag_r, init_curve_flag_s               : std_logic;
    signal field_count_next_sel                               : std_logic_vector(1 downto 0);
+   --NAF recoding, h = 3k
+   signal naf_shift                                          : std_logic_vector(G_W         -1 downto 0);
+   signal naf_h_sum                                          : std_logic_vector(G_W+2       -1 downto 0);
+   signal naf_carry, naf_h_top                               : std_logic_vector(1 downto 0);
+   signal naf_kmsb, naf_top                                  : std_logic;
+   signal naf_h_rst, naf_h_en, naf_ld, naf_top_ld, naf_top_r : std_logic;
+   signal naf_idx_hi, naf_shift_msb                          : std_logic;
+   signal idx_a_base, idx_dest_base                          : std_logic_vector(G_N+1        -1 downto 0);
 begin
 
 mc_rom:
@@ -149,6 +174,8 @@ begin
         shift_cnt    <= (others => '0');
       field_count    <= (others => '0');
       field_size_reg <= (others => '0');
+      naf_shift      <= (others => '0');
+      naf_top        <= '0';
     elsif rising_edge(clk) then
         mc_state     <= mc_nstate;
         
@@ -193,6 +220,32 @@ begin
       if (field_size_reg_l = '1') then
          field_size_reg <= di_data(2 downto 0);
       end if;
+
+      --h = k + 2k, one word per NAF_H cycle, carry into the next word
+      if (naf_h_rst = '1') then
+         naf_carry <= (others => '0');
+         naf_kmsb  <= '0';
+      elsif (naf_h_en = '1') then
+         naf_carry <= naf_h_sum(G_W+1 downto G_W);
+         naf_kmsb  <= data_a(G_W-1);
+         naf_h_top <= std_logic_vector(unsigned(naf_h_sum(G_W+1 downto G_W)) + unsigned'('0' & data_a(G_W-1)));
+      end if;
+
+      --h is scanned next to k, the bits of h above the top word of k first
+      if (naf_top_ld = '1') then
+         shift_reg <= (others => '0');
+         naf_shift <= (others => '0');
+         naf_shift(1 downto 0) <= naf_h_top;
+         naf_top   <= '1';
+      elsif (naf_ld = '1') then
+         naf_shift <= data_a;
+      elsif (s_en = '1') then
+         naf_shift <= naf_shift(G_W         -2 downto 0) & '0';
+      end if;
+
+      if (naf_top_r = '1') then
+         naf_top <= '0';
+      end if;
     end if;
 end process;
 
@@ -225,6 +278,7 @@ data_dest <= (0 => '1', others => '0')           when "001",
              (di_data)                           when "011",
              (data_a)                            when "100",
 				 (2 => '1', 0 => '1', others => '0') when "101",
+             naf_h_sum(G_W-1 downto 0)           when "111",
              (others => '0')                     when others;
 
 with op_dest_sel select
@@ -258,8 +312,16 @@ op_a <= "10010" when "0001", --k
         "01100" when "1000", --a
         (others => '0') when others;
 
-idx_a    <= field_count when idx_a_sel = '1' else PC(G_N+1        -1 downto 0);
-idx_dest <= PC(G_N+1        -1 downto 0);
+idx_a_base    <= field_count when idx_a_sel = '1' else PC(G_N+1        -1 downto 0);
+idx_dest_base <= PC(G_N+1        -1 downto 0);
+
+--h lives in the upper half of the k slot
+idx_a    <= idx_a_base(G_N) & '1' & idx_a_base(G_N-2 downto 0) when naf_idx_hi = '1' else idx_a_base;
+idx_dest <= idx_dest_base(G_N) & '1' & idx_dest_base(G_N-2 downto 0) when naf_idx_hi = '1' else idx_dest_base;
+
+naf_h_sum <= std_logic_vector(unsigned("00" & data_a)
+                              + unsigned("00" & data_a(G_W-2 downto 0) & naf_kmsb)
+                              + unsigned(naf_carry));
 
 --instruction set decoding
 instr_op          <= mc_rom_out(2 downto 0);
@@ -304,6 +366,7 @@ with PC_next_sel select
                (EPD_2Q_START_ADDR)        when "1001",
                (EPA_QP_START_ADDR)        when "1010",
 					(EPS_CQ_START_ADDR)        when "1011",
+               (NEG_P_START_ADDR)         when "1100",
                (others => '0')            when others;
             
 with field_count_next_sel select
@@ -318,8 +381,9 @@ pc_equals_field_words <= '1' when PC(field_words_l'length-1 downto 0) = field_wo
 s_empty <= '1' when shift_cnt = gw_m1 else '0';
 shift_reg_msb_1 <= '1' when shift_reg(G_W-1) = '1' else '0';
 shift_reg_msb_2 <= '1' when shift_reg(G_W-2) = '0' else '0';
+naf_shift_msb   <= naf_shift(G_W-1);
 
-mc_p_comb: process(mc_state, init_field, init_curve, start, di_valid, lock_ack, op_done, mmm_done, s_empty, pc_equals_field_words, pc_equals_field_words_m_1, field_count_zero, do_ready, first_one, init_curve_flag, shift_reg_msb_1, PC)
+mc_p_comb: process(mc_state, init_field, init_curve, start, di_valid, lock_ack, op_done, mmm_done, s_empty, pc_equals_field_words, pc_equals_field_words_m_1, field_count_zero, do_ready, first_one, init_curve_flag, shift_reg_msb_1, PC, elgamal_calc, naf_shift_msb, naf_top)
 begin
    mc_nstate            <= mc_state;
    busy                 <= '1';
@@ -349,6 +413,12 @@ begin
    op_a_sel             <= (others => '0');
    PC_next_sel          <= (others => '0');
    field_count_next_sel <= (others => '0');
+   naf_h_rst            <= '0';
+   naf_h_en             <= '0';
+   naf_ld               <= '0';
+   naf_top_ld           <= '0';
+   naf_top_r            <= '0';
+   naf_idx_hi           <= '0';
    
     case mc_state is
     when IDLE =>
@@ -509,7 +579,11 @@ begin
             if (pc_equals_field_words_m_1 = '1') then
             PC_rst <= '1';
             lock_release <= '1';
-            mc_nstate <= FB_GEN_1_NTOM;
+            if (G_NAF) then
+               mc_nstate <= NAF_H_LOCK;
+            else
+               mc_nstate <= FB_GEN_1_NTOM;
+            end if;
             end if;
         end if;
 
@@ -532,7 +606,37 @@ begin
       if (pc_equals_field_words_m_1 = '1') then
             PC_rst <= '1';
             lock_release <= '1';
-            mc_nstate <= FB_GEN_1_NTOM;
+            if (G_NAF) then
+               mc_nstate <= NAF_H_LOCK;
+            else
+               mc_nstate <= FB_GEN_1_NTOM;
+            end if;
+      end if;
+
+   when NAF_H_LOCK =>
+      lock_req <= '1';
+      if (lock_ack = '1') then
+         PC_rst <= '1';
+         naf_h_rst <= '1';
+         mc_nstate <= L_NAF_H;
+      end if;
+   when L_NAF_H => --k
+      op_a_sel <= "0001";
+      mc_nstate <= NAF_H;
+   when NAF_H => --h = 3k
+      op_dest_sel <= "00110";
+      data_dest_sel <= "111";
+      naf_idx_hi <= '1';
+      naf_h_en <= '1';
+      idx_wr <= '1';
+      PC_en <= '1';
+
+      if (pc_equals_field_words_m_1 = '1') then
+         PC_rst <= '1';
+         lock_release <= '1';
+         mc_nstate <= FB_GEN_1_NTOM;
+      else
+         mc_nstate <= L_NAF_H;
       end if;
 
    when FB_GEN_1_NTOM =>
@@ -700,9 +804,13 @@ begin
          field_count_l <= '1';
          field_count_next_sel <= "11";
          lock_release <= '1';
+         if (G_NAF) then
+            mc_nstate <= NAF_TOP; --P stays G, Q = G is the leading digit
+         else
        PC_ld <= '1';
          PC_next_sel <= "1000";
          mc_nstate <= L_INIT_P;
+         end if;
 
 
          else
@@ -876,6 +984,133 @@ begin
             PC_en <= '1';
          end if;
         end if;     
+   when NAF_TOP =>
+      naf_top_ld <= '1';
+      s_rst <= '1';
+      mc_nstate <= NAF_S;
+   when NAF_WML =>
+      lock_req <= '1';
+      op_a_sel <= "0001";
+      idx_a_sel <= '1';
+      if (lock_ack = '1') then
+         mc_nstate <= NAF_L_K;
+      end if;
+   when NAF_L_K =>
+      s_ld <= '1';
+      op_a_sel <= "0001";
+      idx_a_sel <= '1';
+      naf_idx_hi <= '1';
+      mc_nstate <= NAF_L_H;
+   when NAF_L_H =>
+      naf_ld <= '1';
+      lock_release <= '1';
+      mc_nstate <= NAF_S;
+   when NAF_S => --digit of bit i is h_i - k_i
+      if (naf_top = '0' and field_count_zero = '1' and s_empty = '1') then
+         --bit 0 carries no digit, Q = kP
+         s_rst <= '1';
+         first_one_r <= '1';
+         field_count_l <= '1';
+         field_count_next_sel <= "11";
+         PC_rst <= '1';
+         if (elgamal_calc = '1') then
+            mc_nstate <= ELGAMAL_DATA_LOCK;
+         else
+            mc_nstate <= WML_INIT_T2;
+         end if;
+      elsif (first_one = '0') then --filter h until first one
+         if (naf_shift_msb = '1') then
+            first_one_s <= '1';
+         end if;
+         mc_nstate <= NAF_NEXT;
+      else
+         PC_ld <= '1';
+         PC_next_sel <= "1001";
+         mc_nstate <= START_NAF_D;
+      end if;
+   when NAF_NEXT =>
+      if (s_empty = '0') then
+         s_en <= '1';
+         mc_nstate <= NAF_S;
+      else
+         s_rst <= '1';
+         if (naf_top = '1') then
+            naf_top_r <= '1';
+         else
+            field_count_en <= '1';
+         end if;
+         mc_nstate <= NAF_WML;
+      end if;
+      -- Q = 2*Q
+   when START_NAF_D =>
+      op_start <= '1';
+      mc_nstate <= NAF_D;
+   when NAF_D =>
+      if (op_done = '1') then
+         if (PC = EPD_2Q_END_ADDR) then
+            if (naf_shift_msb = '1' and shift_reg_msb_1 = '0') then
+               PC_ld <= '1';
+               PC_next_sel <= "0011";
+               mc_nstate <= START_NAF_A;
+            elsif (naf_shift_msb = '0' and shift_reg_msb_1 = '1') then
+               PC_ld <= '1';
+               PC_next_sel <= "1100";
+               mc_nstate <= START_NAF_N1;
+            else
+               mc_nstate <= NAF_NEXT;
+            end if;
+         else
+            mc_nstate <= START_NAF_D;
+            PC_en <= '1';
+         end if;
+      end if;
+      -- P = -P
+   when START_NAF_N1 =>
+      op_start <= '1';
+      mc_nstate <= NAF_N1;
+   when NAF_N1 =>
+      if (op_done = '1') then
+         if (PC = NEG_P_END_ADDR) then
+            PC_ld <= '1';
+            PC_next_sel <= "0011";
+            mc_nstate <= START_NAF_A;
+         else
+            mc_nstate <= START_NAF_N1;
+            PC_en <= '1';
+         end if;
+      end if;
+      -- Q = P+Q
+   when START_NAF_A =>
+      op_start <= '1';
+      mc_nstate <= NAF_A;
+   when NAF_A =>
+      if (op_done = '1') then
+         if (PC = EPA_PQ_END_ADDR) then
+            if (shift_reg_msb_1 = '1') then --negative digit, restore P
+               PC_ld <= '1';
+               PC_next_sel <= "1100";
+               mc_nstate <= START_NAF_N2;
+            else
+               mc_nstate <= NAF_NEXT;
+            end if;
+         else
+            mc_nstate <= START_NAF_A;
+            PC_en <= '1';
+         end if;
+      end if;
+      -- P = -P
+   when START_NAF_N2 =>
+      op_start <= '1';
+      mc_nstate <= NAF_N2;
+   when NAF_N2 =>
+      if (op_done = '1') then
+         if (PC = NEG_P_END_ADDR) then
+            mc_nstate <= NAF_NEXT;
+         else
+            mc_nstate <= START_NAF_N2;
+            PC_en <= '1';
+         end if;
+      end if;
    when FB_GEN_1_MTON =>
       lock_req <= '1';
       data_dest_sel <= "001";
@@ -17,7 +17,9 @@ entity ECC_Mult_LW_Top is
     generic (
         G_N                 : integer := 5;
         G_W                 : integer := 16;
-        G_PE                : integer := 2
+        G_PE                : integer := 2;
+        G_NAF               : boolean := false;
+        G_SPLIT             : boolean := false
     );
     port (
         --! Global
@@ -35,6 +37,8 @@ entity ECC_Mult_LW_Top is
         di_ready            : out std_logic;
         do_valid            : out std_logic;
         do_data             : out std_logic_vector(G_W          -1 downto 0);
+        --! Memory statistics (Mem_Ctrl_LW), restarted with start
+        stats               : out std_logic_vector(6*32         -1 downto 0);
         --! RAM-1
         ram1_data_a         : in  std_logic_vector(G_W          -1 downto 0);
         ram1_data_b         : in  std_logic_vector(G_W          -1 downto 0);
@@ -67,6 +71,7 @@ architecture structure of ECC_Mult_LW_Top is
     signal mas_lock_req         : std_logic;
     signal mas_lock_ack         : std_logic;
     signal mas_lock_release     : std_logic;
+    signal mas_mem_en           : std_logic;
     signal mas_idx_a            : std_logic_vector(G_N+1       -1 downto 0);
     signal mas_idx_b            : std_logic_vector(G_N+1       -1 downto 0);
     signal mas_idx_dest         : std_logic_vector(G_N+1       -1 downto 0);
@@ -110,11 +115,14 @@ architecture structure of ECC_Mult_LW_Top is
     --! Memory Controller
     signal data_a               : std_logic_vector(G_W         -1 downto 0);
     signal data_b               : std_logic_vector(G_W         -1 downto 0);
+    signal mas_data_a           : std_logic_vector(G_W         -1 downto 0);
+    signal mas_data_b           : std_logic_vector(G_W         -1 downto 0);
 begin
     u_mas: entity work.MAS_LW
     generic map(
         G_N                         => G_N                  ,
-        G_W                         => G_W
+        G_W                         => G_W                  ,
+        G_SPLIT                     => G_SPLIT
     )
     port map (
         --! Global
@@ -138,6 +146,7 @@ begin
         lock_ack                    => mas_lock_ack         ,
         lock_req                    => mas_lock_req         ,
         lock_release                => mas_lock_release     ,
+        mem_en                      => mas_mem_en           ,
         op_a                        => mas_op_a             ,
         op_b                        => mas_op_b             ,
         op_dest                     => mas_op_dest          ,
@@ -145,8 +154,8 @@ begin
         idx_b                       => mas_idx_b            ,
         idx_dest                    => mas_idx_dest         ,
         idx_wr                      => mas_idx_wr           ,
-        data_a                      => data_a               ,
-        data_b                      => data_b               ,
+        data_a                      => mas_data_a           ,
+        data_b                      => mas_data_b           ,
         data_dest                   => mas_data_dest
     );
 
@@ -191,7 +200,8 @@ begin
     u_mc: entity work.ECC_Mult_LW_Scheduler
     generic map (
         G_N                         => G_N                  ,
-        G_W                         => G_W
+        G_W                         => G_W                  ,
+        G_NAF                       => G_NAF
     )
     port map (
         --! Global
@@ -244,7 +254,8 @@ begin
     u_memctrl: entity work.Mem_Ctrl_LW
     generic map (
         G_N                         => G_N                  ,
-        G_W                         => G_W
+        G_W                         => G_W                  ,
+        G_SPLIT                     => G_SPLIT
     )
     port map (
         --! Global
@@ -254,6 +265,7 @@ begin
         mas_lock_ack                => mas_lock_ack         ,
         mas_lock_req                => mas_lock_req         ,
         mas_lock_release            => mas_lock_release     ,
+        mas_mem_en                  => mas_mem_en           ,
         mas_op_a                    => mas_op_a             ,
         mas_op_b                    => mas_op_b             ,
         mas_op_dest                 => mas_op_dest          ,
@@ -291,6 +303,11 @@ begin
         --! Memory data
         data_a                      => data_a               ,
         data_b                      => data_b               ,
+        mas_data_a                  => mas_data_a           ,
+        mas_data_b                  => mas_data_b           ,
+        --! Statistics
+        stat_start                  => start                ,
+        stats                       => stats                ,
         --! RAM-1
         ram1_addr_a                 => ram1_addr_a          ,
         ram1_data_a                 => ram1_data_a          ,
@@ -306,4 +323,4 @@ begin
         ram2_wr_data                => ram2_wr_data         ,
         ram2_wr_en                  => ram2_wr_en
     );
-end architecture structure;
\ No newline at end of file
+end architecture structure;
\ No newline at end of file
@@ -16,7 +16,10 @@ use ieee.numeric_std.all;
 entity ECC_Mult_Wrapper is
     generic (
         G_N                 : integer := 5;
-        G_W                 : integer := 16
+        G_W                 : integer := 16;
+        G_PE                : integer := 2;
+        G_NAF               : boolean := false;
+        G_SPLIT             : boolean := false
     );
     port (
         --! Global
@@ -33,7 +36,9 @@ entity ECC_Mult_Wrapper is
         busy                : out std_logic;
         di_ready            : out std_logic;
         do_valid            : out std_logic;
-        do_data             : out std_logic_vector(G_W           -1 downto 0)
+        do_data             : out std_logic_vector(G_W           -1 downto 0);
+        --! Memory controller cycle counters, see Mem_Ctrl_LW
+        stats               : out std_logic_vector(6*32          -1 downto 0)
     );
 end ECC_Mult_Wrapper;
 
@@ -144,7 +149,10 @@ begin
     entity work.ECC_Mult_LW_Top
         generic map (
             G_N             => G_N          ,
-            G_W             => G_W
+            G_W             => G_W          ,
+            G_PE            => G_PE         ,
+            G_NAF           => G_NAF        ,
+            G_SPLIT         => G_SPLIT
         )
         port map (
             --! Global
@@ -162,6 +170,7 @@ begin
             di_ready        => di_ready     ,
             do_valid        => do_valid     ,
             do_data         => do_data      ,
+            stats           => stats        ,
             --! RAM-1
             ram1_data_a     => ram1_data_a  ,
             ram1_data_b     => ram1_data_b  ,
@@ -2,6 +2,11 @@
 --! @file       MAS_LW.vhd
 --! @brief      Modular Adder/Subtractor module
 --!
+--!             G_SPLIT: operand-bank partitioning of Mem_Ctrl_LW. Both
+--!             operands are read through port a (op_a shows op_a, then op_b)
+--!             so port b of RAM1 stays with the multiplier, and the unit
+--!             stands still while mem_en is low.
+--!
 --! @author     Ekawat (ice) Homsirikamol
 --! @copyright  Copyright (c) 2016 Cryptographic Engineering Research Group
 --!             ECE Department, George Mason University Fairfax, VA, U.S.A.
@@ -15,7 +20,8 @@ use ieee.numeric_std.all;
 entity MAS_LW is
     generic (
         G_N                 : integer := 3;
-        G_W                 : integer := 64
+        G_W                 : integer := 64;
+        G_SPLIT             : boolean := false
     );
     port (
         --! Global
@@ -39,6 +45,7 @@ entity MAS_LW is
         lock_ack            : in  std_logic;
         lock_req            : out std_logic;
         lock_release        : out std_logic;
+        mem_en              : in  std_logic;
         op_a                : out std_logic_vector(5            -1 downto 0);
         op_b                : out std_logic_vector(5            -1 downto 0);
         op_dest             : out std_logic_vector(5            -1 downto 0);
@@ -59,6 +66,8 @@ architecture structure of MAS_LW is
     signal in_a                 : std_logic_vector(G_W          -1 downto 0);
     signal in_b                 : std_logic_vector(G_W          -1 downto 0);
     signal data_b_sel           : std_logic_vector(G_W          -1 downto 0);
+    signal reg_in_a             : std_logic_vector(G_W          -1 downto 0);
+    signal seq_wr               : std_logic;
     signal add_out              : std_logic_vector(G_W+1        -1 downto 0);
 
     signal reg_op_a             : std_logic_vector(5            -1 downto 0);
@@ -102,7 +111,7 @@ architecture structure of MAS_LW is
 
     type state_type is (
         S_WAIT_START,       S_WAIT_MEM_ACK,
-        S_ADDSUB_RD,        S_ADDSUB_WR,
+        S_ADDSUB_RD,        S_ADDSUB_RDB,   S_ADDSUB_WR,
         S_COMPARE_INIT,     S_COMPARE,      S_COMPARE_FINAL);
     signal state    : state_type;
     signal nstate   : state_type;
@@ -111,8 +120,13 @@ begin
     --! Datapath
     --! =======================================================================
     --! Internal
-    in_a <= data_a;
-    in_b <= data_b when sel_mmm = '0' else (others => '0');
+    --! G_SPLIT: operand a was read a cycle before operand b, both on port a
+    seq_wr <= '1' when G_SPLIT and state = S_ADDSUB_WR and is_reduction = '0'
+              else '0';
+    in_a <= reg_in_a when seq_wr = '1' else data_a;
+    in_b <= (others => '0') when sel_mmm = '1' else
+            data_a          when seq_wr  = '1' else
+            data_b;
 
     data_b_sel <= (not in_b) when reg_subtract = '1' else in_b;
     
@@ -151,8 +165,12 @@ begin
     --! Output
     done <= reg_done;
     busy <= reg_busy;
-    op_a <= reg_op_a when sel_operand = '1' else reg_dest;
-    op_b <= reg_op_b when sel_operand = '1' else "10000";
+    op_a <= reg_op_b when state = S_ADDSUB_RDB else
+            reg_op_a when sel_operand = '1' else
+            reg_dest;
+    op_b <= reg_op_b when sel_operand = '1'
+                      and (not G_SPLIT or state = S_WAIT_MEM_ACK) else
+            "10000";
     op_dest         <= reg_dest;
     lock_req        <= sig_lock_req;
     lock_release    <= sig_lock_release;
@@ -210,10 +228,14 @@ begin
             end if;
             if (state = S_COMPARE_INIT) then
                 a_eq_b_reg <= '1';
-            else
+            elsif (mem_en = '1') then
                 a_eq_b_reg <= a_eq_b;
             end if;
 
+            if (state = S_ADDSUB_RDB and mem_en = '1') then
+                reg_in_a <= data_a;
+            end if;
+
             if (ld_ctr = '1') then
                 ctr <= (others => '0');
             elsif (en_ctr = '1') then
@@ -234,7 +256,7 @@ begin
     p_comb:
     process(state, start, field_words, reg_op_sub,
         lock_ack, ctr, mmm_start, needs_reduce,
-        is_reduction, a_eq_b, is_mmm, ovf)
+        is_reduction, a_eq_b, is_mmm, ovf, mem_en)
     begin
         nstate              <= state;
         sig_done            <= '0';
@@ -268,16 +290,27 @@ begin
             sel_carry     <= '1';
             set_operation <= '1';
             do_subtract   <= reg_op_sub;
+            if (G_SPLIT) then
+                sel_operand <= '1';     --! operands for the hazard check
+            end if;
             if (lock_ack = '1') then
                 nstate    <= S_ADDSUB_RD;
             end if;
 
 
         when S_ADDSUB_RD =>
-            nstate      <= S_ADDSUB_WR;
+            if (G_SPLIT and is_reduction = '0') then
+                nstate  <= S_ADDSUB_RDB;
+            else
+                nstate  <= S_ADDSUB_WR;
+            end if;
             sel_operand <= not is_reduction;
 
 
+        when S_ADDSUB_RDB =>
+            nstate      <= S_ADDSUB_WR;
+
+
         when S_ADDSUB_WR =>
             if (is_reduction = '1') then
                 ram_wr   <= needs_reduce;
@@ -346,5 +379,20 @@ begin
 
             nstate    <= S_ADDSUB_RD;
         end case;
+
+        --! Held by the memory controller, try the same cycle again. The
+        --! write is dropped by the controller (mem_en depends on idx_wr)
+        if (mem_en = '0') then
+            nstate           <= state;
+            sig_done         <= '0';
+            sig_lock_release <= '0';
+            ld_ctr           <= '0';
+            en_ctr           <= '0';
+            en_carry         <= '0';
+            set_operation    <= '0';
+            set_reduce       <= '0';
+            goto_reduction   <= '0';
+            toggle_busy      <= '0';
+        end if;
     end process;
 end architecture structure;
\ No newline at end of file
@@ -103,7 +103,7 @@ architecture structure of MMM_LW is
 
     type state_type is (
         S_RSTN, S_IDLE, S_DATA_LOCK,
-        S_LOAD_X, S_LOAD_YM0, S_LOAD_YM, S_STALL, S_WAIT_MAS);
+        S_LOAD_X, S_LOAD_YM0, S_LOAD_YM, S_STALL, S_START_MAS, S_WAIT_MAS);
     signal state            : state_type;
     signal nstate           : state_type;
 begin
@@ -255,8 +255,12 @@ begin
             ld_ym   <= '1';
             en_ctr_ym <= '1';
             if (mmm_core_done = '1') then
-                sig_mas_start <= '1';
-                nstate <= S_WAIT_MAS;
+                if (mas_busy = '0') then
+                    sig_mas_start <= '1';
+                    nstate <= S_WAIT_MAS;
+                else
+                    nstate <= S_START_MAS;
+                end if;
             elsif (ym_almost_done = '1') then
                 ld_ctr_ym <= '1';
                 if (unsigned(ctr_ymb) = (G_W/G_PE)-1) then
@@ -267,6 +271,12 @@ begin
             nstate  <= S_LOAD_X;
             ld_ctr_ymb <= '1';
             en_ctr_x <= '1';
+        when S_START_MAS =>
+            --! MAS still on its half of a combined instruction (G_SPLIT)
+            if (mas_busy = '0') then
+                sig_mas_start <= '1';
+                nstate <= S_WAIT_MAS;
+            end if;
         when S_WAIT_MAS =>
            if (mas_busy = '0') then
                nstate <= S_RSTN;
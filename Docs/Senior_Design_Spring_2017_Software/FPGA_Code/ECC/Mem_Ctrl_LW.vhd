@@ -32,7 +32,27 @@
 --!              17 | 2    | 1     |   2 / M-2
 --!              18 | 2    | 2     |   k
 --!              19 | 2    | 3     |   partial of RAM2
-
+--!
+--!             G_SPLIT (operand-bank partitioning): MAS takes its own lock
+--!             next to the one of MC/MMM, so the MAS half of a combined
+--!             MMM + MAS instruction runs while the multiplier holds the
+--!             memory instead of before it. Port ownership while both run:
+--!                 RAM1 port b           : MMM (Y)
+--!                 RAM2 port b           : MAS (M, compare and reduction)
+--!                 RAM1/RAM2 port a, wr  : shared, MMM first
+--!             MAS reads both operands through port a in that mode (one
+--!             more cycle per word). On a port a or write collision MAS is
+--!             held for the cycle (mas_mem_en low) and the word it read last
+--!             is kept for it. The two locks are only shared when the
+--!             operation of one does not read or write the destination of
+--!             the other, otherwise the later request waits as before.
+--!             MC keeps the memory to itself. Not available for G_W = 64.
+--!
+--!             Statistics: per client cycles holding a lock (busy) and
+--!             cycles waiting for one or held for a port (stall), 32 bits
+--!             each, restarted on the rising edge of stat_start. stats
+--!             holds, least significant word first:
+--!                 MAS busy, MAS stall, MMM busy, MMM stall, MC busy, MC stall
 --!
 --! @author     Ekawat (ice) Homsirikamol
 --! @copyright  Copyright (c) 2016 Cryptographic Engineering Research Group
@@ -47,7 +67,8 @@ use ieee.numeric_std.all;
 entity Mem_Ctrl_LW is
     generic (
         G_N                 : integer := 3;
-        G_W                 : integer := 64
+        G_W                 : integer := 64;
+        G_SPLIT             : boolean := false
     );
     port (
         --! Global
@@ -57,6 +78,7 @@ entity Mem_Ctrl_LW is
         mas_lock_req        : in  std_logic;
         mas_lock_release    : in  std_logic;
         mas_lock_ack        : out std_logic;
+        mas_mem_en          : out std_logic;
         mas_op_a            : in  std_logic_vector(5            -1 downto 0);
         mas_op_b            : in  std_logic_vector(5            -1 downto 0);
         mas_op_dest         : in  std_logic_vector(5            -1 downto 0);
@@ -94,6 +116,11 @@ entity Mem_Ctrl_LW is
         --! Memory data
         data_a              : out std_logic_vector(G_W          -1 downto 0);
         data_b              : out std_logic_vector(G_W          -1 downto 0);
+        mas_data_a          : out std_logic_vector(G_W          -1 downto 0);
+        mas_data_b          : out std_logic_vector(G_W          -1 downto 0);
+        --! Statistics
+        stat_start          : in  std_logic;
+        stats               : out std_logic_vector(6*32         -1 downto 0);
         --! RAM-1
         ram1_data_a         : in  std_logic_vector(G_W          -1 downto 0);
         ram1_data_b         : in  std_logic_vector(G_W          -1 downto 0);
@@ -204,6 +231,62 @@ architecture structure of Mem_Ctrl_LW is
     signal reg_op_b_lsb     : std_logic;
     signal reg_idx_a_msb    : std_logic;
     signal reg_idx_b_msb    : std_logic;
+    --! Operand-bank partitioning (G_SPLIT)
+    signal reg_mas_lock     : std_logic;
+    signal split_mas_ack    : std_logic;
+    signal mmm_may_share    : std_logic;
+    signal mas_en           : std_logic;
+    signal mas_a1           : std_logic;    --! MAS uses port a of RAM1
+    signal mas_a2           : std_logic;    --! MAS uses port a of RAM2
+    signal c_a1             : std_logic;    --! lock holder uses port a of RAM1
+    signal c_a2             : std_logic;    --! lock holder uses port a of RAM2
+    signal c_b2             : std_logic;    --! lock holder uses port b of RAM2
+    signal c_idx_wr         : std_logic;
+    signal c_dest_msb       : std_logic;
+    signal mas_own_a1       : std_logic;
+    signal mas_own_a2       : std_logic;
+    signal mas_own_b2       : std_logic;
+    signal mas_wr           : std_logic;
+    signal wr_sel           : std_logic_vector(1 downto 0);
+    signal mas_hz_new       : std_logic;
+    signal mmm_hz_held      : std_logic;
+    signal mmm_hz_new       : std_logic;
+    signal reg_mas_slot_a   : std_logic_vector(5        -1 downto 0);
+    signal reg_mas_slot_b   : std_logic_vector(5        -1 downto 0);
+    signal reg_mas_slot_d   : std_logic_vector(5        -1 downto 0);
+    signal reg_mmm_slot_a   : std_logic_vector(5        -1 downto 0);
+    signal reg_mmm_slot_b   : std_logic_vector(5        -1 downto 0);
+    signal reg_mmm_slot_d   : std_logic_vector(5        -1 downto 0);
+    signal lower_addr_mas_a : std_logic_vector(G_N      -1 downto 0);
+    signal lower_addr_mas_b : std_logic_vector(G_N      -1 downto 0);
+    signal mas_ram1_addr_a  : std_logic_vector(G_N+4    -1 downto 0);
+    signal mas_ram2_addr_a  : std_logic_vector(G_N+2    -1 downto 0);
+    signal mas_ram2_addr_b  : std_logic_vector(G_N+2    -1 downto 0);
+    --! Statistics
+    signal reg_stat_start   : std_logic;
+    signal mas_hold         : std_logic;
+    signal mmm_hold         : std_logic;
+    signal mc_hold          : std_logic;
+    signal stat_mas_busy    : unsigned(32               -1 downto 0);
+    signal stat_mas_stall   : unsigned(32               -1 downto 0);
+    signal stat_mmm_busy    : unsigned(32               -1 downto 0);
+    signal stat_mmm_stall   : unsigned(32               -1 downto 0);
+    signal stat_mc_busy     : unsigned(32               -1 downto 0);
+    signal stat_mc_stall    : unsigned(32               -1 downto 0);
+
+    --! '1' when one of the two operations reads or writes the destination
+    --! of the other, they cannot share the memory then
+    function slot_hazard(
+        mas_a, mas_b, mas_d, mmm_a, mmm_b, mmm_d : std_logic_vector)
+        return std_logic is
+    begin
+        if (mmm_d = mas_a or mmm_d = mas_b or mmm_d = mas_d
+            or mas_d = mmm_a or mas_d = mmm_b)
+        then
+            return '1';
+        end if;
+        return '0';
+    end function slot_hazard;
 begin
     --! =======================================================================
     --! I/O to/from internal signals
@@ -220,6 +303,7 @@ begin
     sig_mas_idx_wr       <= mas_idx_wr                                       ;
     sig_mas_data_dest    <= mas_data_dest                                    ;
     mas_lock_ack         <= sig_mas_lock_ack                                 ;
+    mas_mem_en           <= mas_en                                           ;
     --! MMM
     sig_mmm_op_a         <= mmm_op_a                                         ;
     sig_mmm_op_b         <= mmm_op_b                                         ;
@@ -252,6 +336,7 @@ begin
     sig_ram1_data_b      <= ram1_data_b                                      ;
     ram1_addr_a          <= sig_ram1_wr_addr
                             when sig_ram1_wr_hi = '1' or sig_ram1_wr_lo = '1'
+                            else mas_ram1_addr_a when mas_own_a1 = '1'
                             else sig_ram1_addr_a                             ;
     ram1_addr_b          <= sig_ram1_addr_b                                  ;
     ram1_wr_data         <= sig_ram1_wr_data                                 ;
@@ -262,8 +347,10 @@ begin
     sig_ram2_data_b      <= ram2_data_b                                      ;
     ram2_addr_a          <= sig_ram2_wr_addr
                             when sig_ram2_wr_hi = '1' or sig_ram2_wr_lo = '1'
+                            else mas_ram2_addr_a when mas_own_a2 = '1'
                             else sig_ram2_addr_a                             ;
-    ram2_addr_b          <= sig_ram2_addr_b                                  ;
+    ram2_addr_b          <= mas_ram2_addr_b when mas_own_b2 = '1'
+                            else sig_ram2_addr_b                             ;
     ram2_wr_data         <= sig_ram2_wr_data                                 ;
     ram2_wr_en(G_W/8-1 downto G_W/8-(G_W/8)/2) <= (others => sig_ram2_wr_hi) ;
     ram2_wr_en(G_W/8-(G_W/8)/2-1 downto     0) <= (others => sig_ram2_wr_lo) ;
@@ -366,16 +453,22 @@ begin
         lower_addr_op_a <= '0' & sig_op_a(3 downto 0);
         lower_addr_op_b <= '0' & sig_op_b(3 downto 0);
         lower_addr_dest <= '0' & sig_op_dest(3 downto 0);
+        lower_addr_mas_a <= '0' & sig_mas_op_a(3 downto 0);
+        lower_addr_mas_b <= '0' & sig_mas_op_b(3 downto 0);
     end generate;
     g_addr_w32: if G_W=32 generate   --! G_N = 4
         lower_addr_op_a <= sig_op_a(3 downto 0);
         lower_addr_op_b <= sig_op_b(3 downto 0);
         lower_addr_dest <= sig_op_dest(3 downto 0);
+        lower_addr_mas_a <= sig_mas_op_a(3 downto 0);
+        lower_addr_mas_b <= sig_mas_op_b(3 downto 0);
     end generate;
     g_addr_w64: if G_W=64 generate   --! G_N = 3
         lower_addr_op_a <= sig_op_a(3 downto 1);
         lower_addr_op_b <= sig_op_b(3 downto 1);
         lower_addr_dest <= sig_op_dest(3 downto 1);
+        lower_addr_mas_a <= sig_mas_op_a(3 downto 1);
+        lower_addr_mas_b <= sig_mas_op_b(3 downto 1);
     end generate;
 
     sig_ram1_addr_a  <=
@@ -402,6 +495,18 @@ begin
         sig_op_dest(1 downto 0) & idx_dest(G_N-1 downto 0)
         when idx_dest(G_N) = '0' else
         "11" & lower_addr_dest;
+    mas_ram1_addr_a  <=
+        sig_mas_op_a(3 downto 0) & sig_mas_idx_a(G_N-1 downto 0)
+        when sig_mas_idx_a(G_N) = '0' else
+        "1111" & lower_addr_mas_a;
+    mas_ram2_addr_a  <=
+        sig_mas_op_a(1 downto 0) & sig_mas_idx_a(G_N-1 downto 0)
+        when sig_mas_idx_a(G_N) = '0' else
+        "11" & lower_addr_mas_a;
+    mas_ram2_addr_b  <=
+        sig_mas_op_b(1 downto 0) & sig_mas_idx_b(G_N-1 downto 0)
+        when sig_mas_idx_b(G_N) = '0' else
+        "11" & lower_addr_mas_b;
     --! Write controls
     g_wr_wn64: if G_W/=64 generate
         sig_ram1_wr_hi <= idx_wr and not sig_op_dest(4);
@@ -436,15 +541,15 @@ begin
     idx_b <= sig_mas_idx_b    when MODULE_MAS,
                 sig_mmm_idx_b    when MODULE_MMM,
                 sig_mc_idx_b     when others;
-    with reg_mem_sel select
+    with wr_sel select
     idx_dest <= sig_mas_idx_dest    when MODULE_MAS,
                 sig_mmm_idx_dest    when MODULE_MMM,
                 sig_mc_idx_dest     when others;
-    with reg_mem_sel select
+    with wr_sel select
     idx_wr  <=  sig_mas_idx_wr      when MODULE_MAS,
                 sig_mmm_idx_wr      when MODULE_MMM,
                 sig_mc_idx_wr       when others;
-    with reg_mem_sel select
+    with wr_sel select
     data_dest <= sig_mas_data_dest  when MODULE_MAS,
                  sig_mmm_data_dest  when MODULE_MMM,
                  sig_mc_data_dest   when others;
@@ -456,11 +561,127 @@ begin
     sig_op_b <= sig_mas_op_b when MODULE_MAS,
                 sig_mmm_op_b when MODULE_MMM,
                 sig_mc_op_b when others;
-    with reg_mem_sel select
+    with wr_sel select
     sig_op_dest <=  sig_mas_op_dest when MODULE_MAS,
                     sig_mmm_op_dest when MODULE_MMM,
                     sig_mc_op_dest when others;
 
+    --! =======================================================================
+    --! Operand-bank partitioning
+    --! =======================================================================
+    --! Ports used by the lock holder this cycle. A write of the MC, even
+    --! without the lock, takes port a of its RAM
+    with reg_mem_sel select
+    c_idx_wr    <=  sig_mas_idx_wr      when MODULE_MAS,
+                    sig_mmm_idx_wr      when MODULE_MMM,
+                    sig_mc_idx_wr       when others;
+    with reg_mem_sel select
+    c_dest_msb  <=  sig_mas_op_dest(4)  when MODULE_MAS,
+                    sig_mmm_op_dest(4)  when MODULE_MMM,
+                    sig_mc_op_dest(4)   when others;
+    c_a1 <= (reg_mem_busy and not sig_op_a(4)) or (c_idx_wr and not c_dest_msb);
+    c_a2 <= (reg_mem_busy and     sig_op_a(4)) or (c_idx_wr and     c_dest_msb);
+    c_b2 <=  reg_mem_busy and     sig_op_b(4);
+    --! MAS reads port a of the RAM of op_a and always port b of RAM2
+    mas_a1 <= (not sig_mas_op_a(4)) or (sig_mas_idx_wr and not sig_mas_op_dest(4));
+    mas_a2 <=      sig_mas_op_a(4)  or (sig_mas_idx_wr and     sig_mas_op_dest(4));
+    --! Held for the cycle on a collision, the lock holder goes first
+    mas_en <= '0' when reg_mas_lock = '1'
+                   and ((mas_a1 and c_a1) or (mas_a2 and c_a2) or c_b2
+                        or (sig_mas_idx_wr and c_idx_wr)) = '1'
+              else '1';
+    mas_own_a1 <= reg_mas_lock and mas_en and mas_a1;
+    mas_own_a2 <= reg_mas_lock and mas_en and mas_a2;
+    mas_own_b2 <= reg_mas_lock and mas_en;
+    mas_wr     <= reg_mas_lock and mas_en and sig_mas_idx_wr;
+    wr_sel     <= MODULE_MAS when mas_wr = '1' else reg_mem_sel;
+
+    mas_hz_new  <= slot_hazard(sig_mas_op_a, sig_mas_op_b, sig_mas_op_dest,
+                    reg_mmm_slot_a, reg_mmm_slot_b, reg_mmm_slot_d);
+    mmm_hz_held <= slot_hazard(reg_mas_slot_a, reg_mas_slot_b, reg_mas_slot_d,
+                    sig_mmm_op_a, sig_mmm_op_b, sig_mmm_op_dest);
+    mmm_hz_new  <= slot_hazard(sig_mas_op_a, sig_mas_op_b, sig_mas_op_dest,
+                    sig_mmm_op_a, sig_mmm_op_b, sig_mmm_op_dest);
+
+    split_mas_ack <= '1' when G_SPLIT
+                         and sig_mas_lock_req = '1' and reg_mas_lock = '0'
+                         and sig_mc_lock_req  = '0'
+                         and not (reg_mem_busy = '1' and reg_mem_sel = MODULE_MC)
+                         and not (reg_mem_busy = '1' and reg_mem_sel = MODULE_MMM
+                                  and mas_hz_new = '1')
+                     else '0';
+    mmm_may_share <= '1' when not G_SPLIT
+                         or ((reg_mas_lock and mmm_hz_held)
+                             or (split_mas_ack and mmm_hz_new)) = '0'
+                     else '0';
+
+    --! MAS data, with the word read before a held cycle kept for it
+    g_mas_split: if G_SPLIT generate
+        signal reg_mas_op_a_msb : std_logic;
+        signal reg_mas_op_b_msb : std_logic;
+        signal reg_mas_zero_a   : std_logic;
+        signal reg_mas_zero_b   : std_logic;
+        signal reg_mas_en       : std_logic;
+        signal hold_valid       : std_logic;
+        signal sel_a            : std_logic_vector(1 downto 0);
+        signal sel_b            : std_logic_vector(1 downto 0);
+        signal live_a           : std_logic_vector(G_W      -1 downto 0);
+        signal live_b           : std_logic_vector(G_W      -1 downto 0);
+        signal hold_a           : std_logic_vector(G_W      -1 downto 0);
+        signal hold_b           : std_logic_vector(G_W      -1 downto 0);
+    begin
+        assert G_W /= 64
+            report "Mem_Ctrl_LW: G_SPLIT is not supported for G_W = 64"
+            severity failure;
+
+        sel_a <= reg_mas_zero_a & reg_mas_op_a_msb;
+        sel_b <= reg_mas_zero_b & reg_mas_op_b_msb;
+        with sel_a select
+        live_a <=   sig_ram1_data_a when "00",
+                    sig_ram2_data_a when "01",
+                    (others => '0') when others;
+        with sel_b select
+        live_b <=   sig_ram1_data_b when "00",
+                    sig_ram2_data_b when "01",
+                    (others => '0') when others;
+        mas_data_a <= hold_a when hold_valid = '1' else live_a;
+        mas_data_b <= hold_b when hold_valid = '1' else live_b;
+
+        process(clk, rstn)
+        begin
+            if (rstn = '0') then
+                reg_mas_en <= '1';
+                hold_valid <= '0';
+            elsif rising_edge(clk) then
+                reg_mas_op_a_msb <= sig_mas_op_a(4);
+                reg_mas_op_b_msb <= sig_mas_op_b(4);
+                if (sig_mas_idx_a > field_words) then
+                    reg_mas_zero_a <= '1';
+                else
+                    reg_mas_zero_a <= '0';
+                end if;
+                if (sig_mas_idx_b > field_words) then
+                    reg_mas_zero_b <= '1';
+                else
+                    reg_mas_zero_b <= '0';
+                end if;
+
+                reg_mas_en <= mas_en;
+                if (mas_en = '1') then
+                    hold_valid <= '0';
+                elsif (reg_mas_en = '1') then
+                    hold_a     <= live_a;
+                    hold_b     <= live_b;
+                    hold_valid <= '1';
+                end if;
+            end if;
+        end process;
+    end generate;
+    g_mas_shared: if not G_SPLIT generate
+        mas_data_a <= sig_data_a;
+        mas_data_b <= sig_data_b;
+    end generate;
+
     --! =======================================================================
     --! Status registers
     --! =======================================================================
@@ -491,13 +712,13 @@ begin
             if (reg_mem_busy = '0') then
                 if (sig_mc_lock_ack  = '1' or
                     sig_mmm_lock_ack = '1' or
-                    sig_mas_lock_ack = '1')
+                    (sig_mas_lock_ack = '1' and not G_SPLIT))
                 then
                     reg_mem_busy <= '1';
                 end if;
                 if (sig_mc_lock_ack = '1') then
                     reg_mem_sel  <= MODULE_MC;
-                elsif (sig_mas_lock_ack = '1') then
+                elsif (sig_mas_lock_ack = '1' and not G_SPLIT) then
                     reg_mem_sel  <= MODULE_MAS;
                 elsif (sig_mmm_lock_ack = '1') then
                     reg_mem_sel  <= MODULE_MMM;
@@ -508,6 +729,30 @@ begin
                     reg_mem_sel  <= MODULE_MC;
                 end if;
             end if;
+
+            if (sig_mmm_lock_ack = '1') then
+                reg_mmm_slot_a <= sig_mmm_op_a;
+                reg_mmm_slot_b <= sig_mmm_op_b;
+                reg_mmm_slot_d <= sig_mmm_op_dest;
+            end if;
+            if (split_mas_ack = '1') then
+                reg_mas_slot_a <= sig_mas_op_a;
+                reg_mas_slot_b <= sig_mas_op_b;
+                reg_mas_slot_d <= sig_mas_op_dest;
+            end if;
+        end if;
+    end process;
+
+    process(clk, rstn)
+    begin
+        if (rstn = '0') then
+            reg_mas_lock <= '0';
+        elsif rising_edge(clk) then
+            if (split_mas_ack = '1') then
+                reg_mas_lock <= '1';
+            elsif (sig_mas_lock_release = '1' and mas_en = '1') then
+                reg_mas_lock <= '0';
+            end if;
         end if;
     end process;
 
@@ -518,7 +763,8 @@ begin
         sig_mas_lock_req,
         sig_mas_lock_release, sig_mmm_lock_release,
         sig_mc_lock_release,
-        reg_mem_sel, reg_mem_busy)
+        reg_mem_sel, reg_mem_busy, reg_mas_lock, mmm_may_share,
+        split_mas_ack)
     begin
         sig_mc_lock_ack     <= '0';
         sig_mem_release     <= '0';
@@ -528,10 +774,12 @@ begin
 
         if (reg_mem_busy = '0') then
             if (sig_mc_lock_req = '1') then
-                sig_mc_lock_ack <= '1';
-            elsif (sig_mas_lock_req = '1') then
+                if (not G_SPLIT or reg_mas_lock = '0') then
+                    sig_mc_lock_ack <= '1';
+                end if;
+            elsif (sig_mas_lock_req = '1' and not G_SPLIT) then
                 sig_mas_lock_ack <= '1';
-            elsif (sig_mmm_lock_req = '1') then
+            elsif (sig_mmm_lock_req = '1' and mmm_may_share = '1') then
                 sig_mmm_lock_ack <= '1';            
             end if;
         elsif (reg_mem_busy = '1') then
@@ -549,5 +797,74 @@ begin
                 sig_mem_release <= '1';
             end if;
         end if;
+
+        if (G_SPLIT) then
+            sig_mas_lock_ack <= split_mas_ack;
+        end if;
     end process;
+
+    --! =======================================================================
+    --! Statistics
+    --! =======================================================================
+    mas_hold <= '1' when (reg_mem_busy = '1' and reg_mem_sel = MODULE_MAS)
+                      or reg_mas_lock = '1' else '0';
+    mmm_hold <= '1' when reg_mem_busy = '1' and reg_mem_sel = MODULE_MMM
+                else '0';
+    mc_hold  <= '1' when reg_mem_busy = '1' and reg_mem_sel = MODULE_MC
+                else '0';
+
+    process(clk, rstn)
+    begin
+        if (rstn = '0') then
+            reg_stat_start <= '0';
+            stat_mas_busy  <= (others => '0');
+            stat_mas_stall <= (others => '0');
+            stat_mmm_busy  <= (others => '0');
+            stat_mmm_stall <= (others => '0');
+            stat_mc_busy   <= (others => '0');
+            stat_mc_stall  <= (others => '0');
+        elsif rising_edge(clk) then
+            reg_stat_start <= stat_start;
+            if (stat_start = '1' and reg_stat_start = '0') then
+                stat_mas_busy  <= (others => '0');
+                stat_mas_stall <= (others => '0');
+                stat_mmm_busy  <= (others => '0');
+                stat_mmm_stall <= (others => '0');
+                stat_mc_busy   <= (others => '0');
+                stat_mc_stall  <= (others => '0');
+            else
+                if (mas_hold = '1') then
+                    stat_mas_busy <= stat_mas_busy + 1;
+                end if;
+                if ((sig_mas_lock_req = '1' and sig_mas_lock_ack = '0'
+                     and mas_hold = '0') or mas_en = '0')
+                then
+                    stat_mas_stall <= stat_mas_stall + 1;
+                end if;
+                if (mmm_hold = '1') then
+                    stat_mmm_busy <= stat_mmm_busy + 1;
+                end if;
+                if (sig_mmm_lock_req = '1' and sig_mmm_lock_ack = '0'
+                    and mmm_hold = '0')
+                then
+                    stat_mmm_stall <= stat_mmm_stall + 1;
+                end if;
+                if (mc_hold = '1') then
+                    stat_mc_busy <= stat_mc_busy + 1;
+                end if;
+                if (sig_mc_lock_req = '1' and sig_mc_lock_ack = '0'
+                    and mc_hold = '0')
+                then
+                    stat_mc_stall <= stat_mc_stall + 1;
+                end if;
+            end if;
+        end if;
+    end process;
+
+    stats <= std_logic_vector(stat_mc_stall)
+           & std_logic_vector(stat_mc_busy)
+           & std_logic_vector(stat_mmm_stall)
+           & std_logic_vector(stat_mmm_busy)
+           & std_logic_vector(stat_mas_stall)
+           & std_logic_vector(stat_mas_busy);
 end architecture structure;
\ No newline at end of file
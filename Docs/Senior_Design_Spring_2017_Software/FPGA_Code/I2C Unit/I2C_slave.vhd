@@ -123,8 +123,8 @@ begin
   begin
     if rising_edge(clk) then
       -- save SCL in registers that are used for debouncing
-      scl_reg <= scl;
-      sda_reg <= sda;
+      scl_reg <= to_X01(scl);  -- weak pull-up 'H' reads as '1' in simulation
+      sda_reg <= to_X01(sda);
 
       -- Delay debounced SCL and SDA by 1 clock cycle
       scl_prev_reg   <= scl_debounced;
@@ -8,12 +8,52 @@
 -- 3) comment the state Send_C, and uncomment the state sendkey. State will now go from Send_R to sendkey
 -- 4) remove elgamal_calc associated values and signals here and in top file
 -- 5) make microcontroller only send Value of R to perform scalar multiplication operation of kR
+--------------------------------------------------------------------------------------------------------
+-- Field and curve parameters are uploaded once after reset (P-192) and stay loaded in the ECC core.
+-- The first word of every request from the microcontroller is a command:
+--   CMD_REINIT         : upload the parameters of the loaded curve again, nothing follows
+--   CMD_STATS          : the next read burst returns the memory controller counters of the last
+--                        finished job instead of a result, STAT_WORDS words, nothing follows
+--   CMD_CURVE & id     : compute on curve id (CURVE_WORDS), R and C follow, 2 * CURVE_WORDS(id) words each
+--   any other word     : compute on the curve of the previous request (0x0000 by convention)
+-- The parameters are only uploaded again when a job needs a different curve than the loaded one,
+-- so requests on the same curve pay no upload. A job with an unknown curve id is discarded,
+-- its words are counted with the length of the previous curve.
+-- Curve ids are the field size codes of the scheduler: 0 = P-192, 1 = P-224, 2 = P-256.
+-- P-384 and P-521 are left out, the buffers would grow to 24 and 33 words per coordinate.
+-- The job and result slots are sized for curve MAX_CURVE. The default is P-192, the only curve
+-- fpga_ecc.c sends; a job for a larger curve is then discarded like an unknown id.
+--------------------------------------------------------------------------------------------------------
+-- Job queue: the host side and the ECC side run independently.
+-- Operands go into one of JOB_SLOTS job buffers as they arrive, and the ECC side feeds the oldest
+-- full job to the core on its own handshake (C is only taken by the core after kR is done).
+-- Results go into one of two result buffers, so the operands of job N+1 can be uploaded and
+-- result N read out while the core works. A job only starts when a result buffer is free.
+-- The host may have at most JOB_SLOTS jobs waiting to start; the words of a job that arrives
+-- with every slot full are discarded. Results are read in order, 2 * CURVE_WORDS words per burst
+-- (24 for P-192); a read with no result ready returns zeros. The front-ends issue one more
+-- read_req after the last word of a burst, that one is ignored.
+-- Both buffers are DPBRam block RAMs with a registered read, not flip-flops. The ECC side
+-- drops di_valid for one cycle after every word it hands to the core, while the RAM reads the
+-- next one. The host side keeps the RAM address on the next result word, so a word is ready
+-- when its read_req comes.
+--------------------------------------------------------------------------------------------------------
+-- done tells the host a result can be read, so it does not have to poll over the bus. Unlike busy
+-- it rises after the result words are in the result buffer, the read-out can start right away.
+--   DONE_PULSE = false : level, high while a result waits to be read, drops with the trailing
+--                        read_req of its burst (stays high if the next result is already there)
+--   DONE_PULSE = true  : DONE_PULSE_CYCLES wide pulse for every stored result
 
 library IEEE;
 use IEEE.STD_LOGIC_1164.ALL;
 use ieee.numeric_std.all;
 
 entity Intermediate is
+generic(
+		MAX_CURVE						: integer := 0;-- largest curve id the buffers hold, see header
+		DONE_PULSE						: boolean := false;-- done output mode, see header
+		DONE_PULSE_CYCLES				: integer := 16-- pulse width, long enough for the MSP432 edge detect
+	);
 port(
 		clk 		        			: in    std_logic;
 		rst 		        			: in    std_logic;
@@ -32,7 +72,9 @@ port(
         init_field          			: out   std_logic;
         init_curve          			: out   std_logic;
         start               			: out   std_logic;
-		elgamal_calc					: out   std_logic
+		elgamal_calc					: out   std_logic;
+		ecc_stats						: in    std_logic_vector(12*16-1 downto 0);-- Mem_Ctrl_LW counters
+		done							: out   std_logic-- result ready to be read
      );
 end Intermediate;
 
@@ -44,79 +86,265 @@ architecture arch of Intermediate is
    -- 3) precomputed value of R^2 mod p
    -- 4) curve parameter a
    -- 5) k(optional)
-   type Initialization is array (0 to 36) of std_logic_vector(15 downto 0);
-    constant Initialize: Initialization :=
+   -- one table per curve id, curve words = CURVE_WORDS(id)
+   constant CURVES                : integer := 3;
+   constant MAX_WORDS             : integer := 16;-- 16-bit words per coordinate of the largest curve
+   type curve_words_t is array (0 to CURVES-1) of integer;
+   constant CURVE_WORDS           : curve_words_t := (12, 14, 16);
+   type Initialization is array (0 to 3*MAX_WORDS) of std_logic_vector(15 downto 0);
+   type Initialization_set is array (0 to CURVES-1) of Initialization;
+    constant Initialize: Initialization_set :=
     (
-        "0000000000000000",--0(Encode = 0)
-		"1111111111111111",--1(beginning of p )
-		"1111111111111111",--2
-		"1111111111111111",--3
-		"1111111111111111",--4
-		"1111111111111110",--5
-		"1111111111111111",--6
-		"1111111111111111",--7
-		"1111111111111111",--8
-		"1111111111111111",--9
-		"1111111111111111",--10
-		"1111111111111111",--11
-		"1111111111111111",--12(end of p)
-		"0000000000000001",--13(beginning of R^2 mod p)
-		"0000000000000000",--14
-		"0000000000000000",--15
-		"0000000000000000",--16
-		"0000000000000010",--17
-		"0000000000000000",--18
-		"0000000000000000",--19
-		"0000000000000000",--20
-		"0000000000000001",--21
-		"0000000000000000",--22
-		"0000000000000000",--23
-		"0000000000000000", --24(end of R^2 mod p)
-		"1111111111111100",--25(beginning of curve parameter a)
-		"1111111111111111",--26
-		"1111111111111111",--27
-		"1111111111111111",--28
-		"1111111111111110",--29
-		"1111111111111111",--30
-		"1111111111111111",--31
-		"1111111111111111",--32
-		"1111111111111111",--33
-		"1111111111111111",--34
-		"1111111111111111",--35
-		"1111111111111111" --36(end of curve parameter a)
---		"0000000000000001", --37 (beginning of k)
---      "0000000000000000", --38
---      "0000000000000000", --39
---      "0000000000000000", --40
---      "0000000000000000", --41
---      "0000000000000000", --42
---      "0000000000000000", --43
---      "0000000000000000", --44
---      "0000000000000000", --45
---      "0000000000000000", --46
---      "0000000000000000", --47
---      "0000000000000000"  --48 (end of k)   
+		-- P-192
+		(
+			"0000000000000000",--0(Encode = 0)
+			"1111111111111111",--1(beginning of p )
+			"1111111111111111",--2
+			"1111111111111111",--3
+			"1111111111111111",--4
+			"1111111111111110",--5
+			"1111111111111111",--6
+			"1111111111111111",--7
+			"1111111111111111",--8
+			"1111111111111111",--9
+			"1111111111111111",--10
+			"1111111111111111",--11
+			"1111111111111111",--12(end of p)
+			"0000000000000001",--13(beginning of R^2 mod p)
+			"0000000000000000",--14
+			"0000000000000000",--15
+			"0000000000000000",--16
+			"0000000000000010",--17
+			"0000000000000000",--18
+			"0000000000000000",--19
+			"0000000000000000",--20
+			"0000000000000001",--21
+			"0000000000000000",--22
+			"0000000000000000",--23
+			"0000000000000000",--24(end of R^2 mod p)
+			"1111111111111100",--25(beginning of curve parameter a)
+			"1111111111111111",--26
+			"1111111111111111",--27
+			"1111111111111111",--28
+			"1111111111111110",--29
+			"1111111111111111",--30
+			"1111111111111111",--31
+			"1111111111111111",--32
+			"1111111111111111",--33
+			"1111111111111111",--34
+			"1111111111111111",--35
+			"1111111111111111",--36(end of curve parameter a)
+			--"0000000000000001", --37 (beginning of k)
+			--"0000000000000000", --38
+			--"0000000000000000", --39
+			--"0000000000000000", --40
+			--"0000000000000000", --41
+			--"0000000000000000", --42
+			--"0000000000000000", --43
+			--"0000000000000000", --44
+			--"0000000000000000", --45
+			--"0000000000000000", --46
+			--"0000000000000000", --47
+			--"0000000000000000" --48 (end of k)
+			others => (others => '0')
+		),
+		-- P-224
+		(
+			"0000000000000001",--0(Encode = 1)
+			"0000000000000001",--1(beginning of p)
+			"0000000000000000",--2
+			"0000000000000000",--3
+			"0000000000000000",--4
+			"0000000000000000",--5
+			"0000000000000000",--6
+			"1111111111111111",--7
+			"1111111111111111",--8
+			"1111111111111111",--9
+			"1111111111111111",--10
+			"1111111111111111",--11
+			"1111111111111111",--12
+			"1111111111111111",--13
+			"1111111111111111",--14(end of p)
+			"0000000000000001",--15(beginning of R^2 mod p)
+			"0000000000000000",--16
+			"0000000000000000",--17
+			"0000000000000000",--18
+			"0000000000000000",--19
+			"0000000000000000",--20
+			"1111111111111110",--21
+			"1111111111111111",--22
+			"1111111111111111",--23
+			"1111111111111111",--24
+			"1111111111111111",--25
+			"1111111111111111",--26
+			"0000000000000000",--27
+			"0000000000000000",--28(end of R^2 mod p)
+			"1111111111111110",--29(beginning of curve parameter a)
+			"1111111111111111",--30
+			"1111111111111111",--31
+			"1111111111111111",--32
+			"1111111111111111",--33
+			"1111111111111111",--34
+			"1111111111111110",--35
+			"1111111111111111",--36
+			"1111111111111111",--37
+			"1111111111111111",--38
+			"1111111111111111",--39
+			"1111111111111111",--40
+			"1111111111111111",--41
+			"1111111111111111",--42(end of curve parameter a)
+			others => (others => '0')
+		),
+		-- P-256
+		(
+			"0000000000000010",--0(Encode = 2)
+			"1111111111111111",--1(beginning of p)
+			"1111111111111111",--2
+			"1111111111111111",--3
+			"1111111111111111",--4
+			"1111111111111111",--5
+			"1111111111111111",--6
+			"0000000000000000",--7
+			"0000000000000000",--8
+			"0000000000000000",--9
+			"0000000000000000",--10
+			"0000000000000000",--11
+			"0000000000000000",--12
+			"0000000000000001",--13
+			"0000000000000000",--14
+			"1111111111111111",--15
+			"1111111111111111",--16(end of p)
+			"0000000000000011",--17(beginning of R^2 mod p)
+			"0000000000000000",--18
+			"0000000000000000",--19
+			"0000000000000000",--20
+			"1111111111111111",--21
+			"1111111111111111",--22
+			"1111111111111011",--23
+			"1111111111111111",--24
+			"1111111111111110",--25
+			"1111111111111111",--26
+			"1111111111111111",--27
+			"1111111111111111",--28
+			"1111111111111101",--29
+			"1111111111111111",--30
+			"0000000000000100",--31
+			"0000000000000000",--32(end of R^2 mod p)
+			"1111111111111100",--33(beginning of curve parameter a)
+			"1111111111111111",--34
+			"1111111111111111",--35
+			"1111111111111111",--36
+			"1111111111111111",--37
+			"1111111111111111",--38
+			"0000000000000000",--39
+			"0000000000000000",--40
+			"0000000000000000",--41
+			"0000000000000000",--42
+			"0000000000000000",--43
+			"0000000000000000",--44
+			"0000000000000001",--45
+			"0000000000000000",--46
+			"1111111111111111",--47
+			"1111111111111111" --48(end of curve parameter a)
+		)
 	);
 
+    -- First word of a request, see header
+    constant CMD_REINIT            : std_logic_vector(15 downto 0) := x"0001";
+    constant CMD_CURVE             : std_logic_vector(7 downto 0) := x"01";-- high byte, low byte is the curve id
+    constant CMD_STATS             : std_logic_vector(15 downto 0) := x"0002";
+    -- Counters, 32 bits each, least significant word first:
+    -- MAS busy, MAS stall, MMM busy, MMM stall, MC busy, MC stall (cycles)
+    constant STAT_WORDS            : integer := 12;
+    constant JOB_WORDS             : integer := 4*CURVE_WORDS(MAX_CURVE);-- R and C
+    constant RESULT_WORDS          : integer := 2*CURVE_WORDS(MAX_CURVE);-- X and Y
+    constant JOB_SLOTS             : integer := 2;
+    constant JOB_ADDR_BITS         : integer := 7;-- JOB_SLOTS * JOB_WORDS words
+    constant RESULT_ADDR_BITS      : integer := 7;-- 2 * RESULT_WORDS words, and the address past the last one
+
     -- State Machine 
     -- add sendkey if want to perform scalar multiplication
-    type State_type is(init,send_R,send_C,receive,idle,readdata);
+    type State_type is(init,send_R,send_C,receive,idle);
 	signal state : State_type;
 	-- Signals: temp variables & flags
 	signal fieldtemp 			   : std_logic;
 	signal curvetemp 			   : std_logic;
 	signal starttemp 			   : std_logic;
 	signal elgamal_calctemp 	   : std_logic;
+	signal di_validtemp 		   : std_logic;
+	signal init_data 			   : std_logic_vector(15 downto 0);-- parameter word during the upload
 	signal one_second_counter      : unsigned(3 downto 0);
     signal one_second_done_flag    : std_logic;
+    signal restart_wait            : std_logic;-- run the wait and the parameter upload again
+    signal reinit_pending          : std_logic;-- CMD_REINIT received, served when the core is idle
 	signal DO_count 			   : std_logic_vector(4 downto 0);--ECC output count
-    -- Array to hold data
-    type ecc_data is array (0 to 23) of std_logic_vector(15 downto 0);
-    signal ecc_data_output 		   : ecc_data;
+    subtype curve_id is integer range 0 to CURVES-1;
+    type job_curves is array (0 to JOB_SLOTS-1) of curve_id;
+    type result_curves is array (0 to 1) of curve_id;
+    signal loaded_curve 		   : curve_id;-- parameters in the ECC core
+    -- Job buffers, filled by the host side and emptied by the ECC side
+    signal job_wen 				   : std_logic_vector(1 downto 0);
+    signal job_waddr 			   : std_logic_vector(JOB_ADDR_BITS-1 downto 0);
+    signal job_wdata 			   : std_logic_vector(15 downto 0);
+    signal job_raddr 			   : std_logic_vector(JOB_ADDR_BITS-1 downto 0);
+    signal job_rdata 			   : std_logic_vector(15 downto 0);
+    signal feed_count 			   : integer range 0 to JOB_WORDS;-- operand word of the job being fed to the core
+    signal job_full 			   : std_logic_vector(JOB_SLOTS-1 downto 0);
+    signal job_wr_slot 			   : integer range 0 to JOB_SLOTS-1;
+    signal job_rd_slot 			   : integer range 0 to JOB_SLOTS-1;
+    signal job_curve 			   : job_curves;
+    -- Result buffers, filled by the ECC side and emptied by the host side
+    signal result_wen 			   : std_logic_vector(1 downto 0);
+    signal result_waddr 		   : std_logic_vector(RESULT_ADDR_BITS-1 downto 0);
+    signal result_wdata 		   : std_logic_vector(15 downto 0);
+    signal result_raddr 		   : std_logic_vector(RESULT_ADDR_BITS-1 downto 0);
+    signal result_rdata 		   : std_logic_vector(15 downto 0);
+    signal read_count 			   : integer range 0 to RESULT_WORDS;-- result word being read by the host
+    signal result_full 			   : std_logic_vector(1 downto 0);
+    signal result_wr_slot 		   : integer range 0 to 1;
+    signal result_rd_slot 		   : integer range 0 to 1;
+    signal result_curve 		   : result_curves;
+    -- Counters of the last finished job, read out after CMD_STATS
+    type stat_data is array (0 to STAT_WORDS-1) of std_logic_vector(15 downto 0);
+    signal stats_snapshot 		   : stat_data;
+    signal stats_pending 		   : std_logic;
 
 begin
 
 fieldtemp <= '1' when one_second_counter = "1001" else '0'; -- Assert fieldtemp
+di_valid  <= di_validtemp;
+-- Operands come straight from the job RAM, parameters from the registered ROM word
+di_data   <= job_rdata when (state = send_R or state = send_C) else init_data;
+
+-- Job and result buffers. The read addresses are registers of the process below,
+-- so both RAMs see a stable address and return its word one cycle later
+job_raddr    <= std_logic_vector(to_unsigned(job_rd_slot*JOB_WORDS + feed_count, JOB_ADDR_BITS));
+result_raddr <= std_logic_vector(to_unsigned(result_rd_slot*RESULT_WORDS + read_count, RESULT_ADDR_BITS));
+
+JOB_RAM: ENTITY work.DPBRam(behavioral)
+	GENERIC MAP (DataWidth => 16, AddrWidth => JOB_ADDR_BITS)
+	PORT MAP(
+				clk 						=> clk,
+				wenA 						=> job_wen,
+				addrA 						=> job_waddr,
+				addrB 						=> job_raddr,
+				dinA 						=> job_wdata,
+				doutA 						=> open,
+				doutB 						=> job_rdata
+			);
+
+RESULT_RAM: ENTITY work.DPBRam(behavioral)
+	GENERIC MAP (DataWidth => 16, AddrWidth => RESULT_ADDR_BITS)
+	PORT MAP(
+				clk 						=> clk,
+				wenA 						=> result_wen,
+				addrA 						=> result_waddr,
+				addrB 						=> result_raddr,
+				dinA 						=> result_wdata,
+				doutA 						=> open,
+				doutB 						=> result_rdata
+			);
+
 -- Process to wait a number of clock cycles before starting. 
 -- Can choose any number of clock cycles
 process(clk,rst)
@@ -125,7 +353,10 @@ begin
         one_second_counter <=(others => '0');
         one_second_done_flag <= '0';
     elsif (rising_edge(clk)) then  
-        if(one_second_done_flag = '1') then
+        if(restart_wait = '1') then
+            one_second_counter <= (others => '0');
+            one_second_done_flag <= '0';
+        elsif(one_second_done_flag = '1') then
             one_second_counter <= (others => '0');
         else
             if(one_second_counter = "1001") then
@@ -136,45 +367,85 @@ begin
             end if;
         end if;
     end if;
-end process;     
+end process;
+-- done output, level or pulse (see header). Registered, it drives an interrupt pin
+DONE_LEVEL_GEN: if not DONE_PULSE generate
+    process(clk,rst)
+    begin
+        if(rst = '0') then
+            done <= '0';
+        elsif(rising_edge(clk)) then
+            done <= result_full(result_rd_slot);
+        end if;
+    end process;
+end generate DONE_LEVEL_GEN;
+
+DONE_PULSE_GEN: if DONE_PULSE generate
+    signal result_full_prev : std_logic_vector(1 downto 0);
+    signal done_count       : integer range 0 to DONE_PULSE_CYCLES;
+begin
+    process(clk,rst)
+    begin
+        if(rst = '0') then
+            result_full_prev <= (others => '0');
+            done_count <= 0;
+            done <= '0';
+        elsif(rising_edge(clk)) then
+            result_full_prev <= result_full;
+            if((result_full and not result_full_prev) /= "00") then
+                done_count <= DONE_PULSE_CYCLES - 1;
+                done <= '1';
+            elsif(done_count /= 0) then
+                done_count <= done_count - 1;
+            else
+                done <= '0';
+            end if;
+        end if;
+    end process;
+end generate DONE_PULSE_GEN;
+
 -- Process where appropriate data is sent to the ECC core depending on which state it is in
 process(clk,rst)
-variable rdptr : integer range 0 to 39;-- counter that goes through ROM indices
-variable count : integer range 0 to 23;-- counter used to count number of ECC outputs
+variable rdptr : integer range 0 to 3*MAX_WORDS+1;-- counter that goes through ROM indices
+variable host_count : integer range 0 to JOB_WORDS;-- word of the job being received, 0 = command word
+variable host_drop : boolean;-- job being received is discarded, no free slot or unknown curve
+variable host_curve : curve_id;-- curve of the job being received, kept for the next compute command
 begin
     -- Initialize upon active low reset
 	if(rst = '0') then
 		rdptr     := 0;
-        count     := 0;
+        host_count := 0;
+        host_drop := false;
+        host_curve := 0;
+        feed_count <= 0;
+        read_count <= 0;
+        init_data <= (others => '0');
+        job_wen   <= (others => '0');
+        job_waddr <= (others => '0');
+        job_wdata <= (others => '0');
+        result_wen   <= (others => '0');
+        result_waddr <= (others => '0');
+        result_wdata <= (others => '0');
 		state     <= init;
         DO_count  <= (others => '0');
 		curvetemp <= '0';
 		starttemp <= '0';
 		elgamal_calctemp    <= '0';
-        ecc_data_output(0)  <= (others => '0');
-        ecc_data_output(1)  <= (others => '0');
-        ecc_data_output(2)  <= (others => '0');
-        ecc_data_output(3)  <= (others => '0');
-        ecc_data_output(4)  <= (others => '0');
-        ecc_data_output(5)  <= (others => '0');
-        ecc_data_output(6)  <= (others => '0');
-        ecc_data_output(7)  <= (others => '0');
-        ecc_data_output(8)  <= (others => '0');
-        ecc_data_output(9)  <= (others => '0');
-        ecc_data_output(10) <= (others => '0');
-        ecc_data_output(11) <= (others => '0');
-        ecc_data_output(12) <= (others => '0');
-        ecc_data_output(13) <= (others => '0');
-        ecc_data_output(14) <= (others => '0');
-        ecc_data_output(15) <= (others => '0');
-        ecc_data_output(16) <= (others => '0');
-        ecc_data_output(17) <= (others => '0');
-        ecc_data_output(18) <= (others => '0');
-        ecc_data_output(19) <= (others => '0');
-        ecc_data_output(20) <= (others => '0');
-        ecc_data_output(21) <= (others => '0');
-        ecc_data_output(22) <= (others => '0');
-        ecc_data_output(23) <= (others => '0');
+		di_validtemp        <= '0';
+		do_ready            <= '0';
+        restart_wait        <= '0';
+        reinit_pending      <= '0';
+        stats_pending       <= '0';
+        job_full            <= (others => '0');
+        job_wr_slot         <= 0;
+        job_rd_slot         <= 0;
+        result_full         <= (others => '0');
+        result_wr_slot      <= 0;
+        result_rd_slot      <= 0;
+        data_to_master      <= (others => '0');
+        loaded_curve        <= 0;
+        job_curve           <= (others => 0);
+        result_curve        <= (others => 0);
 
 	elsif(rising_edge(clk)) then
 
@@ -182,63 +453,143 @@ begin
 		init_curve   <= curvetemp;
 		start 	     <= starttemp;
 		elgamal_calc <= elgamal_calctemp;
-			
+		restart_wait <= '0';
+		job_wen      <= (others => '0');
+		result_wen   <= (others => '0');
+
+		-----------------------------------------------------
+		-- Host side: command word and operands into the job queue
+		-----------------------------------------------------
+		if(data_valid = '1') then
+			if(host_count = 0) then
+				if(data_from_master = CMD_REINIT) then
+					reinit_pending <= '1';
+				elsif(data_from_master = CMD_STATS) then
+					stats_pending <= '1';
+				else
+					host_drop  := job_full(job_wr_slot) = '1';
+					if(data_from_master(15 downto 8) = CMD_CURVE) then
+						if(to_integer(unsigned(data_from_master(7 downto 0))) <= MAX_CURVE) then
+							host_curve := to_integer(unsigned(data_from_master(7 downto 0)));
+						else
+							host_drop := true;
+						end if;
+					end if;
+					host_count := 1;
+				end if;
+			else
+				if(not host_drop) then
+					job_wen   <= (others => '1');
+					job_waddr <= std_logic_vector(to_unsigned(job_wr_slot*JOB_WORDS + host_count - 1, JOB_ADDR_BITS));
+					job_wdata <= data_from_master;
+				end if;
+				if(host_count = 4*CURVE_WORDS(host_curve)) then
+					host_count := 0;
+					if(not host_drop) then
+						job_full(job_wr_slot) <= '1';
+						job_curve(job_wr_slot) <= host_curve;
+						job_wr_slot <= (job_wr_slot + 1) mod JOB_SLOTS;
+					end if;
+				else
+					host_count := host_count + 1;
+				end if;
+			end if;
+		end if;
+
+		-----------------------------------------------------
+		-- Host side: result read out, one burst of 2 * CURVE_WORDS words per result
+		-----------------------------------------------------
+		if(read_req = '1') then
+			if(stats_pending = '1') then
+				if(read_count = STAT_WORDS) then-- trailing request
+					read_count <= 0;
+					stats_pending <= '0';
+				else
+					data_to_master <= stats_snapshot(read_count);
+					read_count <= read_count + 1;
+				end if;
+			elsif(read_count = 2*CURVE_WORDS(result_curve(result_rd_slot))) then-- trailing request after the last word
+				read_count <= 0;
+				result_full(result_rd_slot) <= '0';
+				result_rd_slot <= 1 - result_rd_slot;
+			elsif(result_full(result_rd_slot) = '1') then
+				data_to_master <= result_rdata;-- RAM already on this word, see result_raddr
+				read_count <= read_count + 1;
+			else
+				data_to_master <= (others => '0');
+			end if;
+		end if;
+
+		-----------------------------------------------------
+		-- ECC side
+		-----------------------------------------------------
 		case state is
             -- State to Send Field and Curve Initialization values
 			when init =>
-				di_valid <= '1';
+				di_validtemp <= '1';
 				if(di_ready = '1') then
 					rdptr:= rdptr + 1;
-					if(rdptr = 25) then
+					if(rdptr = 2*CURVE_WORDS(loaded_curve) + 1) then
 						curvetemp <= '1';-- Assert curvetemp
 					end if;
-					if(rdptr = 26) then
+					if(rdptr = 2*CURVE_WORDS(loaded_curve) + 2) then
 						curvetemp <= '0';
 					end if;
-					if(rdptr = 37) then
+					if(rdptr = 3*CURVE_WORDS(loaded_curve) + 1) then
 						state <= idle;
 						rdptr:= rdptr - 1;
 					end if;
 				end if;
-				di_data <= Initialize(rdptr);	
-            -- After Initialization of field and curve, wait till microcontroller sends R value
+				init_data <= Initialize(loaded_curve)(rdptr);
+            -- Parameters stay loaded. Start the oldest queued job once a result buffer is free,
+            -- after loading its curve if it is not the loaded one
 			when idle =>
-				di_valid <= '0';
-				if(data_valid = '1') then-- wait for one dummy data before starting
-                        starttemp <= '1';-- Assert starttemp
-                        state <= send_R;
-						elgamal_calctemp <= '1';-- Assert elgamal_calctemp
+				di_validtemp <= '0';
+				if(reinit_pending = '1') then
+					reinit_pending <= '0';
+					rdptr:= 0;
+					restart_wait <= '1';
+					state <= init;
+				elsif(job_full(job_rd_slot) = '1' and job_curve(job_rd_slot) /= loaded_curve) then
+					loaded_curve <= job_curve(job_rd_slot);
+					rdptr:= 0;
+					restart_wait <= '1';
+					state <= init;
+				elsif(job_full(job_rd_slot) = '1' and result_full(result_wr_slot) = '0') then
+                    starttemp <= '1';-- Assert starttemp
+                    state <= send_R;
+					elgamal_calctemp <= '1';-- Assert elgamal_calctemp
+					di_validtemp <= '1';-- feed_count is 0, the job RAM already holds word 0
 				end if;
-			-- Receiving R value from microcontroller and sending it to ECC core	
+			-- Sending R to the ECC core. A word is taken when di_valid and di_ready are both high.
+			-- di_valid then drops for one cycle while the job RAM reads the next word
 			when send_R =>	
-				if(data_valid = '1' and di_ready = '1') then
-					di_valid <= '1';
-					di_data <= data_from_master;
-					count := count + 1;
+				if(di_validtemp = '1' and di_ready = '1') then
+					feed_count <= feed_count + 1;
+					di_validtemp <= '0';
+					if(feed_count + 1 = 2*CURVE_WORDS(loaded_curve)) then
+						state <= send_C;
+					end if;
 				else
-					di_valid <= '0';
+					di_validtemp <= '1';
 				end if;
-				if(count = 24) then
-					count := 0;
-					state <= send_C;
-					di_valid <= '1';
-				end if;		
-			-- Receiving C value from microcontroller and sending it to ECC core	
+			-- Sending C to the ECC core, taken after kR is computed
 			when Send_C =>
-				if(data_valid = '1' and di_ready = '1') then
-					di_valid <= '1';
-					di_data <= data_from_master;
-					count := count + 1;
+				if(di_validtemp = '1' and di_ready = '1') then
+					di_validtemp <= '0';
+					if(feed_count + 1 = 4*CURVE_WORDS(loaded_curve)) then
+						feed_count <= 0;
+						job_full(job_rd_slot) <= '0';
+						job_rd_slot <= (job_rd_slot + 1) mod JOB_SLOTS;
+						state <= receive;
+						starttemp <= '0';
+						elgamal_calctemp <= '0';
+						do_ready <= '1';
+					else
+						feed_count <= feed_count + 1;
+					end if;
 				else
-					di_valid <= '0';
-				end if;
-				if(count = 24) then
-					rdptr:= 36;
-					count:= 0;
-					state <= receive;
-					starttemp <= '0';
-					elgamal_calctemp <= '0';
-					do_ready <= '1';
+					di_validtemp <= '1';
 				end if;
                 
             -----------------------------------------------------   
@@ -255,29 +606,28 @@ begin
 				-- di_data <= Initialize(rdptr);   
             --------------------------------------------------------
             
-			-- Store ECC core output values into array 	
+			-- Store ECC core output values into the free result buffer
 			when receive =>
-                if(do_valid = '1' and Do_count = "10111") then
-                    ecc_data_output(23) <= do_data;
-                    Do_count <= (others => '0');
-                    state <= readdata;
-                elsif(do_valid = '1') then
-                    ecc_data_output(to_integer(unsigned(Do_count))) <= do_data;
-                    Do_count <= std_logic_vector(unsigned(Do_count) + 1);
-                end if;
-            -- Upon microcontroller starting receive mode, will send data back to master from array which holds ECC core outputs      
-            when readdata =>
-                if(read_req = '1' and Do_count = "10111") then
-                    data_to_master <= ecc_data_output(23);
-                    Do_count <= (others => '0');
-                    state <= idle;-- Go back to idle after finish reading and wait till these operations want to be performed again
-                    do_ready <= '0';
-                elsif(read_req = '1') then
-                    data_to_master <= ecc_data_output(to_integer(unsigned(Do_count)));
-                    Do_count <= std_logic_vector(unsigned(Do_count) + 1);
+                if(do_valid = '1') then
+                    result_wen   <= (others => '1');
+                    result_waddr <= std_logic_vector(to_unsigned(result_wr_slot*RESULT_WORDS + to_integer(unsigned(Do_count)), RESULT_ADDR_BITS));
+                    result_wdata <= do_data;
+                    if(to_integer(unsigned(Do_count)) = 2*CURVE_WORDS(loaded_curve) - 1) then
+                        Do_count <= (others => '0');
+                        do_ready <= '0';
+                        result_full(result_wr_slot) <= '1';
+                        result_curve(result_wr_slot) <= loaded_curve;
+                        for i in 0 to STAT_WORDS-1 loop
+                            stats_snapshot(i) <= ecc_stats(16*i+15 downto 16*i);
+                        end loop;
+                        result_wr_slot <= 1 - result_wr_slot;
+                        state <= idle;
+                    else
+                        Do_count <= std_logic_vector(unsigned(Do_count) + 1);
+                    end if;
                 end if;
 
-			end case;
-		end if;
-	end process;
+		end case;
+	end if;
+end process;
 end arch;
@@ -0,0 +1,191 @@
+------------------------------------------------------------
+-- File      : SPI_slave.vhd
+------------------------------------------------------------
+-- SPI slave front-end for the ECC core. Drop-in replacement
+-- for I2C_slave.vhd: same 16-bit user interface towards
+-- Intermediate.vhd (data_to_master, data_from_master,
+-- read_req, data_valid), without the debounce stage and the
+-- per-byte acknowledge of I2C.
+--
+-- SPI mode 0 (CPOL = 0, CPHA = 0), MSB first, the format
+-- spi_driver.c already uses for the Arducam.
+-- Every transaction starts with CS low and one command byte:
+--   x"57" ('W') : every following 16 bits are one word from
+--                 the master, data_valid pulses once per word
+--   x"52" ('R') : read_req pulses after the command byte and
+--                 after every 16 bits shifted out, like the
+--                 master read mode of I2C_slave.vhd
+-- Any other command is ignored until CS goes high.
+--
+-- SCLK, MOSI and CS are sampled with clk through two flip-
+-- flops, so clk has to be at least 10 times SCLK.
+------------------------------------------------------------
+library ieee;
+use ieee.std_logic_1164.all;
+------------------------------------------------------------
+entity SPI_slave is
+  port (
+		clk              : in    std_logic;
+		rst              : in    std_logic;
+		sclk             : in    std_logic;
+		mosi             : in    std_logic;
+		miso             : out   std_logic;
+		cs_n             : in    std_logic;
+		-- User interface
+		data_to_master   : in    std_logic_vector(15 downto 0);  -- Data from Slave to Master during a read command
+		data_from_master : out   std_logic_vector(15 downto 0);  -- Data from Master to Slave during a write command
+		read_req         : out   std_logic;						 -- High when a word wants to be read
+		data_valid       : out   std_logic 					     -- High when a word from the master is available
+		);
+end entity SPI_slave;
+------------------------------------------------------------
+architecture arch of SPI_slave is
+  constant CMD_WRITE : std_logic_vector(7 downto 0) := x"57";
+  constant CMD_READ  : std_logic_vector(7 downto 0) := x"52";
+
+  type state_t is (idle, get_cmd, write, read, ignore);
+  signal state_reg            : state_t := idle;
+
+  -- Synchronisers, index 0 is the first flip-flop
+  signal sclk_sync            : std_logic_vector(2 downto 0) := (others => '0');
+  signal mosi_sync            : std_logic_vector(1 downto 0) := (others => '0');
+  signal cs_sync              : std_logic_vector(1 downto 0) := (others => '1');
+  signal sclk_rising          : std_logic;
+  signal sclk_falling         : std_logic;
+
+  signal bits_processed_reg   : integer range 0 to 15 := 0;
+  signal shift_in_reg         : std_logic_vector(14 downto 0) := (others => '0');
+  signal shift_out_reg        : std_logic_vector(15 downto 0) := (others => '0');
+  signal load_reg             : std_logic := '0'; -- data_to_master is valid one cycle after read_req
+
+  -- User interface
+  signal data_valid_reg       : std_logic := '0';
+  signal read_req_reg         : std_logic := '0';
+  signal data_from_master_reg : std_logic_vector(15 downto 0) := (others => '0');
+
+begin
+
+  sclk_rising  <= sclk_sync(1) and not sclk_sync(2);
+  sclk_falling <= sclk_sync(2) and not sclk_sync(1);
+
+  -- Asynchronous active low reset, like Intermediate.vhd
+  process (clk, rst) is
+  begin
+    if rst = '0' then
+      state_reg            <= idle;
+      sclk_sync            <= (others => '0');
+      mosi_sync            <= (others => '0');
+      cs_sync              <= (others => '1');
+      bits_processed_reg   <= 0;
+      shift_in_reg         <= (others => '0');
+      shift_out_reg        <= (others => '0');
+      load_reg             <= '0';
+      data_valid_reg       <= '0';
+      read_req_reg         <= '0';
+      data_from_master_reg <= (others => '0');
+    elsif rising_edge(clk) then
+      sclk_sync <= sclk_sync(1 downto 0) & sclk;
+      mosi_sync <= mosi_sync(0) & mosi;
+      cs_sync   <= cs_sync(0) & cs_n;
+
+      -- Default assignments
+      data_valid_reg <= '0';
+      read_req_reg   <= '0';
+      load_reg       <= read_req_reg;
+
+      if load_reg = '1' then
+        shift_out_reg <= data_to_master;
+      end if;
+
+      case state_reg is
+
+        when idle =>
+          if cs_sync(1) = '0' then
+            state_reg          <= get_cmd;
+            bits_processed_reg <= 0;
+          end if;
+
+        ----------------------------------------------------
+        -- Command byte, MSB first
+        ----------------------------------------------------
+        when get_cmd =>
+          if sclk_rising = '1' then
+            shift_in_reg <= shift_in_reg(13 downto 0) & mosi_sync(1);
+            if bits_processed_reg = 7 then
+              bits_processed_reg <= 0;
+              if shift_in_reg(6 downto 0) & mosi_sync(1) = CMD_WRITE then
+                state_reg <= write;
+              elsif shift_in_reg(6 downto 0) & mosi_sync(1) = CMD_READ then
+                state_reg    <= read;
+                read_req_reg <= '1';
+              else
+                state_reg <= ignore;
+              end if;
+            else
+              bits_processed_reg <= bits_processed_reg + 1;
+            end if;
+          end if;
+
+        ----------------------------------------------------
+        -- WRITE: 16 bits per word
+        ----------------------------------------------------
+        when write =>
+          if sclk_rising = '1' then
+            if bits_processed_reg = 15 then
+              bits_processed_reg   <= 0;
+              data_from_master_reg <= shift_in_reg & mosi_sync(1);
+              data_valid_reg       <= '1';
+            else
+              bits_processed_reg <= bits_processed_reg + 1;
+              shift_in_reg       <= shift_in_reg(13 downto 0) & mosi_sync(1);
+            end if;
+          end if;
+
+        ----------------------------------------------------
+        -- READ: master samples on the rising edge, next bit goes
+        -- out on the falling edge. No shift on the falling edge
+        -- that ends a word, the next word is being loaded then.
+        ----------------------------------------------------
+        when read =>
+          if sclk_rising = '1' then
+            if bits_processed_reg = 15 then
+              bits_processed_reg <= 0;
+              read_req_reg       <= '1';
+            else
+              bits_processed_reg <= bits_processed_reg + 1;
+            end if;
+          end if;
+          if sclk_falling = '1' and bits_processed_reg /= 0 then
+            shift_out_reg <= shift_out_reg(14 downto 0) & '0';
+          end if;
+
+        -- Unknown command, wait for CS to go high
+        when ignore =>
+          null;
+
+      end case;
+
+      --------------------------------------------------------
+      -- End of transaction
+      --------------------------------------------------------
+      if cs_sync(1) = '1' then
+        state_reg          <= idle;
+        bits_processed_reg <= 0;
+      end if;
+    end if;
+  end process;
+
+  ----------------------------------------------------------
+  -- SPI interface, MISO released while not selected since the
+  -- bus is shared with the Arducam
+  ----------------------------------------------------------
+  miso <= shift_out_reg(15) when cs_n = '0' else 'Z';
+  ----------------------------------------------------------
+  -- User interface
+  ----------------------------------------------------------
+  -- Master writes
+  data_valid       <= data_valid_reg;
+  data_from_master <= data_from_master_reg;
+  -- Master reads
+  read_req         <= read_req_reg;
+end architecture arch;
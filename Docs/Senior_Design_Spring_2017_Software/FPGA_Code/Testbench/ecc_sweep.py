@@ -0,0 +1,256 @@
+#!/usr/bin/env python
+"""Sweep word size, PE count, scalar recoding and memory arbitration of the FPGA ECC core with GHDL.
+
+Runs tb_ecc_mult.vhd for G_W in 16/32/64 and G_PE in 1/2/4/8 and prints a table
+of cycles per Montgomery multiplication and per P-192 point multiplication
+(full length scalar), so the core configuration can be picked from numbers.
+--out also writes the table to a file, to be committed next to the testbench
+with the configuration change it supports.
+
+--modes ladder,naf also runs the NAF scheduler (G_NAF). The spread column is
+max - min point cycles over the three 192-bit test scalars:
+  ladder  one addition and one doubling per bit for any k, spread 0. Timing
+          and the operation sequence only reveal the bit length of k.
+  naf     doubling per bit, addition (plus Py negation for a -1 digit) only for
+          nonzero NAF digits, about 1/3 of the bits. Fewer field multiplications,
+          but the sequence of additions spells out the NAF of k on a single
+          power trace (SPA) and the total time depends on its weight. Acceptable
+          for the fixed node key only if the board is not exposed to probing.
+
+--mem shared,split also runs the operand-bank partitioning of Mem_Ctrl_LW (G_SPLIT),
+where the MAS half of a combined MMM + MAS instruction runs while the multiplier
+holds the memory. The stall columns are the Mem_Ctrl_LW counters for the full
+length scalar: cycles MAS and MMM waited for the memory (MAS also counts the
+cycles it was held for a port). saved is the point cycles gained over the shared
+lock with the same G_W, G_PE and mode.
+
+--compare runs tb_ecc_compare.vhd instead: the ladder with the shared lock
+against the NAF scheduler (--compare naf) or the split banks (--compare split)
+on the edge-case scalars plus --random seeded random ones, X and Y have to be
+equal for every k. saved is the point cycles gained over the ladder summed over
+all scalars, mismatches the scalars whose results differ. The stall columns are
+the Mem_Ctrl_LW mas/mmm stall counters summed over all scalars, before (ladder,
+shared) -> after.
+
+usage: python ecc_sweep.py [--clock-mhz 20] [--ghdl ghdl] [--widths 16,32,64] [--pes 1,2,4,8]
+                           [--modes ladder,naf] [--mem shared,split] [--out results.txt]
+       python ecc_sweep.py --compare naf|split [--random 16] [--seed 1] [--widths 16] [--pes 2]
+"""
+
+from __future__ import print_function
+
+import argparse
+import glob
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ECC_DIR = os.path.join(HERE, '..', 'ECC')
+TB = os.path.join(HERE, 'tb_ecc_mult.vhd')
+TB_COMPARE = os.path.join(HERE, 'tb_ecc_compare.vhd')
+
+# G_N follows from the word size, see the address map in Mem_Ctrl_LW.vhd
+G_N = {16: 5, 32: 4, 64: 3}
+
+GHDL_FLAGS = ['--std=08', '-fsynopsys']
+
+BENCH_LINE = re.compile(r'ECC_BENCH G_W=(\d+) G_PE=(\d+) mode=(\w+) mem=(\w+) vector=(\d+) point_cycles=(\d+) '
+                        r'mmm_count=(\d+) mmm_cycles=(\d+) mas_busy=(\d+) mas_stall=(\d+) '
+                        r'mmm_busy=(\d+) mmm_stall=(\d+) status=(\w+)')
+COMPARE_LINE = re.compile(r'ECC_COMPARE G_W=\d+ G_PE=\d+ naf=\w+ split=\w+ k=([0-9A-F]+) .* status=(\w+)')
+COMPARE_SUM = re.compile(r'ECC_COMPARE_SUM G_W=\d+ G_PE=\d+ naf=\w+ split=\w+ scalars=(\d+) ref_cycles=(\d+) '
+                         r'dut_cycles=(\d+) ref_mas_stall=(\d+) ref_mmm_stall=(\d+) dut_mas_stall=(\d+) '
+                         r'dut_mmm_stall=(\d+) saved_permille=(-?\d+) errors=(\d+)')
+
+# tb_ecc_mult vectors with a 192-bit scalar
+FULL_VECTORS = (0, 2, 3)
+
+
+class Tee(object):
+    """stdout that also goes to the --out file"""
+
+    def __init__(self, path):
+        self.file = open(path, 'w')
+        self.stdout = sys.stdout
+
+    def write(self, text):
+        self.stdout.write(text)
+        self.file.write(text)
+
+    def flush(self):
+        self.stdout.flush()
+        self.file.flush()
+
+
+def sources():
+    # std_logic_1164_additions belongs to ieee_proposed and is not used by the core
+    files = [f for f in glob.glob(os.path.join(ECC_DIR, '*.vhd'))
+             if not f.endswith('std_logic_1164_additions.vhd')]
+    return sorted(files) + [TB, TB_COMPARE]
+
+
+def build(ghdl, workdir):
+    flags = GHDL_FLAGS + ['--workdir=' + workdir]
+    subprocess.check_call([ghdl, '-i'] + flags + sources())
+    subprocess.check_call([ghdl, '-m'] + flags + ['tb_ecc_mult'])
+    subprocess.check_call([ghdl, '-m'] + flags + ['tb_ecc_compare'])
+
+
+def simulate(ghdl, workdir, generics, top, timeout):
+    cmd = [ghdl, '--elab-run'] + GHDL_FLAGS + ['--workdir=' + workdir] + generics + [top]
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, cwd=workdir)
+    try:
+        out, _ = proc.communicate(timeout=timeout) if sys.version_info[0] >= 3 else proc.communicate()
+    except subprocess.TimeoutExpired:
+        proc.kill()
+        proc.communicate()
+        return None
+    return out.decode('utf-8', 'replace')
+
+
+def last_line(out):
+    # elaboration error or a configuration the datapath does not support
+    last = [l for l in out.splitlines() if l.strip()]
+    return last[-1] if last else 'no output'
+
+
+def run(ghdl, workdir, width, pe, mode, mem, timeout):
+    out = simulate(ghdl, workdir, ['-gG_N=%d' % G_N[width], '-gG_W=%d' % width, '-gG_PE=%d' % pe,
+                                   '-gG_NAF=%s' % ('true' if mode == 'naf' else 'false'),
+                                   '-gG_SPLIT=%s' % ('true' if mem == 'split' else 'false')],
+                   'tb_ecc_mult', timeout)
+    if out is None:
+        return None, 'timeout'
+
+    vectors = {}
+    for m in BENCH_LINE.finditer(out):
+        vectors[int(m.group(5))] = {
+            'point_cycles': int(m.group(6)),
+            'mmm_count': int(m.group(7)),
+            'mmm_cycles': int(m.group(8)),
+            'mas_stall': int(m.group(10)),
+            'mmm_stall': int(m.group(12)),
+            'status': m.group(13),
+        }
+    if not vectors:
+        return None, last_line(out)
+    if any(v['status'] != 'PASS' for v in vectors.values()):
+        return vectors, 'FAIL'
+    return vectors, 'PASS'
+
+
+def compare(ghdl, workdir, width, pe, against, n_random, seed, timeout):
+    out = simulate(ghdl, workdir, ['-gG_N=%d' % G_N[width], '-gG_W=%d' % width, '-gG_PE=%d' % pe,
+                                   '-gG_NAF=%s' % ('true' if against == 'naf' else 'false'),
+                                   '-gG_SPLIT=%s' % ('true' if against == 'split' else 'false'),
+                                   '-gN_RANDOM=%d' % n_random,
+                                   '-gSEED1=%d' % seed, '-gSEED2=%d' % (seed + 1)],
+                   'tb_ecc_compare', timeout)
+    if out is None:
+        return None, 'timeout'
+    m = COMPARE_SUM.search(out)
+    if not m:
+        return None, last_line(out)
+    for line in COMPARE_LINE.finditer(out):
+        if line.group(2) != 'PASS':
+            print('  k=%s results differ from the ladder' % line.group(1))
+    result = {
+        'scalars': int(m.group(1)),
+        'ref_cycles': int(m.group(2)),
+        'dut_cycles': int(m.group(3)),
+        'ref_mas_stall': int(m.group(4)),
+        'ref_mmm_stall': int(m.group(5)),
+        'dut_mas_stall': int(m.group(6)),
+        'dut_mmm_stall': int(m.group(7)),
+        'errors': int(m.group(9)),
+    }
+    return result, 'FAIL' if result['errors'] else 'PASS'
+
+
+def compare_table(args, widths, pes, workdir):
+    row = '%4s %4s %8s %14s %14s %7s %19s %19s %10s  %s'
+    print(row % ('G_W', 'G_PE', 'scalars', 'ladder cyc', args.compare + ' cyc', 'saved',
+                 'mas_stall', 'mmm_stall', 'mismatches', 'result'))
+    for width in widths:
+        for pe in pes:
+            if width % pe:
+                print(row % (width, pe, '-', '-', '-', '-', '-', '-', '-', 'skipped, G_W not a multiple of G_PE'))
+                continue
+            r, status = compare(args.ghdl, workdir, width, pe, args.compare, args.random, args.seed, args.timeout)
+            if r is None:
+                print(row % (width, pe, '-', '-', '-', '-', '-', '-', '-', status))
+                continue
+            saved = 100.0 * (r['ref_cycles'] - r['dut_cycles']) / r['ref_cycles']
+            print(row % (width, pe, r['scalars'], r['ref_cycles'] // r['scalars'],
+                         r['dut_cycles'] // r['scalars'], '%.1f%%' % saved,
+                         '%d -> %d' % (r['ref_mas_stall'], r['dut_mas_stall']),
+                         '%d -> %d' % (r['ref_mmm_stall'], r['dut_mmm_stall']), r['errors'], status))
+            sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='GHDL sweep of the ECC core configuration')
+    parser.add_argument('--ghdl', default='ghdl')
+    parser.add_argument('--clock-mhz', type=float, default=20.0, help='FPGA clock for the time column')
+    parser.add_argument('--widths', default='16,32,64')
+    parser.add_argument('--pes', default='1,2,4,8')
+    parser.add_argument('--modes', default='ladder', help='ladder, naf or both')
+    parser.add_argument('--mem', default='shared', help='shared, split or both')
+    parser.add_argument('--timeout', type=int, default=3600, help='seconds per configuration')
+    parser.add_argument('--compare', choices=('naf', 'split'), help='check naf or split against the ladder')
+    parser.add_argument('--random', type=int, default=16, help='random scalars for --compare')
+    parser.add_argument('--seed', type=int, default=1, help='seed of the random scalars for --compare')
+    parser.add_argument('--out', help='also write the table to this file')
+    args = parser.parse_args()
+    if args.out:
+        sys.stdout = Tee(args.out)
+
+    widths = [int(w) for w in args.widths.split(',')]
+    pes = [int(p) for p in args.pes.split(',')]
+    modes = args.modes.split(',')
+    mems = args.mem.split(',')
+
+    workdir = tempfile.mkdtemp(prefix='ecc_sweep_')
+    try:
+        build(args.ghdl, workdir)
+        if args.compare:
+            compare_table(args, widths, pes, workdir)
+            return
+
+        row = '%4s %4s %6s %6s %12s %10s %14s %10s %8s %9s %9s %7s  %s'
+        print(row % ('G_W', 'G_PE', 'mode', 'mem', 'cyc/fieldmul', 'fieldmuls', 'cyc/pointmul', 'ms', 'spread',
+                     'mas_stall', 'mmm_stall', 'saved', 'result'))
+        for width in widths:
+            for pe in pes:
+                for mode in modes:
+                    shared_cycles = None
+                    for mem in mems:
+                        if width % pe:
+                            print(row % (width, pe, mode, mem, '-', '-', '-', '-', '-', '-', '-', '-',
+                                         'skipped, G_W not a multiple of G_PE'))
+                            continue
+                        vectors, status = run(args.ghdl, workdir, width, pe, mode, mem, args.timeout)
+                        if vectors is None or 0 not in vectors:
+                            print(row % (width, pe, mode, mem, '-', '-', '-', '-', '-', '-', '-', '-', status))
+                            continue
+                        v = vectors[0]  # full length scalar
+                        full = [vectors[i]['point_cycles'] for i in FULL_VECTORS if i in vectors]
+                        if mem == 'shared':
+                            shared_cycles = v['point_cycles']
+                        saved = '-'
+                        if mem != 'shared' and shared_cycles:
+                            saved = '%.1f%%' % (100.0 * (shared_cycles - v['point_cycles']) / shared_cycles)
+                        print(row % (width, pe, mode, mem, v['mmm_cycles'], v['mmm_count'], v['point_cycles'],
+                                     '%.2f' % (v['point_cycles'] / (args.clock_mhz * 1000.0)),
+                                     max(full) - min(full), v['mas_stall'], v['mmm_stall'], saved, status))
+                        sys.stdout.flush()
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    main()
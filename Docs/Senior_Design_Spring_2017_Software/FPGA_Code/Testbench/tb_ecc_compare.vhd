@@ -0,0 +1,319 @@
+----------------------------------------------------------------------------------
+-- Differential testbench for the scheduler modes of ECC_Mult_Wrapper. Two cores
+-- are built side by side from the same sources:
+--   ref : Montgomery ladder (G_NAF false), the configuration Top.vhd ships
+--   dut : the configuration under test, G_NAF and G_SPLIT of this testbench
+-- Both load the NIST P-192 field and curve the way Intermediate.vhd does and
+-- compute kG for the same scalars, one core after the other: a few edge cases
+-- and N_RANDOM random 192-bit scalars below the group order (SEED1 / SEED2 of
+-- ieee.math_real.uniform). X and Y of the dut have to equal the ref result.
+-- Every scalar gives one line starting with "ECC_COMPARE" with the point cycles
+-- and the Mem_Ctrl_LW mas/mmm stall counters of both cores, the run ends with
+-- an "ECC_COMPARE_SUM" line with the totals and the cycles the dut saved.
+-- ecc_sweep.py --compare naf / --compare split runs it.
+--
+-- G_N has to match G_W (Mem_Ctrl_LW address map), as in tb_ecc_mult.vhd.
+----------------------------------------------------------------------------------
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use IEEE.MATH_REAL.ALL;
+
+entity tb_ecc_compare is
+	generic (
+		G_N 				: integer  := 5;
+		G_W 				: integer  := 16;
+		G_PE 				: integer  := 2;
+		G_NAF 				: boolean  := true;
+		G_SPLIT 			: boolean  := false;
+		N_RANDOM 			: integer  := 16;
+		SEED1 				: positive := 1;
+		SEED2 				: positive := 2
+	);
+end tb_ecc_compare;
+
+architecture sim of tb_ecc_compare is
+
+	constant CLK_PERIOD 	: time    := 50 ns;
+	constant WORDS 			: integer := 192 / G_W;
+	constant REF 			: integer := 0;
+	constant DUT 			: integer := 1;
+
+	subtype field_t is std_logic_vector(191 downto 0);
+	subtype word_t is std_logic_vector(G_W-1 downto 0);
+	type word_array is array (REF to DUT) of word_t;
+	type stats_array is array (REF to DUT) of std_logic_vector(191 downto 0);
+
+	constant P 				: field_t := x"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF";
+	constant R2 			: field_t := x"000000000000000100000000000000020000000000000001";
+	constant A 				: field_t := x"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFC";
+	constant GX 			: field_t := x"188DA80EB03090F67CBF20EB43A18800F4FF0AFD82FF1012";
+	constant GY 			: field_t := x"07192B95FFC8DA78631011ED6B24CDD573F977A11E794811";
+	constant ORDER 			: field_t := x"FFFFFFFFFFFFFFFFFFFFFFFF99DEF836146BC9B1B4D22831";
+
+	type field_array is array (natural range <>) of field_t;
+	constant EDGE_SCALARS : field_array := (
+		x"000000000000000000000000000000000000000000000001",
+		x"000000000000000000000000000000000000000000000005",	-- node key
+		x"FFFFFFFFFFFFFFFFFFFFFFFF99DEF836146BC9B1B4D22830",	-- n - 1
+		x"AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA",	-- NAF = binary expansion
+		x"7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"	-- long carry runs in the NAF
+	);
+
+	signal clk 				: std_logic := '0';
+	signal rstn 			: std_logic := '0';
+	signal sim_done 		: boolean   := false;
+	signal cycle 			: integer   := 0;
+
+	signal start 			: std_logic_vector(REF to DUT) := (others => '0');
+	signal init_field 		: std_logic_vector(REF to DUT) := (others => '0');
+	signal init_curve 		: std_logic_vector(REF to DUT) := (others => '0');
+	signal di_valid 		: std_logic_vector(REF to DUT) := (others => '0');
+	signal di_data 			: word_array := (others => (others => '0'));
+	signal do_ready 		: std_logic_vector(REF to DUT) := (others => '0');
+	signal busy 			: std_logic_vector(REF to DUT);
+	signal di_ready 		: std_logic_vector(REF to DUT);
+	signal do_valid 		: std_logic_vector(REF to DUT);
+	signal do_data 			: word_array;
+	signal stats 			: stats_array;
+
+	-- counter i of the stats port of core u: MAS busy/stall, MMM busy/stall, MC busy/stall
+	impure function counter(u, i : integer) return integer is
+	begin
+		return to_integer(unsigned(stats(u)(32 * i + 30 downto 32 * i)));
+	end function;
+
+	-- word i of v, least significant word first
+	function word(v : field_t; i : integer) return std_logic_vector is
+	begin
+		return v((i + 1) * G_W - 1 downto i * G_W);
+	end function;
+
+BEGIN
+
+clk <= not clk after CLK_PERIOD / 2 when not sim_done else '0';
+
+process (clk)
+begin
+	if rising_edge(clk) then
+		cycle <= cycle + 1;
+	end if;
+end process;
+
+ref_core: entity work.ECC_Mult_Wrapper
+	generic map (
+		G_N 						=> G_N,
+		G_W 						=> G_W,
+		G_PE 						=> G_PE,
+		G_NAF 						=> false,
+		G_SPLIT 					=> false
+	)
+	port map (
+		rstn 						=> rstn,
+		clk 						=> clk,
+		elgamal_calc 				=> '0',
+		start 						=> start(REF),
+		init_field 					=> init_field(REF),
+		init_curve 					=> init_curve(REF),
+		di_valid 					=> di_valid(REF),
+		di_data 					=> di_data(REF),
+		do_ready 					=> do_ready(REF),
+		busy 						=> busy(REF),
+		di_ready 					=> di_ready(REF),
+		do_valid 					=> do_valid(REF),
+		do_data 					=> do_data(REF),
+		stats 						=> stats(REF)
+	);
+
+dut_core: entity work.ECC_Mult_Wrapper
+	generic map (
+		G_N 						=> G_N,
+		G_W 						=> G_W,
+		G_PE 						=> G_PE,
+		G_NAF 						=> G_NAF,
+		G_SPLIT 					=> G_SPLIT
+	)
+	port map (
+		rstn 						=> rstn,
+		clk 						=> clk,
+		elgamal_calc 				=> '0',
+		start 						=> start(DUT),
+		init_field 					=> init_field(DUT),
+		init_curve 					=> init_curve(DUT),
+		di_valid 					=> di_valid(DUT),
+		di_data 					=> di_data(DUT),
+		do_ready 					=> do_ready(DUT),
+		busy 						=> busy(DUT),
+		di_ready 					=> di_ready(DUT),
+		do_valid 					=> do_valid(DUT),
+		do_data 					=> do_data(DUT),
+		stats 						=> stats(DUT)
+	);
+
+stimulus: process
+
+	variable errors, count : integer := 0;
+	variable total : integer_vector(REF to DUT) := (0, 0);
+	variable cycles : integer_vector(REF to DUT);
+	variable mas_stall, mmm_stall : integer_vector(REF to DUT);
+	variable mas_total, mmm_total : integer_vector(REF to DUT) := (0, 0);
+	variable x, y : field_array(REF to DUT);
+	variable k : field_t;
+	variable s1 : positive := SEED1;
+	variable s2 : positive := SEED2;
+	variable r : real;
+	variable status : string(1 to 4);
+
+	-- one word on the di handshake of core u: held until the core takes it
+	procedure put(u : integer; w : std_logic_vector(G_W-1 downto 0)) is
+	begin
+		di_data(u)  <= w;
+		di_valid(u) <= '1';
+		loop
+			wait until rising_edge(clk);
+			exit when di_ready(u) = '1';
+		end loop;
+	end procedure;
+
+	procedure put_field(u : integer; v : field_t) is
+	begin
+		for i in 0 to WORDS - 1 loop
+			put(u, word(v, i));
+		end loop;
+	end procedure;
+
+	procedure wait_idle(u : integer) is
+	begin
+		if busy(u) /= '0' then
+			wait until busy(u) = '0';
+		end if;
+		wait until rising_edge(clk);
+	end procedure;
+
+	-- field and curve, as in tb_ecc_mult.vhd
+	procedure load_curve(u : integer) is
+	begin
+		init_field(u) <= '1';
+		wait until rising_edge(clk);
+		init_field(u) <= '0';
+		put(u, std_logic_vector(to_unsigned(0, G_W)));
+		put_field(u, P);
+		put_field(u, R2);
+		init_curve(u) <= '1';
+		put(u, word(A, 0));
+		init_curve(u) <= '0';
+		for i in 1 to WORDS - 1 loop
+			put(u, word(A, i));
+		end loop;
+		di_valid(u) <= '0';
+		wait_idle(u);
+	end procedure;
+
+	-- kG on core u
+	procedure point_mult(u : integer; k : field_t) is
+		variable t_start : integer;
+	begin
+		t_start := cycle;
+		start(u) <= '1';
+		put_field(u, GX);
+		put_field(u, GY);
+		put_field(u, k);
+		di_valid(u) <= '0';
+		start(u)    <= '0';
+		do_ready(u) <= '1';
+		for i in 0 to 2 * WORDS - 1 loop
+			loop
+				wait until rising_edge(clk);
+				exit when do_valid(u) = '1';
+			end loop;
+			if i < WORDS then
+				x(u)((i + 1) * G_W - 1 downto i * G_W) := do_data(u);
+			else
+				y(u)((i - WORDS + 1) * G_W - 1 downto (i - WORDS) * G_W) := do_data(u);
+			end if;
+		end loop;
+		do_ready(u) <= '0';
+		cycles(u)    := cycle - t_start;
+		mas_stall(u) := counter(u, 1);
+		mmm_stall(u) := counter(u, 3);
+		wait_idle(u);
+	end procedure;
+
+	-- 192 random bits, brought below the group order
+	procedure random_scalar(k : out field_t) is
+		variable v : field_t;
+	begin
+		for i in 0 to 7 loop
+			uniform(s1, s2, r);
+			v(24 * i + 23 downto 24 * i) := std_logic_vector(to_unsigned(integer(trunc(r * 16777216.0)) mod 16777216, 24));
+		end loop;
+		if unsigned(v) >= unsigned(ORDER) then
+			v(191) := '0';
+		end if;
+		if unsigned(v) = 0 then
+			v(0) := '1';
+		end if;
+		k := v;
+	end procedure;
+
+begin
+	rstn <= '0';
+	wait for 10 * CLK_PERIOD;
+	wait until rising_edge(clk);
+	rstn <= '1';
+	wait for 10 * CLK_PERIOD;
+	wait until rising_edge(clk);
+
+	load_curve(REF);
+	load_curve(DUT);
+
+	for n in 0 to EDGE_SCALARS'length + N_RANDOM - 1 loop
+		if n < EDGE_SCALARS'length then
+			k := EDGE_SCALARS(n);
+		else
+			random_scalar(k);
+		end if;
+		point_mult(REF, k);
+		point_mult(DUT, k);
+
+		status := "PASS";
+		if x(DUT) /= x(REF) or y(DUT) /= y(REF) then
+			report "tb_ecc_compare: k = " & to_hstring(k) & " ref X = " & to_hstring(x(REF))
+				& " Y = " & to_hstring(y(REF)) & ", dut X = " & to_hstring(x(DUT))
+				& " Y = " & to_hstring(y(DUT)) severity error;
+			errors := errors + 1;
+			status := "FAIL";
+		end if;
+		report "ECC_COMPARE G_W=" & integer'image(G_W) & " G_PE=" & integer'image(G_PE)
+			& " naf=" & boolean'image(G_NAF) & " split=" & boolean'image(G_SPLIT) & " k=" & to_hstring(k)
+			& " ref_cycles=" & integer'image(cycles(REF))
+			& " dut_cycles=" & integer'image(cycles(DUT))
+			& " ref_mas_stall=" & integer'image(mas_stall(REF)) & " ref_mmm_stall=" & integer'image(mmm_stall(REF))
+			& " dut_mas_stall=" & integer'image(mas_stall(DUT)) & " dut_mmm_stall=" & integer'image(mmm_stall(DUT))
+			& " status=" & status;
+		for u in REF to DUT loop
+			total(u)     := total(u) + cycles(u);
+			mas_total(u) := mas_total(u) + mas_stall(u);
+			mmm_total(u) := mmm_total(u) + mmm_stall(u);
+		end loop;
+		count := count + 1;
+	end loop;
+
+	report "ECC_COMPARE_SUM G_W=" & integer'image(G_W) & " G_PE=" & integer'image(G_PE)
+		& " naf=" & boolean'image(G_NAF) & " split=" & boolean'image(G_SPLIT) & " scalars=" & integer'image(count)
+		& " ref_cycles=" & integer'image(total(REF))
+		& " dut_cycles=" & integer'image(total(DUT))
+		& " ref_mas_stall=" & integer'image(mas_total(REF)) & " ref_mmm_stall=" & integer'image(mmm_total(REF))
+		& " dut_mas_stall=" & integer'image(mas_total(DUT)) & " dut_mmm_stall=" & integer'image(mmm_total(DUT))
+		& " saved_permille=" & integer'image(1000 * (total(REF) - total(DUT)) / maximum(1, total(REF)))
+		& " errors=" & integer'image(errors);
+	if errors = 0 then
+		report "tb_ecc_compare: PASS";
+	else
+		report "tb_ecc_compare: FAIL, " & integer'image(errors) & " errors" severity failure;
+	end if;
+	sim_done <= true;
+	wait;
+end process;
+
+END sim;
@@ -0,0 +1,275 @@
+----------------------------------------------------------------------------------
+-- Self-checking testbench for ECC_Mult_Wrapper, used by ecc_sweep.py to compare
+-- word size and PE count of the Montgomery multiplier, the Montgomery ladder
+-- against the NAF scheduler (G_NAF), and the shared memory lock against the
+-- operand-bank partitioning of Mem_Ctrl_LW (G_SPLIT).
+-- Loads the NIST P-192 field and curve the same way Intermediate.vhd does, runs
+-- plain scalar multiplications kG (elgamal_calc low) and checks X and Y.
+-- For every vector it reports one line starting with "ECC_BENCH":
+--   point cycles : start asserted to last result word
+--   mmm cycles   : average Montgomery multiplication, mmm_start to mmm_done
+--                  of the MMM_LW instance (VHDL-2008 external names)
+--   mas/mmm busy   : Mem_Ctrl_LW counters, cycles holding the memory
+--   mas/mmm stall  : cycles waiting for it (or held for a port, G_SPLIT)
+-- Vectors 0, 2 and 3 are all 192-bit scalars: the ladder runs the same
+-- operation sequence for each, the NAF scheduler does not (mmm_count follows
+-- the NAF weight of k).
+--
+-- G_N has to match G_W (Mem_Ctrl_LW address map): 16 -> 5, 32 -> 4, 64 -> 3.
+-- R^2 mod p assumes R = 2^192, which holds for every G_W dividing 192.
+----------------------------------------------------------------------------------
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+entity tb_ecc_mult is
+	generic (
+		G_N 				: integer := 5;
+		G_W 				: integer := 16;
+		G_PE 				: integer := 2;
+		G_NAF 				: boolean := false;
+		G_SPLIT 			: boolean := false
+	);
+end tb_ecc_mult;
+
+architecture sim of tb_ecc_mult is
+
+	constant CLK_PERIOD 	: time    := 50 ns;
+	constant WORDS 			: integer := 192 / G_W;
+
+	subtype field_t is std_logic_vector(191 downto 0);
+	constant P 				: field_t := x"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF";
+	constant R2 			: field_t := x"000000000000000100000000000000020000000000000001";
+	constant A 				: field_t := x"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFC";
+	constant GX 			: field_t := x"188DA80EB03090F67CBF20EB43A18800F4FF0AFD82FF1012";
+	constant GY 			: field_t := x"07192B95FFC8DA78631011ED6B24CDD573F977A11E794811";
+
+	type vector_t is record
+		k, x, y : field_t;
+	end record;
+	type vector_array is array (natural range <>) of vector_t;
+	constant VECTORS : vector_array := (
+		-- full length scalar, timing is representative
+		(k => x"B6A3E4C2D8F1907A5C3E2B1D4F6A8C0E13579BDF2468ACE1",
+		 x => x"C43ADCE4C56D504C0F839480A63BDFB6F2F36F0F05433125",
+		 y => x"90BFA7A8DFAE0574D7C8248A77AE881F62E14C6850FE9FAD"),
+		-- k = 5, the node key the ElGamal scheduler uses
+		(k => x"000000000000000000000000000000000000000000000005",
+		 x => x"10BB8E9840049B183E078D9C300E1605590118EBDD7FF590",
+		 y => x"31361008476F917BADC9F836E62762BE312B72543CCEAEA1"),
+		-- lowest NAF weight for 192 bits
+		(k => x"800000000000000000000000000000000000000000000001",
+		 x => x"E9FACFE6C57B50C1EDE190B8B6F17C1499734ADB5EEBC3BD",
+		 y => x"5C25116F16E7DEDA2698FFC7472DFB0F5B1327273EB5F109"),
+		-- alternating bits, the NAF is the binary expansion
+		(k => x"AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA",
+		 x => x"5A3CB70FF147AFD5ECE0F1418C002BD0A64AA317F95B6699",
+		 y => x"9EE1CC4C0F8399B11D825972CA470B3C1A70188D89B2625A")
+	);
+
+	signal clk 				: std_logic := '0';
+	signal rstn 			: std_logic := '0';
+	signal sim_done 		: boolean   := false;
+
+	signal elgamal_calc 	: std_logic := '0';
+	signal start 			: std_logic := '0';
+	signal init_field 		: std_logic := '0';
+	signal init_curve 		: std_logic := '0';
+	signal di_valid 		: std_logic := '0';
+	signal di_data 			: std_logic_vector(G_W-1 downto 0) := (others => '0');
+	signal do_ready 		: std_logic := '0';
+	signal busy 			: std_logic;
+	signal di_ready 		: std_logic;
+	signal do_valid 		: std_logic;
+	signal do_data 			: std_logic_vector(G_W-1 downto 0);
+	signal stats 			: std_logic_vector(191 downto 0);
+
+	signal cycle 			: integer := 0;
+	signal mmm_busy_cycles 	: integer := 0;
+	signal mmm_count 		: integer := 0;
+
+	-- counter i of the stats port: MAS busy/stall, MMM busy/stall, MC busy/stall
+	impure function counter(i : integer) return integer is
+	begin
+		return to_integer(unsigned(stats(32 * i + 30 downto 32 * i)));
+	end function;
+
+	-- word i of v, least significant word first
+	function word(v : field_t; i : integer) return std_logic_vector is
+	begin
+		return v((i + 1) * G_W - 1 downto i * G_W);
+	end function;
+
+BEGIN
+
+clk <= not clk after CLK_PERIOD / 2 when not sim_done else '0';
+
+uut: entity work.ECC_Mult_Wrapper
+	generic map (
+		G_N 						=> G_N,
+		G_W 						=> G_W,
+		G_PE 						=> G_PE,
+		G_NAF 						=> G_NAF,
+		G_SPLIT 					=> G_SPLIT
+	)
+	port map (
+		rstn 						=> rstn,
+		clk 						=> clk,
+		elgamal_calc 				=> elgamal_calc,
+		start 						=> start,
+		init_field 					=> init_field,
+		init_curve 					=> init_curve,
+		di_valid 					=> di_valid,
+		di_data 					=> di_data,
+		do_ready 					=> do_ready,
+		busy 						=> busy,
+		di_ready 					=> di_ready,
+		do_valid 					=> do_valid,
+		do_data 					=> do_data,
+		stats 						=> stats
+	);
+
+-- cycles spent in Montgomery multiplications
+mmm_probe: process (clk)
+	alias mmm_start is << signal .tb_ecc_mult.uut.uut.mmm_start : std_logic >>;
+	alias mmm_done  is << signal .tb_ecc_mult.uut.uut.mmm_done  : std_logic >>;
+	variable running : boolean := false;
+begin
+	if rising_edge(clk) then
+		cycle <= cycle + 1;
+		if mmm_start = '1' then
+			running := true;
+			mmm_count <= mmm_count + 1;
+		end if;
+		if running then
+			mmm_busy_cycles <= mmm_busy_cycles + 1;
+		end if;
+		if mmm_done = '1' then
+			running := false;
+		end if;
+	end if;
+end process;
+
+stimulus: process
+
+	variable errors : integer := 0;
+	variable t_start, mmm_cycles0, mmm_count0 : integer;
+	variable x, y : field_t;
+	variable status : string(1 to 4);
+	variable mode : string(1 to 6);
+	variable mem : string(1 to 6);
+
+	-- one word on the di handshake: held until the core takes it
+	procedure put(w : std_logic_vector(G_W-1 downto 0)) is
+	begin
+		di_data  <= w;
+		di_valid <= '1';
+		loop
+			wait until rising_edge(clk);
+			exit when di_ready = '1';
+		end loop;
+	end procedure;
+
+	procedure put_field(v : field_t) is
+	begin
+		for i in 0 to WORDS - 1 loop
+			put(word(v, i));
+		end loop;
+	end procedure;
+
+begin
+	rstn <= '0';
+	wait for 10 * CLK_PERIOD;
+	wait until rising_edge(clk);
+	rstn <= '1';
+	wait for 10 * CLK_PERIOD;
+	wait until rising_edge(clk);
+
+	-- field: size code, p, R^2 mod p. The core leaves LOAD_FIELD_DATA_2 on a
+	-- word it does not take, so di_valid stays high into the curve upload
+	init_field <= '1';
+	wait until rising_edge(clk);
+	init_field <= '0';
+	put(std_logic_vector(to_unsigned(0, G_W)));
+	put_field(P);
+	put_field(R2);
+	-- curve: init_curve held until the first word of a is taken
+	init_curve <= '1';
+	put(word(A, 0));
+	init_curve <= '0';
+	for i in 1 to WORDS - 1 loop
+		put(word(A, i));
+	end loop;
+	di_valid <= '0';
+	if busy /= '0' then
+		wait until busy = '0';
+	end if;
+	wait until rising_edge(clk);
+
+	for v in VECTORS'range loop
+		t_start     := cycle;
+		mmm_cycles0 := mmm_busy_cycles;
+		mmm_count0  := mmm_count;
+		start <= '1';
+		put_field(GX);
+		put_field(GY);
+		put_field(VECTORS(v).k);
+		di_valid <= '0';
+		start    <= '0';
+		do_ready <= '1';
+		for i in 0 to 2 * WORDS - 1 loop
+			loop
+				wait until rising_edge(clk);
+				exit when do_valid = '1';
+			end loop;
+			if i < WORDS then
+				x((i + 1) * G_W - 1 downto i * G_W) := do_data;
+			else
+				y((i - WORDS + 1) * G_W - 1 downto (i - WORDS) * G_W) := do_data;
+			end if;
+		end loop;
+		do_ready <= '0';
+
+		status := "PASS";
+		if x /= VECTORS(v).x or y /= VECTORS(v).y then
+			report "tb_ecc_mult: vector " & integer'image(v) & " wrong, got X = "
+				& to_hstring(x) & " Y = " & to_hstring(y) severity error;
+			errors := errors + 1;
+			status := "FAIL";
+		end if;
+		if G_NAF then
+			mode := "naf   ";
+		else
+			mode := "ladder";
+		end if;
+		if G_SPLIT then
+			mem := "split ";
+		else
+			mem := "shared";
+		end if;
+		report "ECC_BENCH G_W=" & integer'image(G_W) & " G_PE=" & integer'image(G_PE)
+			& " mode=" & mode & " mem=" & mem
+			& " vector=" & integer'image(v)
+			& " point_cycles=" & integer'image(cycle - t_start)
+			& " mmm_count=" & integer'image(mmm_count - mmm_count0)
+			& " mmm_cycles=" & integer'image((mmm_busy_cycles - mmm_cycles0) / maximum(1, mmm_count - mmm_count0))
+			& " mas_busy=" & integer'image(counter(0)) & " mas_stall=" & integer'image(counter(1))
+			& " mmm_busy=" & integer'image(counter(2)) & " mmm_stall=" & integer'image(counter(3))
+			& " status=" & status;
+
+		if busy /= '0' then
+			wait until busy = '0';
+		end if;
+		wait until rising_edge(clk);
+	end loop;
+
+	if errors = 0 then
+		report "tb_ecc_mult: PASS";
+	else
+		report "tb_ecc_mult: FAIL, " & integer'image(errors) & " errors" severity failure;
+	end if;
+	sim_done <= true;
+	wait;
+end process;
+
+END sim;
@@ -0,0 +1,376 @@
+----------------------------------------------------------------------------------
+-- Testbench for the two host link front-ends, I2C_slave and SPI_slave.
+-- Streams one rekey operand set (start word + 24 R words + 24 C words) into each
+-- front-end, reads 24 result words back, checks every word against the host model
+-- and reports the transfer time for each link speed.
+--
+-- ghdl -a "../I2C Unit/debounce.vhd" "../I2C Unit/I2C_slave.vhd" "../SPI Unit/SPI_slave.vhd" tb_host_interface.vhd
+-- ghdl -e tb_host_interface
+-- ghdl -r tb_host_interface
+----------------------------------------------------------------------------------
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+-- Stand-in for Intermediate.vhd: checks the words written by the master and
+-- answers read requests one cycle later, the way the Intermediate does
+entity tb_host_model is
+port(
+		clk 				: in    std_logic;
+		clear 				: in    std_logic;
+		read_req 			: in    std_logic;
+		data_valid 			: in    std_logic;
+		data_from_master 	: in    std_logic_vector(15 downto 0);
+		data_to_master 		: out   std_logic_vector(15 downto 0);
+		rx_count 			: out   integer;
+		rx_errors 			: out   integer
+	);
+end tb_host_model;
+
+architecture sim of tb_host_model is
+begin
+	process (clk)
+		variable rx, tx, err : integer := 0;
+	begin
+		if rising_edge(clk) then
+			if clear = '1' then
+				rx  := 0;
+				tx  := 0;
+				err := 0;
+			else
+				if data_valid = '1' then
+					if data_from_master /= std_logic_vector(to_unsigned((16#1234# + rx * 16#0F1D#) mod 65536, 16)) then
+						err := err + 1;
+					end if;
+					rx := rx + 1;
+				end if;
+				if read_req = '1' then
+					data_to_master <= std_logic_vector(to_unsigned((16#ABCD# + tx * 16#1357#) mod 65536, 16));
+					tx := tx + 1;
+				end if;
+			end if;
+			rx_count  <= rx;
+			rx_errors <= err;
+		end if;
+	end process;
+end sim;
+
+----------------------------------------------------------------------------------
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+entity tb_host_interface is
+end tb_host_interface;
+
+architecture sim of tb_host_interface is
+
+	constant CLK_PERIOD 	: time    := 50 ns;  -- 20 MHz
+	constant WRITE_WORDS 	: integer := 49;     -- start word + R + C
+	constant READ_WORDS 	: integer := 24;     -- result X || Y
+
+	signal clk 				: std_logic := '0';
+	signal rst 				: std_logic := '0';
+	signal sim_done 		: boolean   := false;
+	signal clear 			: std_logic := '0';
+
+	-- I2C bus, open drain with pull-ups
+	signal scl, sda 		: std_logic;
+	signal scl_m, sda_m 	: std_logic := 'Z';
+	-- SPI bus
+	signal sclk 			: std_logic := '0';
+	signal mosi 			: std_logic := '0';
+	signal miso 			: std_logic;
+	signal cs_n 			: std_logic := '1';
+
+	signal i2c_read_req, i2c_data_valid 		: std_logic;
+	signal i2c_to_master, i2c_from_master 		: std_logic_vector(15 downto 0);
+	signal i2c_rx_count, i2c_rx_errors 			: integer;
+	signal spi_read_req, spi_data_valid 		: std_logic;
+	signal spi_to_master, spi_from_master 		: std_logic_vector(15 downto 0);
+	signal spi_rx_count, spi_rx_errors 			: integer;
+
+	function write_word(k : integer) return std_logic_vector is
+	begin
+		return std_logic_vector(to_unsigned((16#1234# + k * 16#0F1D#) mod 65536, 16));
+	end function;
+
+	function read_word(k : integer) return std_logic_vector is
+	begin
+		return std_logic_vector(to_unsigned((16#ABCD# + k * 16#1357#) mod 65536, 16));
+	end function;
+
+BEGIN
+
+clk <= not clk after CLK_PERIOD / 2 when not sim_done else '0';
+
+scl <= 'H';
+sda <= 'H';
+scl <= scl_m;
+sda <= sda_m;
+
+I2C: ENTITY work.I2C_slave(arch)
+	 GENERIC MAP (SLAVE_ADDR => "0000011")
+	 PORT MAP(
+				clk 			 			=> clk,
+				rst 			 			=> rst,
+				scl 			 			=> scl,
+				sda 			 			=> sda,
+				data_to_master   			=> i2c_to_master,
+				data_from_master 			=> i2c_from_master,
+				read_req 			 		=> i2c_read_req,
+				data_valid 		 			=> i2c_data_valid
+			);
+
+I2C_HOST: ENTITY work.tb_host_model(sim)
+	PORT MAP(
+				clk 						=> clk,
+				clear 						=> clear,
+				read_req 					=> i2c_read_req,
+				data_valid 					=> i2c_data_valid,
+				data_from_master 			=> i2c_from_master,
+				data_to_master 				=> i2c_to_master,
+				rx_count 					=> i2c_rx_count,
+				rx_errors 					=> i2c_rx_errors
+			);
+
+SPI: ENTITY work.SPI_slave(arch)
+	 PORT MAP(
+				clk 			 			=> clk,
+				rst 			 			=> rst,
+				sclk 			 			=> sclk,
+				mosi 			 			=> mosi,
+				miso 			 			=> miso,
+				cs_n 			 			=> cs_n,
+				data_to_master   			=> spi_to_master,
+				data_from_master 			=> spi_from_master,
+				read_req 			 		=> spi_read_req,
+				data_valid 		 			=> spi_data_valid
+			);
+
+SPI_HOST: ENTITY work.tb_host_model(sim)
+	PORT MAP(
+				clk 						=> clk,
+				clear 						=> clear,
+				read_req 					=> spi_read_req,
+				data_valid 					=> spi_data_valid,
+				data_from_master 			=> spi_from_master,
+				data_to_master 				=> spi_to_master,
+				rx_count 					=> spi_rx_count,
+				rx_errors 					=> spi_rx_errors
+			);
+
+stimulus: process
+
+	variable errors : integer := 0;
+
+	----------------------------------------------------------
+	-- I2C master, T is the SCL period
+	----------------------------------------------------------
+	procedure i2c_start(T : time) is
+	begin
+		sda_m <= 'Z';
+		scl_m <= 'Z';
+		wait for T / 4;
+		sda_m <= '0';
+		wait for T / 2;
+		scl_m <= '0';
+		wait for T / 4;
+	end procedure;
+
+	procedure i2c_stop(T : time) is
+	begin
+		sda_m <= '0';
+		wait for T / 4;
+		scl_m <= 'Z';
+		wait for T / 4;
+		sda_m <= 'Z';
+		wait for T / 2;
+	end procedure;
+
+	procedure i2c_write_byte(b : std_logic_vector(7 downto 0); T : time) is
+	begin
+		for i in 7 downto 0 loop
+			if b(i) = '1' then
+				sda_m <= 'Z';
+			else
+				sda_m <= '0';
+			end if;
+			wait for T / 4;
+			scl_m <= 'Z';
+			wait for T / 2;
+			scl_m <= '0';
+			wait for T / 4;
+		end loop;
+		-- acknowledge from the slave
+		sda_m <= 'Z';
+		wait for T / 4;
+		scl_m <= 'Z';
+		wait for T / 4;
+		if to_X01(sda) /= '0' then
+			report "I2C: no acknowledge" severity error;
+			errors := errors + 1;
+		end if;
+		wait for T / 4;
+		scl_m <= '0';
+		wait for T / 4;
+	end procedure;
+
+	procedure i2c_read_byte(b : out std_logic_vector(7 downto 0); ack : boolean; T : time) is
+	begin
+		sda_m <= 'Z';
+		for i in 7 downto 0 loop
+			wait for T / 4;
+			scl_m <= 'Z';
+			wait for T / 4;
+			b(i) := to_X01(sda);
+			wait for T / 4;
+			scl_m <= '0';
+			wait for T / 4;
+		end loop;
+		if ack then
+			sda_m <= '0';
+		end if;
+		wait for T / 4;
+		scl_m <= 'Z';
+		wait for T / 2;
+		scl_m <= '0';
+		wait for T / 4;
+		sda_m <= 'Z';
+	end procedure;
+
+	procedure i2c_run(T : time; name : string) is
+		variable w : std_logic_vector(15 downto 0);
+		variable t0, t_write, t_read : time;
+	begin
+		clear <= '1';
+		wait until rising_edge(clk);
+		clear <= '0';
+		wait until rising_edge(clk);
+
+		-- operands, one transaction like writeI2C
+		t0 := now;
+		i2c_start(T);
+		i2c_write_byte("0000011" & '0', T);
+		for k in 0 to WRITE_WORDS - 1 loop
+			w := write_word(k);
+			i2c_write_byte(w(15 downto 8), T);
+			i2c_write_byte(w(7 downto 0), T);
+		end loop;
+		i2c_stop(T);
+		t_write := now - t0;
+
+		-- result, one burst like readBurstI2C
+		t0 := now;
+		i2c_start(T);
+		i2c_write_byte("0000011" & '1', T);
+		for k in 0 to READ_WORDS - 1 loop
+			i2c_read_byte(w(15 downto 8), true, T);
+			i2c_read_byte(w(7 downto 0), k /= READ_WORDS - 1, T);
+			if w /= read_word(k) then
+				report "I2C: result word " & integer'image(k) & " wrong" severity error;
+				errors := errors + 1;
+			end if;
+		end loop;
+		i2c_stop(T);
+		t_read := now - t0;
+
+		wait for 10 * CLK_PERIOD;
+		if i2c_rx_count /= WRITE_WORDS or i2c_rx_errors /= 0 then
+			report "I2C: " & integer'image(i2c_rx_count) & " words received, "
+				& integer'image(i2c_rx_errors) & " wrong" severity error;
+			errors := errors + 1;
+		end if;
+		report name & ": write " & time'image(t_write) & ", read " & time'image(t_read)
+			& ", total " & time'image(t_write + t_read);
+	end procedure;
+
+	----------------------------------------------------------
+	-- SPI master, mode 0, T is the SCLK period
+	----------------------------------------------------------
+	procedure spi_byte(b_out : std_logic_vector(7 downto 0); b_in : out std_logic_vector(7 downto 0); T : time) is
+	begin
+		for i in 7 downto 0 loop
+			mosi <= b_out(i);
+			wait for T / 2;
+			sclk <= '1';
+			b_in(i) := to_X01(miso);
+			wait for T / 2;
+			sclk <= '0';
+		end loop;
+	end procedure;
+
+	procedure spi_run(T : time; name : string) is
+		variable w, r : std_logic_vector(15 downto 0);
+		variable cmd : std_logic_vector(7 downto 0);
+		variable t0, t_write, t_read : time;
+	begin
+		clear <= '1';
+		wait until rising_edge(clk);
+		clear <= '0';
+		wait until rising_edge(clk);
+
+		-- operands
+		t0 := now;
+		cs_n <= '0';
+		wait for T;
+		spi_byte(x"57", cmd, T);
+		for k in 0 to WRITE_WORDS - 1 loop
+			w := write_word(k);
+			spi_byte(w(15 downto 8), r(15 downto 8), T);
+			spi_byte(w(7 downto 0), r(7 downto 0), T);
+		end loop;
+		wait for T;
+		cs_n <= '1';
+		wait for T;
+		t_write := now - t0;
+
+		-- result
+		t0 := now;
+		cs_n <= '0';
+		wait for T;
+		spi_byte(x"52", cmd, T);
+		for k in 0 to READ_WORDS - 1 loop
+			spi_byte(x"00", r(15 downto 8), T);
+			spi_byte(x"00", r(7 downto 0), T);
+			if r /= read_word(k) then
+				report "SPI: result word " & integer'image(k) & " wrong" severity error;
+				errors := errors + 1;
+			end if;
+		end loop;
+		wait for T;
+		cs_n <= '1';
+		wait for T;
+		t_read := now - t0;
+
+		wait for 10 * CLK_PERIOD;
+		if spi_rx_count /= WRITE_WORDS or spi_rx_errors /= 0 then
+			report "SPI: " & integer'image(spi_rx_count) & " words received, "
+				& integer'image(spi_rx_errors) & " wrong" severity error;
+			errors := errors + 1;
+		end if;
+		report name & ": write " & time'image(t_write) & ", read " & time'image(t_read)
+			& ", total " & time'image(t_write + t_read);
+	end procedure;
+
+begin
+	rst <= '0';
+	wait for 10 * CLK_PERIOD;
+	rst <= '1';
+	wait for 10 * CLK_PERIOD;
+
+	i2c_run(10 us, "I2C 100 kHz");
+	i2c_run(2.5 us, "I2C 400 kHz");
+	spi_run(1 us, "SPI 1 MHz");
+	spi_run(500 ns, "SPI 2 MHz");
+
+	if errors = 0 then
+		report "tb_host_interface: PASS";
+	else
+		report "tb_host_interface: FAIL, " & integer'image(errors) & " errors" severity failure;
+	end if;
+	sim_done <= true;
+	wait;
+end process;
+
+END sim;
@@ -0,0 +1,319 @@
+----------------------------------------------------------------------------------
+-- Benchmark for the persistent field/curve configuration in Intermediate.vhd.
+-- Runs three ElGamal requests (C - kR, k = 5 in the scheduler) through the
+-- Intermediate and the ECC core, with the host words spaced like the 100 kHz I2C link:
+--   1) cold    : compute command right after reset, waits for the parameter upload
+--   2) warm    : compute command, parameters still loaded
+--   3) reinit  : CMD_REINIT followed by a compute command
+--   4) queued  : two jobs back to back, the second one uploaded while the first computes
+--   5) P-256   : CMD_CURVE for P-256, parameters change, then again on P-256
+--   6) P-192   : CMD_CURVE back to P-192
+--   7) stats   : CMD_STATS, memory controller counters of the last job over the host link
+-- The done output (level mode) has to be high once a result is stored and low after it is read.
+-- Each result is checked against M and the setup cycles (command word to start of
+-- the core) and total cycles (command word to last result word) are reported.
+--
+-- R = 7G, M = 11G, C = M + 5R on P-192 and P-256, words least significant first, X then Y.
+-- The Intermediate is built with MAX_CURVE = 2 so its buffers take the P-256 jobs.
+--
+-- ghdl -i ../ECC/*.vhd ../Intermediate/Intermediate.vhd tb_intermediate_params.vhd
+-- ghdl -m tb_intermediate_params
+-- ghdl -r tb_intermediate_params
+----------------------------------------------------------------------------------
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+entity tb_intermediate_params is
+end tb_intermediate_params;
+
+architecture sim of tb_intermediate_params is
+
+	constant CLK_PERIOD 	: time    := 50 ns;  -- 20 MHz
+	constant WORD_GAP 		: integer := 3600;   -- clk cycles per 16-bit word at 100 kHz I2C (18 SCL periods)
+	constant CMD_COMPUTE 	: std_logic_vector(15 downto 0) := x"0000";
+	constant CMD_REINIT 	: std_logic_vector(15 downto 0) := x"0001";
+	constant CMD_P192 		: std_logic_vector(15 downto 0) := x"0100";
+	constant CMD_P256 		: std_logic_vector(15 downto 0) := x"0102";
+	constant CMD_STATS 		: std_logic_vector(15 downto 0) := x"0002";
+
+	type word_array is array (natural range <>) of std_logic_vector(15 downto 0);
+	constant R_WORDS : word_array(0 to 23) := (
+		x"FCFD", x"7011", x"7F00", x"5DE3", x"EDCE", x"3060", x"2324", x"60F9", x"CD76", x"75DD", x"5A1F", x"8DA7",
+		x"FFB5", x"6409", x"02F9", x"D4B7", x"C01D", x"FDB3", x"0DB8", x"1824", x"B354", x"6860", x"5FCF", x"57CB");
+	constant C_WORDS : word_array(0 to 23) := (
+		x"7277", x"28DE", x"2459", x"C744", x"2C19", x"3483", x"ED14", x"9357", x"E28E", x"8377", x"D017", x"33CF",
+		x"A5E4", x"27A9", x"4CCD", x"044B", x"E8E8", x"41F9", x"66CB", x"7452", x"395E", x"02A0", x"4607", x"DC81");
+	constant M_WORDS : word_array(0 to 23) := (
+		x"A2AA", x"0628", x"4037", x"2809", x"B652", x"4D22", x"F716", x"1844", x"324F", x"EB76", x"5995", x"1C99",
+		x"9C04", x"1AAA", x"B861", x"B34C", x"77BD", x"00FA", x"5564", x"029F", x"EB73", x"37E9", x"65CE", x"EF17");
+	constant R256_WORDS : word_array(0 to 31) := (
+		x"B2A3", x"3187", x"2870", x"3006", x"EF5B", x"A80F", x"F8B8", x"7EF9", x"FB60", x"7C01", x"3066", x"25BB", x"7B46", x"A0BF", x"3B6F", x"8E53",
+		x"00B4", x"C1F4", x"1A86", x"C55E", x"1B21", x"CB04", x"3633", x"53C7", x"9000", x"A6F5", x"9F83", x"6D06", x"1836", x"E033", x"1DBD", x"73EB");
+	constant C256_WORDS : word_array(0 to 31) := (
+		x"25F8", x"EB59", x"6293", x"12B4", x"3B06", x"7C4D", x"94F8", x"174E", x"B6A5", x"5B5E", x"AA1A", x"42CA", x"01FC", x"FEA7", x"852C", x"B1BB",
+		x"3CB0", x"8BDE", x"A1F9", x"783E", x"174F", x"09EF", x"978E", x"2075", x"E6CD", x"6FD1", x"7D20", x"4604", x"74CB", x"6C78", x"7DC6", x"1D33");
+	constant M256_WORDS : word_array(0 to 31) := (
+		x"21D1", x"74BC", x"91D3", x"4333", x"48BF", x"2550", x"2ED0", x"1674", x"1CDA", x"B0C2", x"379D", x"0638", x"4C59", x"883B", x"13B7", x"3ED1",
+		x"3740", x"E82A", x"EEFC", x"E2F8", x"89DA", x"5E98", x"04DA", x"090D", x"C68A", x"A4F4", x"43AF", x"24C8", x"C8A2", x"CCC4", x"209A", x"9099");
+
+	signal clk 				: std_logic := '0';
+	signal rst 				: std_logic := '0';
+	signal sim_done 		: boolean   := false;
+
+	signal Read_Req			: std_logic := '0';
+	signal Data_Valid  		: std_logic := '0';
+	signal Data_From_Master : std_logic_vector(15 downto 0) := (others => '0');
+	signal Data_To_Master	: std_logic_vector(15 downto 0);
+	signal Di_ready 		: std_logic;
+	signal Do_ready 		: std_logic;
+	signal Do_valid 		: std_logic;
+	signal Di_valid 		: std_logic;
+	signal Init_curve 		: std_logic;
+	signal Init_field 		: std_logic;
+	signal Start 			: std_logic;
+	signal Di_data 			: std_logic_vector(15 downto 0);
+	signal Do_data 			: std_logic_Vector(15 downto 0);
+	signal Elgamal_calc     : std_logic;
+	signal busy 			: std_logic;
+	signal Ecc_stats 		: std_logic_vector(191 downto 0);
+	signal done 			: std_logic;
+
+	signal cycle 			: integer := 0;
+	signal start_cycle 		: integer := 0;
+	signal start_prev 		: std_logic := '0';
+	signal results 			: integer := 0;  -- results stored by the Intermediate (falling do_ready)
+	signal do_ready_prev 	: std_logic := '0';
+
+BEGIN
+
+clk <= not clk after CLK_PERIOD / 2 when not sim_done else '0';
+
+Inter:ENTITY work.Intermediate(arch)
+	GENERIC MAP (MAX_CURVE => 2)
+	PORT MAP(
+                elgamal_calc                => Elgamal_calc,
+				clk 						=> clk,
+				rst 						=> rst,
+				read_req 					=> Read_Req,
+				data_valid 	    			=> Data_Valid,
+				data_from_master 			=> Data_From_Master,
+				data_to_master 				=> Data_To_Master,
+				di_ready 					=> Di_ready,
+				do_valid 					=> Do_valid,
+				do_data						=> Do_data,
+				di_data 					=> Di_data,
+				di_valid 					=> Di_valid,
+				do_ready 					=> Do_ready,
+				init_field 					=> Init_field,
+				init_curve 					=> Init_curve,
+				start 						=> Start,
+				ecc_stats 					=> Ecc_stats,
+				done 						=> done
+			);
+
+ECC:ENTITY work.ECC_Mult_Wrapper(structure)
+	PORT MAP(
+                elgamal_calc                => Elgamal_calc,
+				clk 						=> clk,
+				rstn 						=> rst,
+				busy						=> busy,
+				di_data 					=> Di_data,
+				do_data						=> Do_data,
+				di_valid 					=> Di_valid,
+				do_valid 					=> Do_valid,
+				do_ready 					=> Do_ready,
+				di_ready 					=> Di_ready,
+				init_field 					=> Init_field,
+				init_curve 					=> Init_curve,
+				start 						=> Start,
+				stats 						=> Ecc_stats
+			);
+
+-- cycle counter, the cycle the core was started in and the number of results stored
+process (clk)
+begin
+	if rising_edge(clk) then
+		cycle      <= cycle + 1;
+		start_prev <= Start;
+		if Start = '1' and start_prev = '0' then
+			start_cycle <= cycle;
+		end if;
+		do_ready_prev <= Do_ready;
+		if Do_ready = '0' and do_ready_prev = '1' then
+			results <= results + 1;
+		end if;
+	end if;
+end process;
+
+stimulus: process
+
+	variable errors : integer := 0;
+	variable t_queue : integer;
+	variable jobs : integer := 0;
+
+	procedure send_word(w : std_logic_vector(15 downto 0)) is
+	begin
+		Data_From_Master <= w;
+		Data_Valid       <= '1';
+		wait until rising_edge(clk);
+		Data_Valid       <= '0';
+		for i in 2 to WORD_GAP loop
+			wait until rising_edge(clk);
+		end loop;
+	end procedure;
+
+	procedure send_job(cmd : std_logic_vector(15 downto 0); r, c : word_array) is
+	begin
+		send_word(cmd);
+		for k in r'range loop
+			send_word(r(k));
+		end loop;
+		for k in c'range loop
+			send_word(c(k));
+		end loop;
+	end procedure;
+
+	procedure send_job is
+	begin
+		send_job(CMD_COMPUTE, R_WORDS, C_WORDS);
+	end procedure;
+
+	-- core finishes and hands the result words to the Intermediate
+	procedure wait_result is
+	begin
+		jobs := jobs + 1;
+		while results < jobs loop
+			wait until rising_edge(clk);
+		end loop;
+	end procedure;
+
+	-- done has to follow the result buffer within two cycles (registered output)
+	procedure check_done(name : string; expected : std_logic) is
+	begin
+		wait until rising_edge(clk);
+		wait until rising_edge(clk);
+		if done /= expected then
+			report name & ": done is " & std_logic'image(done) & ", expected "
+				& std_logic'image(expected) severity error;
+			errors := errors + 1;
+		end if;
+	end procedure;
+
+	-- one burst read, a read request per word plus the trailing one the front-ends issue
+	procedure read_result(name : string; m : word_array) is
+		variable w : std_logic_vector(15 downto 0);
+	begin
+		for k in 0 to m'length loop
+			Read_Req <= '1';
+			wait until rising_edge(clk);
+			Read_Req <= '0';
+			wait until rising_edge(clk);
+			w := Data_To_Master;
+			if k < m'length and w /= m(k) then
+				report name & ": result word " & integer'image(k) & " wrong" severity error;
+				errors := errors + 1;
+			end if;
+		end loop;
+	end procedure;
+
+	procedure read_result(name : string) is
+	begin
+		read_result(name, M_WORDS);
+	end procedure;
+
+	procedure request(name : string; reinit : boolean; cmd : std_logic_vector(15 downto 0);
+	                  r, c, m : word_array) is
+		variable t_cmd, setup, total : integer;
+	begin
+		t_cmd := cycle;
+		if reinit then
+			send_word(CMD_REINIT);
+		end if;
+		send_job(cmd, r, c);
+		setup := start_cycle - t_cmd;
+		wait_result;
+		check_done(name, '1');
+		read_result(name, m);
+		total := cycle - t_cmd;
+		check_done(name, '0');
+
+		report name & ": setup " & integer'image(setup) & " cycles, total "
+			& integer'image(total) & " cycles";
+	end procedure;
+
+	-- CMD_STATS and one burst of the 12 counter words, 32-bit counters low word first
+	procedure read_stats is
+		type counter_array is array (0 to 5) of integer;
+		variable w : std_logic_vector(15 downto 0);
+		variable lo : std_logic_vector(15 downto 0);
+		variable n : counter_array;
+	begin
+		send_word(CMD_STATS);
+		for k in 0 to 12 loop
+			Read_Req <= '1';
+			wait until rising_edge(clk);
+			Read_Req <= '0';
+			wait until rising_edge(clk);
+			w := Data_To_Master;
+			if k mod 2 = 0 then
+				lo := w;
+			elsif k < 12 then
+				n(k / 2) := to_integer(unsigned(w(14 downto 0) & lo));
+			end if;
+		end loop;
+		report "stats: MAS busy " & integer'image(n(0)) & " stall " & integer'image(n(1))
+			& ", MMM busy " & integer'image(n(2)) & " stall " & integer'image(n(3))
+			& ", MC busy " & integer'image(n(4)) & " stall " & integer'image(n(5));
+		if n(2) = 0 or n(0) = 0 then
+			report "stats: counters not running" severity error;
+			errors := errors + 1;
+		end if;
+	end procedure;
+
+begin
+	rst <= '0';
+	wait for 10 * CLK_PERIOD;
+	wait until rising_edge(clk);
+	rst <= '1';
+	wait until rising_edge(clk);
+
+	request("cold", false, CMD_COMPUTE, R_WORDS, C_WORDS, M_WORDS);
+	request("warm", false, CMD_COMPUTE, R_WORDS, C_WORDS, M_WORDS);
+	request("reinit", true, CMD_COMPUTE, R_WORDS, C_WORDS, M_WORDS);
+
+	-- queued: job B is uploaded while job A computes, result A is read while B computes
+	t_queue := cycle;
+	send_job;
+	send_job;
+	wait_result;
+	read_result("queued A");
+	wait_result;
+	read_result("queued B");
+	report "queued: 2 jobs in " & integer'image(cycle - t_queue) & " cycles";
+
+	-- curve selection: the first request of a curve uploads its parameters, the next one does not
+	request("P-256 switch", false, CMD_P256, R256_WORDS, C256_WORDS, M256_WORDS);
+	request("P-256 same", false, CMD_COMPUTE, R256_WORDS, C256_WORDS, M256_WORDS);
+	request("P-192 switch", false, CMD_P192, R_WORDS, C_WORDS, M_WORDS);
+
+	read_stats;
+
+	if errors = 0 then
+		report "tb_intermediate_params: PASS";
+	else
+		report "tb_intermediate_params: FAIL, " & integer'image(errors) & " errors" severity failure;
+	end if;
+	sim_done <= true;
+	wait;
+end process;
+
+-- watchdog
+process
+begin
+	wait until sim_done for 10 sec;
+	assert sim_done report "tb_intermediate_params: timeout" severity failure;
+	wait;
+end process;
+
+END sim;
@@ -6,12 +6,21 @@ library IEEE;
 use IEEE.STD_LOGIC_1164.ALL;
 
 entity Top is
+generic(
+		USE_SPI				: boolean := false; -- host link: false = I2C slave 0x03, true = SPI slave (mode 0)
+		DONE_PULSE			: boolean := false  -- done output: false = level until read out, true = pulse per result
+	);
 port(
 		scl 				: inout std_logic;
 		sda 				: inout std_logic;
+		sclk 				: in    std_logic;
+		mosi 				: in    std_logic;
+		miso 				: out   std_logic;
+		cs_n 				: in    std_logic;
 		clk 				: in    std_logic;
 		rst 				: in    std_logic;
-		busy				: out   std_logic
+		busy				: out   std_logic;
+		done				: out   std_logic   -- result ready in the Intermediate, host interrupt line
 	);
 end Top;
 
@@ -31,9 +40,12 @@ architecture RTL of Top is
 	signal Di_data 			: std_logic_vector(15 downto 0);
 	signal Do_data 			: std_logic_Vector(15 downto 0);
     signal Elgamal_calc     : std_logic;
+    signal Ecc_stats        : std_logic_vector(191 downto 0);
 
 BEGIN
 -- Port Mapping
+-- Host link, both front-ends present the same 16-bit interface to the Intermediate
+I2C_GEN: if not USE_SPI generate
 I2C: ENTITY work.I2C_slave(arch)
 	 GENERIC MAP (SLAVE_ADDR => "0000011")-- Making slave address equal to three. This can be changed.
 	 PORT MAP
@@ -47,8 +59,30 @@ I2C: ENTITY work.I2C_slave(arch)
 				read_req 			 		=> Read_Req,        -- -->
 				data_valid 		 			=> Data_Valid       -- -->
 			);
+	miso <= 'Z';
+end generate I2C_GEN;
+
+SPI_GEN: if USE_SPI generate
+SPI: ENTITY work.SPI_slave(arch)
+	 PORT MAP
+			(
+				clk 			 			=> clk,             -- <--
+				rst 			 			=> rst,             -- <--
+				sclk 			 			=> sclk,            -- <--
+				mosi 			 			=> mosi,            -- <--
+				miso 			 			=> miso,            -- -->
+				cs_n 			 			=> cs_n,            -- <--
+				data_to_master   			=> Data_To_Master,  -- <--
+				data_from_master 			=> Data_From_Master,-- -->
+				read_req 			 		=> Read_Req,        -- -->
+				data_valid 		 			=> Data_Valid       -- -->
+			);
+	scl <= 'Z';
+	sda <= 'Z';
+end generate SPI_GEN;
 			  
 Inter:ENTITY work.Intermediate(arch)
+	GENERIC MAP (DONE_PULSE => DONE_PULSE)
 	PORT MAP(
                 elgamal_calc                => Elgamal_calc,
                 --
@@ -68,7 +102,9 @@ Inter:ENTITY work.Intermediate(arch)
 				do_ready 					=> Do_ready,        -- -->
 				init_field 					=> Init_field,      -- -->
 				init_curve 					=> Init_curve,      -- -->
-				start 						=> Start            -- -->
+				start 						=> Start,           -- -->
+				ecc_stats 					=> Ecc_stats,       -- <--
+				done 						=> done             -- -->
 			);
 								
 ECC:ENTITY work.ECC_Mult_Wrapper(structure)
@@ -85,7 +121,8 @@ ECC:ENTITY work.ECC_Mult_Wrapper(structure)
 				di_ready 					=> Di_ready,        -- -->
 				init_field 					=> Init_field,		-- <--
 				init_curve 					=> Init_curve,		-- <--
-				start 						=> Start			-- <--
+				start 						=> Start,			-- <--
+				stats 						=> Ecc_stats		-- -->
 			);
 END RTL;
 
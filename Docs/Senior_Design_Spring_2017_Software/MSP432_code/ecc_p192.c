@@ -0,0 +1,553 @@
+/*
+ * ecc_p192.c
+ *
+ * Software NIST P-192 scalar multiplication and ElGamal decryption (C - kR)
+ * for the MSP432. This is the fallback for nodes that do not carry the
+ * Igloo nano ECC core, and the reference the FPGA results are checked against.
+ *
+ * Field arithmetic is done in the Montgomery domain (R = 2^192) on 32-bit
+ * limbs. The inner loops are all of the form hi:lo = a * b + c + d, which the
+ * Cortex-M4 compiler turns into a single UMAAL per limb. For
+ * p = 2^192 - 2^64 - 1 the Montgomery constant -p^-1 mod 2^32 is 1, so the
+ * reduction multiplier is just the low limb of the accumulator.
+ *
+ * The scalar multiplication is a Montgomery ladder in Jacobian coordinates.
+ * Every bit costs one addition and one doubling, the ladder registers are
+ * swapped with masks instead of branches, and the scalar is padded to a fixed
+ * 193 bits (k + n or k + 2n), so the run time does not depend on the key.
+ *
+ * Builds on the target (CCS) and on the host for the benchmark in host_sim/.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "ecc_p192.h"
+
+#define N_LIMBS P192_LIMBS
+
+typedef struct _p192_jacobian {
+	uint32_t x[N_LIMBS];
+	uint32_t y[N_LIMBS];
+	uint32_t z[N_LIMBS];
+} P192_JACOBIAN;
+
+/* p = 2^192 - 2^64 - 1 */
+static const uint32_t P192_P[N_LIMBS] = {
+	0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF
+};
+
+/* Order of the base point */
+static const uint32_t P192_N[N_LIMBS] = {
+	0xB4D22831, 0x146BC9B1, 0x99DEF836, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF
+};
+
+/* R^2 mod p, used to move values into the Montgomery domain */
+static const uint32_t P192_R2[N_LIMBS] = {
+	0x00000001, 0x00000000, 0x00000002, 0x00000000, 0x00000001, 0x00000000
+};
+
+/* 1 and the curve constant b, both in the Montgomery domain (a = -3 is implicit) */
+static const uint32_t P192_ONE_M[N_LIMBS] = {
+	0x00000001, 0x00000000, 0x00000001, 0x00000000, 0x00000000, 0x00000000
+};
+static const uint32_t P192_B_M[N_LIMBS] = {
+	0xA6E33A98, 0x62D9E406, 0x19076AE2, 0x7281CDB2, 0x57C0B131, 0x73C8EEC5
+};
+
+/* Exponent p - 2 for the Fermat inversion */
+static const uint32_t P192_P_MINUS_2[N_LIMBS] = {
+	0xFFFFFFFD, 0xFFFFFFFF, 0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF
+};
+
+/*
+ * Field arithmetic, all inputs and outputs fully reduced (< p)
+ */
+
+// r = a - p if that does not borrow (or the sum carried), else a -- without branching
+static void fe_reduce_once(uint32_t r[], const uint32_t a[], uint32_t carry) {
+	uint32_t s[N_LIMBS], mask;
+	uint64_t acc;
+	uint32_t borrow = 0;
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++) {
+		acc = (uint64_t)a[i] - P192_P[i] - borrow;
+		s[i] = (uint32_t)acc;
+		borrow = (uint32_t)(acc >> 32) & 1;
+	}
+
+	mask = 0 - (carry | (borrow ^ 1));	// all ones when the subtraction is kept
+	for(i = 0; i < N_LIMBS; i++)
+		r[i] = (s[i] & mask) | (a[i] & ~mask);
+}
+
+static void fe_add(uint32_t r[], const uint32_t a[], const uint32_t b[]) {
+	uint32_t t[N_LIMBS];
+	uint64_t acc = 0;
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++) {
+		acc = (uint64_t)a[i] + b[i] + (acc >> 32);
+		t[i] = (uint32_t)acc;
+	}
+	fe_reduce_once(r, t, (uint32_t)(acc >> 32));
+}
+
+static void fe_sub(uint32_t r[], const uint32_t a[], const uint32_t b[]) {
+	uint32_t t[N_LIMBS], mask;
+	uint64_t acc;
+	uint32_t borrow = 0;
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++) {
+		acc = (uint64_t)a[i] - b[i] - borrow;
+		t[i] = (uint32_t)acc;
+		borrow = (uint32_t)(acc >> 32) & 1;
+	}
+
+	mask = 0 - borrow;	// add p back when a < b
+	acc = 0;
+	for(i = 0; i < N_LIMBS; i++) {
+		acc = (uint64_t)t[i] + (P192_P[i] & mask) + (acc >> 32);
+		r[i] = (uint32_t)acc;
+	}
+}
+
+/* Montgomery multiplication r = a * b * 2^-192 mod p (CIOS)
+ * Both products in the loops are UMAAL shaped: a * b + t + carry never overflows 64 bits */
+static void fe_mul(uint32_t r[], const uint32_t a[], const uint32_t b[]) {
+	uint32_t t[N_LIMBS + 2];
+	uint32_t m;
+	uint64_t acc;
+	int i, j;
+
+	memset(t, 0, sizeof(t));
+
+	for(i = 0; i < N_LIMBS; i++) {
+		// t += a * b[i]
+		acc = 0;
+		for(j = 0; j < N_LIMBS; j++) {
+			acc = (uint64_t)a[j] * b[i] + t[j] + (acc >> 32);
+			t[j] = (uint32_t)acc;
+		}
+		acc = (uint64_t)t[N_LIMBS] + (acc >> 32);
+		t[N_LIMBS] = (uint32_t)acc;
+		t[N_LIMBS + 1] = (uint32_t)(acc >> 32);
+
+		// t = (t + m * p) / 2^32, with m = t[0] * (-p^-1 mod 2^32) = t[0]
+		m = t[0];
+		acc = (uint64_t)m * P192_P[0] + t[0];
+		for(j = 1; j < N_LIMBS; j++) {
+			acc = (uint64_t)m * P192_P[j] + t[j] + (acc >> 32);
+			t[j - 1] = (uint32_t)acc;
+		}
+		acc = (uint64_t)t[N_LIMBS] + (acc >> 32);
+		t[N_LIMBS - 1] = (uint32_t)acc;
+		t[N_LIMBS] = t[N_LIMBS + 1] + (uint32_t)(acc >> 32);
+	}
+
+	fe_reduce_once(r, t, t[N_LIMBS]);
+}
+
+static void fe_sqr(uint32_t r[], const uint32_t a[]) {
+	fe_mul(r, a, a);
+}
+
+static void fe_to_mont(uint32_t r[], const uint32_t a[]) {
+	fe_mul(r, a, P192_R2);
+}
+
+static void fe_from_mont(uint32_t r[], const uint32_t a[]) {
+	static const uint32_t one[N_LIMBS] = {1, 0, 0, 0, 0, 0};
+
+	fe_mul(r, a, one);
+}
+
+// r = a^(p-2) = a^-1, the exponent is public so plain square and multiply is fine
+static void fe_inv(uint32_t r[], const uint32_t a[]) {
+	uint32_t t[N_LIMBS];
+	int i;
+
+	memcpy(t, P192_ONE_M, sizeof(t));
+	for(i = 32 * N_LIMBS - 1; i >= 0; i--) {
+		fe_sqr(t, t);
+		if((P192_P_MINUS_2[i / 32] >> (i % 32)) & 1)
+			fe_mul(t, t, a);
+	}
+	memcpy(r, t, sizeof(t));
+}
+
+static uint32_t fe_is_zero(const uint32_t a[]) {
+	uint32_t acc = 0;
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++)
+		acc |= a[i];
+	return ((acc | (0 - acc)) >> 31) ^ 1;
+}
+
+static int fe_is_reduced(const uint32_t a[]) {
+	uint64_t acc;
+	uint32_t borrow = 0;
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++) {
+		acc = (uint64_t)a[i] - P192_P[i] - borrow;
+		borrow = (uint32_t)(acc >> 32) & 1;
+	}
+	return borrow;	// a - p borrowed, so a < p
+}
+
+/*
+ * Point arithmetic, Jacobian coordinates in the Montgomery domain
+ */
+
+// dbl-2001-b, a = -3: 3M + 5S
+static void point_double(P192_JACOBIAN *r, const P192_JACOBIAN *a) {
+	uint32_t delta[N_LIMBS], gamma[N_LIMBS], beta[N_LIMBS], alpha[N_LIMBS];
+	uint32_t t0[N_LIMBS], t1[N_LIMBS];
+
+	fe_sqr(delta, a->z);
+	fe_sqr(gamma, a->y);
+	fe_mul(beta, a->x, gamma);
+
+	fe_sub(t0, a->x, delta);
+	fe_add(t1, a->x, delta);
+	fe_mul(alpha, t0, t1);
+	fe_add(t0, alpha, alpha);
+	fe_add(alpha, t0, alpha);		// alpha = 3 * (X - delta) * (X + delta)
+
+	fe_add(t0, a->y, a->z);
+	fe_sqr(t0, t0);
+	fe_sub(t0, t0, gamma);
+	fe_sub(r->z, t0, delta);		// Z3 = (Y + Z)^2 - gamma - delta
+
+	fe_add(beta, beta, beta);
+	fe_add(beta, beta, beta);		// beta = 4 * beta
+	fe_sqr(t0, alpha);
+	fe_add(t1, beta, beta);
+	fe_sub(r->x, t0, t1);			// X3 = alpha^2 - 8 * beta
+
+	fe_sub(t0, beta, r->x);
+	fe_mul(t0, alpha, t0);
+	fe_sqr(gamma, gamma);
+	fe_add(gamma, gamma, gamma);
+	fe_add(gamma, gamma, gamma);
+	fe_add(gamma, gamma, gamma);	// 8 * gamma^2
+	fe_sub(r->y, t0, gamma);		// Y3 = alpha * (4 * beta - X3) - 8 * gamma^2
+}
+
+// r = a when move = 1, without a data dependent branch
+static void point_cmov(P192_JACOBIAN *r, const P192_JACOBIAN *a, uint32_t move) {
+	uint32_t mask = 0 - move;
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++) {
+		r->x[i] ^= mask & (r->x[i] ^ a->x[i]);
+		r->y[i] ^= mask & (r->y[i] ^ a->y[i]);
+		r->z[i] ^= mask & (r->z[i] ^ a->z[i]);
+	}
+}
+
+/* add-2007-bl: 11M + 5S. The ladder keeps R1 - R0 equal to the input point,
+ * so the two operands are never equal and the doubling case cannot occur.
+ * One of them can be the point at infinity on the last two ladder steps
+ * (k = 1, n - 2, n - 1), which is handled with a masked select. */
+static void point_add(P192_JACOBIAN *r, const P192_JACOBIAN *a, const P192_JACOBIAN *b) {
+	uint32_t z1z1[N_LIMBS], z2z2[N_LIMBS], u1[N_LIMBS], u2[N_LIMBS], s1[N_LIMBS], s2[N_LIMBS];
+	uint32_t h[N_LIMBS], i2[N_LIMBS], j[N_LIMBS], rr[N_LIMBS], v[N_LIMBS], t0[N_LIMBS];
+	uint32_t a_inf = fe_is_zero(a->z), b_inf = fe_is_zero(b->z);
+	P192_JACOBIAN sum;
+
+	fe_sqr(z1z1, a->z);
+	fe_sqr(z2z2, b->z);
+	fe_mul(u1, a->x, z2z2);
+	fe_mul(u2, b->x, z1z1);
+	fe_mul(s1, a->y, b->z);
+	fe_mul(s1, s1, z2z2);
+	fe_mul(s2, b->y, a->z);
+	fe_mul(s2, s2, z1z1);
+
+	fe_sub(h, u2, u1);
+	fe_add(i2, h, h);
+	fe_sqr(i2, i2);					// I = (2H)^2
+	fe_mul(j, h, i2);
+	fe_sub(rr, s2, s1);
+	fe_add(rr, rr, rr);				// r = 2 * (S2 - S1)
+	fe_mul(v, u1, i2);
+
+	fe_add(t0, a->z, b->z);
+	fe_sqr(t0, t0);
+	fe_sub(t0, t0, z1z1);
+	fe_sub(t0, t0, z2z2);
+	fe_mul(sum.z, t0, h);			// Z3 = ((Z1 + Z2)^2 - Z1Z1 - Z2Z2) * H
+
+	fe_sqr(t0, rr);
+	fe_sub(t0, t0, j);
+	fe_sub(t0, t0, v);
+	fe_sub(sum.x, t0, v);			// X3 = r^2 - J - 2V
+
+	fe_sub(t0, v, sum.x);
+	fe_mul(t0, rr, t0);
+	fe_mul(s1, s1, j);
+	fe_add(s1, s1, s1);
+	fe_sub(sum.y, t0, s1);			// Y3 = r * (V - X3) - 2 * S1 * J
+
+	point_cmov(&sum, a, b_inf);
+	point_cmov(&sum, b, a_inf);
+	memcpy(r, &sum, sizeof(sum));
+}
+
+/* madd-2007-bl with an affine second operand. Used once per decryption on
+ * public values, so the exceptional cases are simply branched on.
+ * Returns 0 when the result is the point at infinity. */
+static int point_add_affine(P192_JACOBIAN *r, const P192_JACOBIAN *a, const uint32_t bx[], const uint32_t by[]) {
+	uint32_t z1z1[N_LIMBS], u2[N_LIMBS], s2[N_LIMBS], h[N_LIMBS], hh[N_LIMBS];
+	uint32_t i4[N_LIMBS], j[N_LIMBS], rr[N_LIMBS], v[N_LIMBS], t0[N_LIMBS];
+
+	if(fe_is_zero(a->z)) {
+		memcpy(r->x, bx, sizeof(r->x));
+		memcpy(r->y, by, sizeof(r->y));
+		memcpy(r->z, P192_ONE_M, sizeof(r->z));
+		return 1;
+	}
+
+	fe_sqr(z1z1, a->z);
+	fe_mul(u2, bx, z1z1);
+	fe_mul(s2, by, a->z);
+	fe_mul(s2, s2, z1z1);
+	fe_sub(h, u2, a->x);
+	fe_sub(rr, s2, a->y);
+
+	if(fe_is_zero(h)) {
+		if(!fe_is_zero(rr))
+			return 0;				// a = -b
+		point_double(r, a);			// a = b
+		return 1;
+	}
+
+	fe_add(rr, rr, rr);				// r = 2 * (S2 - Y1)
+	fe_sqr(hh, h);
+	fe_add(i4, hh, hh);
+	fe_add(i4, i4, i4);				// I = 4 * HH
+	fe_mul(j, h, i4);
+	fe_mul(v, a->x, i4);
+
+	fe_add(t0, a->z, h);
+	fe_sqr(t0, t0);
+	fe_sub(t0, t0, z1z1);
+	fe_sub(r->z, t0, hh);			// Z3 = (Z1 + H)^2 - Z1Z1 - HH
+
+	fe_sqr(t0, rr);
+	fe_sub(t0, t0, j);
+	fe_sub(t0, t0, v);
+	fe_sub(t0, t0, v);				// X3 = r^2 - J - 2V
+
+	fe_mul(u2, a->y, j);
+	fe_add(u2, u2, u2);
+	fe_sub(s2, v, t0);
+	fe_mul(s2, rr, s2);
+	fe_sub(r->y, s2, u2);			// Y3 = r * (V - X3) - 2 * Y1 * J
+	memcpy(r->x, t0, sizeof(t0));
+
+	return 1;
+}
+
+// Swap a and b when swap = 1, without a data dependent branch
+static void point_cswap(P192_JACOBIAN *a, P192_JACOBIAN *b, uint32_t swap) {
+	uint32_t mask = 0 - swap, t;
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++) {
+		t = mask & (a->x[i] ^ b->x[i]); a->x[i] ^= t; b->x[i] ^= t;
+		t = mask & (a->y[i] ^ b->y[i]); a->y[i] ^= t; b->y[i] ^= t;
+		t = mask & (a->z[i] ^ b->z[i]); a->z[i] ^= t; b->z[i] ^= t;
+	}
+}
+
+// Back to affine, normal representation. Returns 0 for the point at infinity
+static int point_to_affine(P192_POINT *out, const P192_JACOBIAN *a) {
+	uint32_t zi[N_LIMBS], zi2[N_LIMBS], t[N_LIMBS];
+
+	if(fe_is_zero(a->z))
+		return 0;
+
+	fe_inv(zi, a->z);
+	fe_sqr(zi2, zi);
+	fe_mul(t, a->x, zi2);
+	fe_from_mont(out->x, t);
+	fe_mul(zi2, zi2, zi);
+	fe_mul(t, a->y, zi2);
+	fe_from_mont(out->y, t);
+	return 1;
+}
+
+/* Fixed length scalar: k + n if that sets bit 192, otherwise k + 2n (which
+ * always does). Both are computed and the choice is made with a mask.
+ * Returns 0 when k is not in [1, n-1]. */
+static int scalar_pad(uint32_t out[], const uint32_t k[]) {
+	uint32_t k1[N_LIMBS + 1], k2[N_LIMBS + 1], mask;
+	uint64_t acc;
+	uint32_t borrow = 0;
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++) {
+		acc = (uint64_t)k[i] - P192_N[i] - borrow;
+		borrow = (uint32_t)(acc >> 32) & 1;
+	}
+	if(!borrow || fe_is_zero(k))
+		return 0;
+
+	acc = 0;
+	for(i = 0; i < N_LIMBS; i++) {
+		acc = (uint64_t)k[i] + P192_N[i] + (acc >> 32);
+		k1[i] = (uint32_t)acc;
+	}
+	k1[N_LIMBS] = (uint32_t)(acc >> 32);
+
+	acc = 0;
+	for(i = 0; i < N_LIMBS; i++) {
+		acc = (uint64_t)k1[i] + P192_N[i] + (acc >> 32);
+		k2[i] = (uint32_t)acc;
+	}
+	k2[N_LIMBS] = k1[N_LIMBS] + (uint32_t)(acc >> 32);
+
+	mask = 0 - (k1[N_LIMBS] & 1);
+	for(i = 0; i <= N_LIMBS; i++)
+		out[i] = (k1[i] & mask) | (k2[i] & ~mask);
+	return 1;
+}
+
+/* Montgomery ladder, result left in Jacobian form.
+ * pt must already be validated and in the Montgomery domain. */
+static int ladder(P192_JACOBIAN *r0, const uint32_t k[], const P192_JACOBIAN *pt) {
+	P192_JACOBIAN r1;
+	uint32_t ks[N_LIMBS + 1], bit, swap = 0;
+	int i;
+
+	if(!scalar_pad(ks, k))
+		return 0;
+
+	// bit 192 of the padded scalar is always set
+	memcpy(r0, pt, sizeof(*r0));
+	point_double(&r1, pt);
+
+	for(i = 32 * N_LIMBS - 1; i >= 0; i--) {
+		bit = (ks[i / 32] >> (i % 32)) & 1;
+		swap ^= bit;
+		point_cswap(r0, &r1, swap);
+		swap = bit;
+		point_add(&r1, r0, &r1);
+		point_double(r0, r0);
+	}
+	point_cswap(r0, &r1, swap);
+
+	memset(ks, 0, sizeof(ks));
+	return 1;
+}
+
+// Validated affine input to a Jacobian point in the Montgomery domain
+static int point_load(P192_JACOBIAN *out, const P192_POINT *pt) {
+	if(!p192_is_on_curve(pt))
+		return 0;
+	fe_to_mont(out->x, pt->x);
+	fe_to_mont(out->y, pt->y);
+	memcpy(out->z, P192_ONE_M, sizeof(out->z));
+	return 1;
+}
+
+/*
+ * Public interface
+ */
+
+// 24 big endian bytes to little endian limbs
+void p192_from_bytes(uint32_t out[], const uint8_t in[]) {
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++) {
+		const uint8_t *b = &in[P192_BYTES - 4 * (i + 1)];
+		out[i] = ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+	}
+}
+
+void p192_to_bytes(uint8_t out[], const uint32_t in[]) {
+	int i;
+
+	for(i = 0; i < N_LIMBS; i++) {
+		uint8_t *b = &out[P192_BYTES - 4 * (i + 1)];
+		b[0] = in[i] >> 24;
+		b[1] = in[i] >> 16;
+		b[2] = in[i] >> 8;
+		b[3] = in[i];
+	}
+}
+
+// X || Y, 48 bytes
+void p192_point_from_bytes(P192_POINT *out, const uint8_t in[]) {
+	p192_from_bytes(out->x, in);
+	p192_from_bytes(out->y, &in[P192_BYTES]);
+}
+
+void p192_point_to_bytes(uint8_t out[], const P192_POINT *in) {
+	p192_to_bytes(out, in->x);
+	p192_to_bytes(&out[P192_BYTES], in->y);
+}
+
+// y^2 = x^3 - 3x + b, with both coordinates below p
+int p192_is_on_curve(const P192_POINT *pt) {
+	uint32_t x[N_LIMBS], y[N_LIMBS], lhs[N_LIMBS], rhs[N_LIMBS], t[N_LIMBS];
+	int i;
+
+	if(!fe_is_reduced(pt->x) || !fe_is_reduced(pt->y))
+		return 0;
+
+	fe_to_mont(x, pt->x);
+	fe_to_mont(y, pt->y);
+	fe_sqr(lhs, y);
+
+	fe_sqr(rhs, x);
+	fe_mul(rhs, rhs, x);
+	fe_add(t, x, x);
+	fe_add(t, t, x);
+	fe_sub(rhs, rhs, t);
+	fe_add(rhs, rhs, P192_B_M);
+
+	for(i = 0; i < N_LIMBS; i++)
+		if(lhs[i] != rhs[i])
+			return 0;
+	return 1;
+}
+
+/* out = k * pt. Returns 0 if pt is not on the curve, k is out of range
+ * or the result is the point at infinity. */
+int p192_scalar_mult(P192_POINT *out, const uint32_t k[], const P192_POINT *pt) {
+	P192_JACOBIAN base, q;
+
+	if(!point_load(&base, pt))
+		return 0;
+	if(!ladder(&q, k, &base))
+		return 0;
+	return point_to_affine(out, &q);
+}
+
+/* ElGamal decryption m = C - kR, where k is the node private key,
+ * R the sender's ephemeral public key and C the ciphertext point. */
+int p192_elgamal_decrypt(P192_POINT *m, const uint32_t k[], const P192_POINT *r, const P192_POINT *c) {
+	static const uint32_t zero[N_LIMBS] = {0, 0, 0, 0, 0, 0};
+	P192_JACOBIAN base, q, sum;
+	uint32_t cx[N_LIMBS], cy[N_LIMBS];
+
+	if(!point_load(&base, r) || !p192_is_on_curve(c))
+		return 0;
+	if(!ladder(&q, k, &base))
+		return 0;
+
+	fe_sub(q.y, zero, q.y);		// -kR
+
+	fe_to_mont(cx, c->x);
+	fe_to_mont(cy, c->y);
+	if(!point_add_affine(&sum, &q, cx, cy))
+		return 0;
+
+	return point_to_affine(m, &sum);
+}
@@ -0,0 +1,34 @@
+/*
+ * ecc_p192.h
+ *
+ * Portable NIST P-192 arithmetic used as the software fallback for the
+ * ElGamal rekey (the same operation the FPGA ECC core performs).
+ *
+ * Field elements are 6 x 32-bit limbs, least significant limb first.
+ * Byte strings are big endian, 24 bytes per coordinate, the same order
+ * the coordinator prints them in El_gamal.py.
+ */
+
+#ifndef ECC_P192_H_
+#define ECC_P192_H_
+
+#include <stdint.h>
+
+#define P192_LIMBS 6
+#define P192_BYTES 24
+
+typedef struct _p192_point {
+	uint32_t x[P192_LIMBS];
+	uint32_t y[P192_LIMBS];
+} P192_POINT;
+
+void p192_from_bytes(uint32_t out[], const uint8_t in[]);
+void p192_to_bytes(uint8_t out[], const uint32_t in[]);
+void p192_point_from_bytes(P192_POINT *out, const uint8_t in[]);
+void p192_point_to_bytes(uint8_t out[], const P192_POINT *in);
+
+int p192_is_on_curve(const P192_POINT *pt);
+int p192_scalar_mult(P192_POINT *out, const uint32_t k[], const P192_POINT *pt);
+int p192_elgamal_decrypt(P192_POINT *m, const uint32_t k[], const P192_POINT *r, const P192_POINT *c);
+
+#endif /* ECC_P192_H_ */
@@ -0,0 +1,191 @@
+/* Standard Includes */
+#include <stdint.h>
+#include "energy.h"
+#include "sw_timer.h"
+
+#ifdef HOST_SIM
+uint32_t energy_sim_now = 0;
+#define NOW() energy_sim_now
+#else
+#define NOW() sw_timer_now()
+#endif
+
+/* Typical supply currents in uA at 3.3 V, from the datasheets */
+#define I_MCU_ACTIVE 2600		// MSP432P401R AM_LDO_VCORE0, 24 MHz from flash
+#define I_MCU_LPM0 1000			// MSP432P401R LPM0_LDO_VCORE0, 24 MHz, SMCLK peripherals on
+#define I_MCU_LPM3 1			// MSP432P401R LPM3, RTC/ACLK on
+#define I_RADIO_RX 31000		// XBee ZB S2C receiving, the router never sleeps
+#define I_RADIO_TX 45000		// XBee ZB S2C transmitting, boost mode
+#define I_CAMERA 70000			// ArduCAM Mini 2MP (OV2640 and FIFO) streaming, never powered down
+
+static const uint32_t mcu_current[ENERGY_MCU_COUNT] = { I_MCU_ACTIVE, I_MCU_LPM0, I_MCU_LPM3 };
+
+static const char *const phase_names[ENERGY_PHASE_COUNT] = {
+	"idle", "sccb_init", "capture", "readout", "xbee_cmd", "transmit", "rekey"
+};
+
+/* Ticks of every phase in every MSP432 state, and with the radio transmitting */
+static uint32_t mcu_ticks[ENERGY_PHASE_COUNT][ENERGY_MCU_COUNT];
+static uint32_t tx_ticks[ENERGY_PHASE_COUNT];
+static uint32_t images = 0, rekeys = 0;
+
+static uint8_t phase = ENERGY_PHASE_IDLE;
+static uint8_t mcu = ENERGY_MCU_ACTIVE;
+static uint8_t tx = 0;
+static uint32_t last = 0;
+
+// charge the time since the last change to the current phase and states
+static void account() {
+	uint32_t now = NOW();
+	uint32_t elapsed = now - last;
+
+	last = now;
+	mcu_ticks[phase][mcu] += elapsed;
+	if(tx)
+		tx_ticks[phase] += elapsed;
+}
+
+/* Function that starts a phase, returns the value for energy_end(). Inside another
+ * phase nothing changes, the time stays with the outer phase */
+uint8_t energy_begin(uint8_t new_phase) {
+	uint8_t previous = phase;
+
+	if(phase == ENERGY_PHASE_IDLE) {
+		account();
+		phase = new_phase;
+	}
+	return previous;
+}
+
+/* Function that ends a phase, previous is the return value of its energy_begin() */
+void energy_end(uint8_t previous) {
+	account();
+	phase = previous;
+}
+
+/* Function that records the MSP432 going to sleep (ENERGY_MCU_LPM0/LPM3) or waking up */
+void energy_mcu(uint8_t state) {
+	account();
+	mcu = state;
+}
+
+/* Function that records the XBee starting (on = 1) or ending a transmission */
+void energy_radio_tx(uint8_t on) {
+	account();
+	tx = on;
+}
+
+void energy_count(uint8_t event) {
+	if(event == ENERGY_EVENT_IMAGE)
+		images++;
+	else if(event == ENERGY_EVENT_REKEY)
+		rekeys++;
+}
+
+/* Function that clears the accounts, e.g. at the start of a measurement */
+void energy_reset() {
+	int p, s;
+
+	account();
+	for(p = 0; p < ENERGY_PHASE_COUNT; p++) {
+		for(s = 0; s < ENERGY_MCU_COUNT; s++)
+			mcu_ticks[p][s] = 0;
+		tx_ticks[p] = 0;
+	}
+	images = rekeys = 0;
+}
+
+// uJ of a phase: MSP432 states, radio receiving or transmitting, camera
+static uint64_t phase_uj(int p) {
+	uint64_t charge = 0;		// uA * ticks
+	uint32_t total = 0;
+	int s;
+
+	for(s = 0; s < ENERGY_MCU_COUNT; s++) {
+		charge += (uint64_t)mcu_current[s] * mcu_ticks[p][s];
+		total += mcu_ticks[p][s];
+	}
+	charge += (uint64_t)I_RADIO_RX * (total - tx_ticks[p]) + (uint64_t)I_RADIO_TX * tx_ticks[p];
+	charge += (uint64_t)I_CAMERA * total;
+	return charge * ENERGY_SUPPLY_MV / (1000ULL * SW_TIMER_HZ);
+}
+
+// append the decimal value of n to report, returns the new length
+static int append_uint(char report[], int len, int max, uint32_t n) {
+	char digits[10];
+	int i = 0;
+
+	do {
+		digits[i++] = '0' + n % 10;
+		n /= 10;
+	} while(n);
+	while(i && len < max)
+		report[len++] = digits[--i];
+	return len;
+}
+
+static int append_str(char report[], int len, int max, const char *str) {
+	while(*str && len < max)
+		report[len++] = *str++;
+	return len;
+}
+
+// append uJ as mJ with three decimals
+static int append_mj(char report[], int len, int max, uint64_t uj) {
+	len = append_uint(report, len, max, (uint32_t)(uj / 1000));
+	len = append_str(report, len, max, ".");
+	len = append_str(report, len, max, uj % 1000 < 100 ? (uj % 1000 < 10 ? "00" : "0") : "");
+	return append_uint(report, len, max, (uint32_t)(uj % 1000));
+}
+
+// same conversion as sw_timer_ms(), sw_timer.c is not part of the host simulation
+static int append_ms(char report[], int len, int max, uint32_t ticks) {
+	return append_uint(report, len, max, ticks / SW_TIMER_HZ * 1000 + ticks % SW_TIMER_HZ * 1000 / SW_TIMER_HZ);
+}
+
+/* Format the accounts as key=value lines, the same on the LaunchPad and in the
+ * host simulation so reports of two builds can be diffed:
+ *   phase=<name> active_ms= lpm0_ms= lpm3_ms= tx_ms= mj=
+ *   images= rekeys= total_mj= mj_per_image= mj_per_rekey=
+ * Returns the length, at most max */
+int energy_report(char report[], int max) {
+	uint64_t uj[ENERGY_PHASE_COUNT], total = 0, per_image, per_rekey;
+	int len = 0, p;
+
+	account();
+	for(p = 0; p < ENERGY_PHASE_COUNT; p++) {
+		uj[p] = phase_uj(p);
+		total += uj[p];
+
+		len = append_str(report, len, max, "phase=");
+		len = append_str(report, len, max, phase_names[p]);
+		len = append_str(report, len, max, " active_ms=");
+		len = append_ms(report, len, max, mcu_ticks[p][ENERGY_MCU_ACTIVE]);
+		len = append_str(report, len, max, " lpm0_ms=");
+		len = append_ms(report, len, max, mcu_ticks[p][ENERGY_MCU_LPM0]);
+		len = append_str(report, len, max, " lpm3_ms=");
+		len = append_ms(report, len, max, mcu_ticks[p][ENERGY_MCU_LPM3]);
+		len = append_str(report, len, max, " tx_ms=");
+		len = append_ms(report, len, max, tx_ticks[p]);
+		len = append_str(report, len, max, " mj=");
+		len = append_mj(report, len, max, uj[p]);
+		len = append_str(report, len, max, "\n");
+	}
+
+	per_image = uj[ENERGY_PHASE_CAPTURE] + uj[ENERGY_PHASE_READOUT] + uj[ENERGY_PHASE_TRANSMIT];
+	per_image = images ? per_image / images : 0;
+	per_rekey = rekeys ? uj[ENERGY_PHASE_REKEY] / rekeys : 0;
+
+	len = append_str(report, len, max, "images=");
+	len = append_uint(report, len, max, images);
+	len = append_str(report, len, max, " rekeys=");
+	len = append_uint(report, len, max, rekeys);
+	len = append_str(report, len, max, " total_mj=");
+	len = append_mj(report, len, max, total);
+	len = append_str(report, len, max, " mj_per_image=");
+	len = append_mj(report, len, max, per_image);
+	len = append_str(report, len, max, " mj_per_rekey=");
+	len = append_mj(report, len, max, per_rekey);
+	len = append_str(report, len, max, "\n");
+	return len;
+}
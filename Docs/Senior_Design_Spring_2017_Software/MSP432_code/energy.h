@@ -0,0 +1,62 @@
+/*
+ * energy.h
+ *
+ * Energy accounting from a power state model of the node. The firmware marks the
+ * phase it is in (ENERGY_PHASE_*), the state of the MSP432 (active, LPM0, LPM3)
+ * and whether the XBee is transmitting. The time of every phase is split over
+ * those states. energy_report() turns the times into energy with the current table
+ * of energy.c and divides the image phases by the images and the rekey phase by
+ * the rekeys.
+ *
+ * Phases do not nest: a phase begun inside another one is counted to the outer
+ * one (the ATKY session of a rekey is rekey energy, not XBee command energy).
+ *
+ * Time comes from sw_timer_now() on the LaunchPad. host_sim/energy_sim.c builds
+ * the same file with HOST_SIM and drives energy_sim_now through a model of the
+ * main loop, both print the same report.
+ *
+ * The tick counters wrap after 36 hours in one phase and state, read the report with
+ * NODE_CMD_ENERGY and reset it at least daily on a long measurement.
+ */
+
+#ifndef ENERGY_H_
+#define ENERGY_H_
+
+#include <stdint.h>
+
+/* Phases */
+#define ENERGY_PHASE_IDLE 0						// main loop waiting for the radio or a PIR
+#define ENERGY_PHASE_SCCB_INIT 1				// OV2640 register setup at boot
+#define ENERGY_PHASE_CAPTURE 2					// waiting for the Arducam capture done flag
+#define ENERGY_PHASE_READOUT 3					// JPEG out of the Arducam FIFO over SPI
+#define ENERGY_PHASE_XBEE_CMD 4					// AT command mode sessions
+#define ENERGY_PHASE_TRANSMIT 5					// transmit_image()
+#define ENERGY_PHASE_REKEY 6					// ElGamal decryption and ATKY
+#define ENERGY_PHASE_COUNT 7
+
+/* MSP432 states */
+#define ENERGY_MCU_ACTIVE 0
+#define ENERGY_MCU_LPM0 1
+#define ENERGY_MCU_LPM3 2
+#define ENERGY_MCU_COUNT 3
+
+/* Counted events */
+#define ENERGY_EVENT_IMAGE 0
+#define ENERGY_EVENT_REKEY 1
+
+#define ENERGY_SUPPLY_MV 3300
+#define ENERGY_REPORT_LEN 768					// energy_report() of counters near their 32 bit limit
+
+#ifdef HOST_SIM
+extern uint32_t energy_sim_now;					// SW_TIMER_HZ ticks, advanced by the simulation
+#endif
+
+uint8_t energy_begin(uint8_t phase);
+void energy_end(uint8_t previous);
+void energy_mcu(uint8_t state);
+void energy_radio_tx(uint8_t on);
+void energy_count(uint8_t event);
+void energy_reset();
+int energy_report(char report[], int max);
+
+#endif /* ENERGY_H_ */
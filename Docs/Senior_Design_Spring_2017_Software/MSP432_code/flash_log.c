@@ -0,0 +1,239 @@
+/* DriverLib Includes */
+#include "driverlib.h"
+
+/* Standard Includes */
+#include <stdint.h>
+#include "flash_log.h"
+#include "node_cmd.h"
+#include "sw_timer.h"
+#include "xbee_driver.h"
+
+#define ERASED 0xFFFFFFFF
+
+/* Header words, see flash_log.h */
+#define H_ERASE_COUNT 0
+#define H_MAGIC 1
+#define H_SEQ 2
+#define H_LENGTH 3
+#define H_SECTORS 4
+#define H_SENT 5
+#define H_COMMITTED 6
+
+#define SECTOR(n) ((uint32_t *)(FLASH_LOG_BASE + (n) * FLASH_LOG_SECTOR_SIZE))
+
+/* Ring: images from head (oldest waiting) to tail (next sector to write) */
+static int head = 0, tail = 0;
+static uint16_t queued = 0;
+static uint32_t next_seq = 0;
+static uint32_t sent = 0, dropped = 0;
+
+/* Drain */
+static uint8_t waiting_ack = 0;
+static volatile uint8_t acked = 0;
+static uint32_t ack_deadline, retry_deadline;
+static uint32_t retry_ms = FLASH_LOG_RETRY_MIN_MS;
+
+static int free_sectors() {
+	if(!queued)
+		return FLASH_LOG_SECTORS;
+	return (head - tail + FLASH_LOG_SECTORS) % FLASH_LOG_SECTORS;
+}
+
+// open a sector for program or erase, the wait states of init_clocks() come first
+static void unprotect(int sector) {
+	MAP_FlashCtl_setWaitState(FLASH_BANK1, FLASH_WAIT_STATES);
+	MAP_FlashCtl_unprotectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, 1UL << sector);
+}
+
+// program words of a header, the words have to be erased
+static int program_word(int sector, int word, uint32_t value) {
+	int ok;
+
+	unprotect(sector);
+	ok = MAP_FlashCtl_programMemory(&value, &SECTOR(sector)[word], 4);
+	MAP_FlashCtl_protectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, 1UL << sector);
+	return ok;
+}
+
+// erase a sector and carry its erase count over
+static int format_sector(int sector) {
+	uint32_t count = SECTOR(sector)[H_ERASE_COUNT];
+	int ok;
+
+	if(count == ERASED)		// never used
+		count = 0;
+
+	unprotect(sector);
+	ok = MAP_FlashCtl_eraseSector(FLASH_LOG_BASE + sector * FLASH_LOG_SECTOR_SIZE);
+	MAP_FlashCtl_protectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, 1UL << sector);
+
+	return ok && program_word(sector, H_ERASE_COUNT, count + 1);
+}
+
+// mark the image at head as done (acknowledged or dropped) and move to the next one
+static void retire_head() {
+	program_word(head, H_SENT, 0);
+	head = (head + SECTOR(head)[H_SECTORS]) % FLASH_LOG_SECTORS;
+	queued--;
+	waiting_ack = 0;
+}
+
+/* Function that rebuilds the ring from the sector headers after reset */
+void flash_log_init() {
+	uint32_t *h;
+	uint32_t max_seq = 0, head_seq = 0;
+	int i, found = 0;
+
+	head = tail = 0;
+	queued = 0;
+	for(i = 0; i < FLASH_LOG_SECTORS; i++) {
+		h = SECTOR(i);
+		if(h[H_MAGIC] != FLASH_LOG_FIRST || h[H_COMMITTED] != 0)
+			continue;	// continuation, free, or an image cut short by a reset
+
+		if(!found || (int32_t)(h[H_SEQ] - max_seq) > 0) {
+			max_seq = h[H_SEQ];
+			tail = (i + h[H_SECTORS]) % FLASH_LOG_SECTORS;
+		}
+		found = 1;
+		if(h[H_SENT] == ERASED) {
+			if(!queued || (int32_t)(h[H_SEQ] - head_seq) < 0) {
+				head_seq = h[H_SEQ];
+				head = i;
+			}
+			queued++;
+		}
+	}
+	next_seq = found ? max_seq + 1 : 0;
+	if(!queued)
+		head = tail;
+
+	waiting_ack = 0;
+	retry_deadline = sw_timer_now();
+}
+
+/* Function that appends an image to the queue, returns 0 if it does not fit the bank
+ * or the flash fails. The oldest images waiting are dropped to make room */
+int flash_log_append(const uint8_t data[], uint32_t length) {
+	int need = (length + FLASH_LOG_DATA_LEN - 1) / FLASH_LOG_DATA_LEN;
+	int first = tail, k, s;
+	uint32_t chunk, header[5];
+
+	if(length == 0 || need > FLASH_LOG_SECTORS)
+		return 0;
+
+	while(free_sectors() < need) {
+		retire_head();		// ring full, oldest image is lost
+		dropped++;
+	}
+
+	for(k = 0; k < need; k++) {
+		s = (first + k) % FLASH_LOG_SECTORS;
+		chunk = length > FLASH_LOG_DATA_LEN ? FLASH_LOG_DATA_LEN : length;
+
+		header[0] = k ? FLASH_LOG_CONT : FLASH_LOG_FIRST;
+		header[1] = next_seq;
+		header[2] = k ? k : length;
+		header[3] = need;
+		if(!format_sector(s))
+			return 0;
+
+		unprotect(s);
+		if(!MAP_FlashCtl_programMemory(header, &SECTOR(s)[H_MAGIC], 4 * 4)
+				|| !MAP_FlashCtl_programMemory((void *)data, (uint8_t *)SECTOR(s) + FLASH_LOG_HEADER_LEN, chunk)) {
+			MAP_FlashCtl_protectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, 1UL << s);
+			return 0;
+		}
+		MAP_FlashCtl_protectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, 1UL << s);
+
+		data += chunk;
+		length -= chunk;
+	}
+
+	if(!program_word(first, H_COMMITTED, 0))	// image is complete, survives a reset from here on
+		return 0;
+
+	tail = (first + need) % FLASH_LOG_SECTORS;
+	queued++;
+	next_seq++;
+	return 1;
+}
+
+// announce and send the image at head: IMAGE frame (seq, length), then the bytes
+static void send_head() {
+	uint32_t *h = SECTOR(head);
+	uint32_t length = h[H_LENGTH], chunk;
+	uint8_t info[8];
+	int k, s;
+
+	info[0] = h[H_SEQ] >> 24;
+	info[1] = h[H_SEQ] >> 16;
+	info[2] = h[H_SEQ] >> 8;
+	info[3] = h[H_SEQ];
+	info[4] = length >> 24;
+	info[5] = length >> 16;
+	info[6] = length >> 8;
+	info[7] = length;
+	node_cmd_send(NODE_CMD_IMAGE, info, sizeof(info));
+
+	for(k = 0; k < h[H_SECTORS]; k++) {
+		s = (head + k) % FLASH_LOG_SECTORS;
+		chunk = length > FLASH_LOG_DATA_LEN ? FLASH_LOG_DATA_LEN : length;
+		transmit_image((unsigned char *)SECTOR(s) + FLASH_LOG_HEADER_LEN, chunk);
+		length -= chunk;
+	}
+}
+
+/* Function that drains the queue, call from the main loop. Sends the oldest image,
+ * waits FLASH_LOG_ACK_MS for the acknowledge and backs off while none comes */
+void flash_log_poll() {
+	if(waiting_ack) {
+		if(acked) {
+			retire_head();
+			sent++;
+			retry_ms = FLASH_LOG_RETRY_MIN_MS;
+			retry_deadline = sw_timer_now();
+		}
+		else if(sw_timer_passed(ack_deadline)) {
+			waiting_ack = 0;	// link down or coordinator busy, keep the image and retry later
+			retry_deadline = sw_timer_deadline(retry_ms);
+			if(retry_ms < FLASH_LOG_RETRY_MAX_MS)
+				retry_ms <<= 1;
+		}
+		return;
+	}
+
+	if(queued && sw_timer_passed(retry_deadline)) {
+		acked = 0;
+		send_head();
+		waiting_ack = 1;
+		ack_deadline = sw_timer_deadline(FLASH_LOG_ACK_MS);
+	}
+}
+
+/* Function that takes the coordinator's acknowledge of image seq */
+void flash_log_ack(uint32_t seq) {
+	if(waiting_ack && SECTOR(head)[H_SEQ] == seq)
+		acked = 1;
+}
+
+void flash_log_stats(FLASH_LOG_STATS *stats) {
+	uint32_t count;
+	int i;
+
+	stats->queued = queued;
+	stats->free_sectors = free_sectors();
+	stats->sent = sent;
+	stats->dropped = dropped;
+	stats->min_erase = ERASED;
+	stats->max_erase = 0;
+	for(i = 0; i < FLASH_LOG_SECTORS; i++) {
+		count = SECTOR(i)[H_ERASE_COUNT];
+		if(count == ERASED)
+			count = 0;
+		if(count < stats->min_erase)
+			stats->min_erase = count;
+		if(count > stats->max_erase)
+			stats->max_erase = count;
+	}
+}
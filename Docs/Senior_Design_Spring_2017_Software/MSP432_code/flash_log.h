@@ -0,0 +1,57 @@
+/*
+ * flash_log.h
+ *
+ * Store-and-forward queue for captured images in flash bank 1 of the MSP432P401R
+ * (IMAGE_LOG in main.cmd, 32 sectors of 4 KB). Captures are appended at the tail,
+ * a background drain sends the oldest image and only drops it from the queue when
+ * the coordinator acknowledges its sequence number (NODE_CMD_IMAGE_ACK).
+ *
+ * Every image takes whole sectors, each starting with a 32 byte header:
+ *   word 0 : erase count, programmed right after every erase
+ *   word 1 : FLASH_LOG_FIRST or FLASH_LOG_CONT
+ *   word 2 : sequence number
+ *   word 3 : image length (first sector) or sector index in the image
+ *   word 4 : sectors of the image (first sector)
+ *   word 5 : 0 once acknowledged or dropped
+ *   word 6 : 0 once all sectors of the image are written
+ * Sectors are used strictly in ring order, so erases spread evenly over the bank.
+ * When the ring is full the oldest image waiting is dropped.
+ */
+
+#ifndef FLASH_LOG_H_
+#define FLASH_LOG_H_
+
+#include <stdint.h>
+
+#define FLASH_WAIT_STATES 1						// flash read wait states at MCLK = 24 MHz, init_clocks() in main.c
+
+#define FLASH_LOG_BASE 0x00020000				// start of bank 1
+#define FLASH_LOG_SECTORS 32
+#define FLASH_LOG_SECTOR_SIZE 4096
+#define FLASH_LOG_HEADER_LEN 32
+#define FLASH_LOG_DATA_LEN (FLASH_LOG_SECTOR_SIZE - FLASH_LOG_HEADER_LEN)
+
+#define FLASH_LOG_FIRST 0x494D4731				// "IMG1"
+#define FLASH_LOG_CONT 0x494D4743				// "IMGC"
+
+/* Drain timing */
+#define FLASH_LOG_ACK_MS 5000					// wait for the acknowledge after the last byte
+#define FLASH_LOG_RETRY_MIN_MS 5000				// first retry after a missing acknowledge
+#define FLASH_LOG_RETRY_MAX_MS 300000			// retries back off up to 5 minutes while the link is down
+
+typedef struct _flash_log_stats {
+	uint16_t queued;		// images waiting for an acknowledge
+	uint16_t free_sectors;
+	uint32_t sent;			// acknowledged since reset
+	uint32_t dropped;		// lost to a full ring since reset
+	uint32_t min_erase;		// erase counts over the bank
+	uint32_t max_erase;
+} FLASH_LOG_STATS;
+
+void flash_log_init();
+int flash_log_append(const uint8_t data[], uint32_t length);
+void flash_log_poll();
+void flash_log_ack(uint32_t seq);
+void flash_log_stats(FLASH_LOG_STATS *stats);
+
+#endif /* FLASH_LOG_H_ */
@@ -0,0 +1,291 @@
+/* DriverLib Includes */
+#include "driverlib.h"
+
+/* Standard Includes */
+#include <stdint.h>
+#include <string.h>
+#include "energy.h"
+#include "fpga_ecc.h"
+#include "i2c_driver.h"
+
+#define COORD_LEN (FPGA_ECC_POINT_LEN / 2)
+#define STREAM_LEN (2 + 2 * FPGA_ECC_POINT_LEN)	// start word + R + C, in bytes
+#define RESULT_LEN FPGA_ECC_POINT_LEN
+#define FPGA_ECC_STAT_WORDS 12						// STAT_WORDS in Intermediate.vhd
+
+static volatile FPGA_ECC_STATE state = FPGA_ECC_IDLE;
+static volatile uint8_t busy_dropped = 0;	// set by the busy line ISR
+static volatile uint8_t done_raised = 0;	// set by the done line ISR
+static uint8_t busy_mode = FPGA_ECC_MODE_POLL;
+
+static uint8_t stream[STREAM_LEN];
+static uint8_t result_words[RESULT_LEN];
+static int stream_index = 0;
+
+// Poll backoff
+static uint32_t next_check = 0;
+static uint32_t backoff = FPGA_ECC_BACKOFF_MIN;
+static uint8_t busy_seen = 0;
+
+static FPGA_ECC_TIMING timing;
+static uint32_t t_start, t_phase;
+
+/* Timer32 #2 runs freely at MCLK as the time base, counted up by inverting the value */
+static uint32_t now() {
+	return ~MAP_Timer32_getValue(TIMER32_1_BASE);
+}
+
+/* Function that sets up the busy and done lines and the time base
+ * mode --- FPGA_ECC_MODE_POLL, FPGA_ECC_MODE_IRQ or FPGA_ECC_MODE_DONE */
+void fpga_ecc_init(uint8_t mode) {
+	busy_mode = mode;
+
+	MAP_Timer32_initModule(TIMER32_1_BASE, TIMER32_PRESCALER_1, TIMER32_32BIT, TIMER32_FREE_RUN_MODE);
+	MAP_Timer32_setCount(TIMER32_1_BASE, 0xFFFFFFFF);
+	MAP_Timer32_startTimer(TIMER32_1_BASE, false);
+
+	MAP_GPIO_setAsInputPinWithPullDownResistor(FPGA_ECC_BUSY_PORT, FPGA_ECC_BUSY_PIN);
+	MAP_GPIO_interruptEdgeSelect(FPGA_ECC_BUSY_PORT, FPGA_ECC_BUSY_PIN, GPIO_HIGH_TO_LOW_TRANSITION);
+	MAP_GPIO_clearInterruptFlag(FPGA_ECC_BUSY_PORT, FPGA_ECC_BUSY_PIN);
+	if(mode == FPGA_ECC_MODE_IRQ) {
+		MAP_GPIO_enableInterrupt(FPGA_ECC_BUSY_PORT, FPGA_ECC_BUSY_PIN);
+		MAP_Interrupt_enableInterrupt(FPGA_ECC_BUSY_INT);
+	}
+
+	MAP_GPIO_setAsInputPinWithPullDownResistor(FPGA_ECC_DONE_PORT, FPGA_ECC_DONE_PIN);
+	MAP_GPIO_interruptEdgeSelect(FPGA_ECC_DONE_PORT, FPGA_ECC_DONE_PIN, GPIO_LOW_TO_HIGH_TRANSITION);
+	MAP_GPIO_clearInterruptFlag(FPGA_ECC_DONE_PORT, FPGA_ECC_DONE_PIN);
+	if(mode == FPGA_ECC_MODE_DONE) {
+		MAP_GPIO_enableInterrupt(FPGA_ECC_DONE_PORT, FPGA_ECC_DONE_PIN);
+		MAP_Interrupt_enableInterrupt(FPGA_ECC_BUSY_INT);	// same port as the busy line
+	}
+
+	state = FPGA_ECC_IDLE;
+}
+
+/* Operands as 16-bit words, least significant word first and high byte first
+ * within a word, which is the order the ECC core takes them */
+static void coord_to_words(uint8_t out[], const uint8_t coord[]) {
+	int w;
+
+	for(w = 0; w < COORD_LEN / 2; w++) {
+		out[2 * w] = coord[COORD_LEN - 2 - 2 * w];
+		out[2 * w + 1] = coord[COORD_LEN - 1 - 2 * w];
+	}
+}
+
+static void words_to_coord(uint8_t coord[], const uint8_t in[]) {
+	int w;
+
+	for(w = 0; w < COORD_LEN / 2; w++) {
+		coord[COORD_LEN - 2 - 2 * w] = in[2 * w];
+		coord[COORD_LEN - 1 - 2 * w] = in[2 * w + 1];
+	}
+}
+
+/* Function that queues C - kR on the FPGA, returns 0 if an operation is still running
+ * r, c --- X || Y, 48 bytes each, big endian */
+int fpga_ecc_start(const uint8_t r[], const uint8_t c[]) {
+	if(state != FPGA_ECC_IDLE && state != FPGA_ECC_DONE && state != FPGA_ECC_ERROR)
+		return 0;
+
+	// P-192 is named explicitly, the core skips the parameter upload while it stays loaded
+	stream[0] = (FPGA_ECC_CMD_CURVE | FPGA_ECC_CURVE_P192) >> 8;
+	stream[1] = (FPGA_ECC_CMD_CURVE | FPGA_ECC_CURVE_P192) & 0xFF;
+	coord_to_words(&stream[2], r);
+	coord_to_words(&stream[2 + COORD_LEN], &r[COORD_LEN]);
+	coord_to_words(&stream[2 + 2 * COORD_LEN], c);
+	coord_to_words(&stream[2 + 3 * COORD_LEN], &c[COORD_LEN]);
+	stream_index = 0;
+
+	memset(&timing, 0, sizeof(timing));
+	busy_dropped = 0;
+	done_raised = 0;
+	busy_seen = 0;
+	t_start = t_phase = now();
+	state = FPGA_ECC_WRITE;
+
+	return 1;
+}
+
+/* Function that makes the core upload the field and curve parameters again,
+ * e.g. after a brown-out of the FPGA. Returns 0 if an operation is running or on NACK */
+int fpga_ecc_reinit() {
+	uint8_t low = FPGA_ECC_CMD_REINIT & 0xFF;
+
+	if(state != FPGA_ECC_IDLE && state != FPGA_ECC_DONE && state != FPGA_ECC_ERROR)
+		return 0;
+
+	if(!writeI2C(FPGA_ECC_ADDRESS, FPGA_ECC_CMD_REINIT >> 8, &low, 1))
+		return 0;
+	state = FPGA_ECC_IDLE;
+	return 1;
+}
+
+static void enter_compute() {
+	uint32_t t = now();
+
+	timing.write_cycles = t - t_phase;
+	t_phase = t;
+	backoff = FPGA_ECC_BACKOFF_MIN;
+	next_check = t;
+	state = FPGA_ECC_COMPUTE;
+}
+
+/* Busy line check for poll mode. The line has to be seen high once, so a
+ * sample taken before the core raised it is not mistaken for completion
+ * (an unconnected line is pulled low and ends in a timeout instead) */
+static uint8_t compute_finished() {
+	uint32_t t = now();
+
+	if(busy_mode == FPGA_ECC_MODE_IRQ)
+		return busy_dropped;
+	if(busy_mode == FPGA_ECC_MODE_DONE)
+		return done_raised;
+
+	if((int32_t)(t - next_check) < 0)
+		return 0;
+
+	timing.busy_polls++;
+	if(MAP_GPIO_getInputPinValue(FPGA_ECC_BUSY_PORT, FPGA_ECC_BUSY_PIN)) {
+		busy_seen = 1;
+		next_check = t + backoff;
+		if(backoff < FPGA_ECC_BACKOFF_MAX)
+			backoff <<= 1;
+		return 0;
+	}
+	return busy_seen;
+}
+
+/* Function that advances the current operation, call from the main loop.
+ * Each call does at most one I2C transaction, so SCCB and radio work can run in between */
+FPGA_ECC_STATE fpga_ecc_poll() {
+	int len;
+
+	switch(state) {
+	case FPGA_ECC_WRITE:
+		len = STREAM_LEN - stream_index;
+		if(len > 2 * FPGA_ECC_CHUNK_WORDS)
+			len = 2 * FPGA_ECC_CHUNK_WORDS;
+
+		// first byte of the chunk goes out as the "register", the rest as data
+		if(!writeI2C(FPGA_ECC_ADDRESS, stream[stream_index], &stream[stream_index + 1], len - 1)) {
+			state = FPGA_ECC_ERROR;
+			break;
+		}
+		stream_index += len;
+		if(stream_index == STREAM_LEN)
+			enter_compute();
+		break;
+
+	case FPGA_ECC_COMPUTE:
+		if(compute_finished()) {
+			uint32_t t = now();
+
+			timing.compute_cycles = t - t_phase;
+			t_phase = t;
+			state = FPGA_ECC_READ;
+		}
+		else if(now() - t_phase > FPGA_ECC_TIMEOUT) {
+			state = FPGA_ECC_ERROR;
+		}
+		break;
+
+	case FPGA_ECC_READ:
+		/* One burst: the Intermediate advances its output pointer on every
+		 * read request, so the 24 words cannot be split over transactions */
+		if(!readBurstI2C(FPGA_ECC_ADDRESS, 0x00, result_words, RESULT_LEN)) {
+			state = FPGA_ECC_ERROR;
+			break;
+		}
+		timing.read_cycles = now() - t_phase;
+		timing.total_cycles = now() - t_start;
+		state = FPGA_ECC_DONE;
+		break;
+
+	default:
+		break;
+	}
+
+	return state;
+}
+
+/* Blocking helper: runs the state machine to completion, sleeping in LPM0
+ * until the busy or done line interrupt in IRQ and DONE mode */
+FPGA_ECC_STATE fpga_ecc_wait() {
+	FPGA_ECC_STATE s;
+
+	while((s = fpga_ecc_poll()) != FPGA_ECC_DONE && s != FPGA_ECC_ERROR && s != FPGA_ECC_IDLE) {
+		if(s == FPGA_ECC_COMPUTE && busy_mode != FPGA_ECC_MODE_POLL) {
+			MAP_Interrupt_disableMaster();
+			if(!busy_dropped && !done_raised) {
+				energy_mcu(ENERGY_MCU_LPM0);
+				MAP_PCM_gotoLPM0();		// a pending interrupt still wakes the core with the master disabled
+				energy_mcu(ENERGY_MCU_ACTIVE);
+			}
+			MAP_Interrupt_enableMaster();
+		}
+	}
+	return s;
+}
+
+/* Function that copies the result point (X || Y, big endian) out, returns 0 if none is ready */
+int fpga_ecc_result(uint8_t result[]) {
+	if(state != FPGA_ECC_DONE)
+		return 0;
+
+	words_to_coord(result, result_words);
+	words_to_coord(&result[COORD_LEN], &result_words[COORD_LEN]);
+	state = FPGA_ECC_IDLE;
+	return 1;
+}
+
+const FPGA_ECC_TIMING *fpga_ecc_timing() {
+	return &timing;
+}
+
+/* Function that reads the memory controller counters of the last finished job, blocking.
+ * Returns 0 if an operation is running or on NACK */
+int fpga_ecc_stats(FPGA_ECC_STATS *stats) {
+	uint8_t low = FPGA_ECC_CMD_STATS & 0xFF;
+	uint8_t words[2 * FPGA_ECC_STAT_WORDS];
+	uint32_t counter[FPGA_ECC_STAT_WORDS / 2];
+	int i;
+
+	if(state != FPGA_ECC_IDLE && state != FPGA_ECC_DONE && state != FPGA_ECC_ERROR)
+		return 0;
+
+	if(!writeI2C(FPGA_ECC_ADDRESS, FPGA_ECC_CMD_STATS >> 8, &low, 1))
+		return 0;
+	if(!readBurstI2C(FPGA_ECC_ADDRESS, 0x00, words, sizeof(words)))
+		return 0;
+
+	// 32-bit counters, least significant word first, high byte first within a word
+	for(i = 0; i < FPGA_ECC_STAT_WORDS / 2; i++) {
+		counter[i] = (uint32_t)words[4 * i] << 8 | words[4 * i + 1]
+				| (uint32_t)words[4 * i + 2] << 24 | (uint32_t)words[4 * i + 3] << 16;
+	}
+	stats->mas_busy = counter[0];
+	stats->mas_stall = counter[1];
+	stats->mmm_busy = counter[2];
+	stats->mmm_stall = counter[3];
+	stats->mc_busy = counter[4];
+	stats->mc_stall = counter[5];
+	return 1;
+}
+
+/* GPIO ISR for the FPGA busy and done lines */
+void PORT2_IRQHandler(void)
+{
+    uint32_t status;
+
+    status = MAP_GPIO_getEnabledInterruptStatus(FPGA_ECC_BUSY_PORT);
+    MAP_GPIO_clearInterruptFlag(FPGA_ECC_BUSY_PORT, status);
+
+    if(status & FPGA_ECC_BUSY_PIN) {
+    	busy_dropped = 1;	// core finished, result follows into the Intermediate
+    }
+    if(status & FPGA_ECC_DONE_PIN) {
+    	done_raised = 1;	// result stored in the Intermediate, ready for the burst read
+    }
+}
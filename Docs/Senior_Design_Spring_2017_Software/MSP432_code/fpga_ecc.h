@@ -0,0 +1,93 @@
+/*
+ * fpga_ecc.h
+ *
+ * Non-blocking driver for the ECC core on the Igloo nano FPGA (I2C slave 0x03,
+ * shared EUSCI_B1 bus with the OV2640 SCCB). One operation is the ElGamal
+ * decryption C - kR: a start word, 24 R words and 24 C words are streamed in,
+ * the core computes while the busy line is high, and the 24 result words are
+ * read back in one burst.
+ */
+
+#ifndef FPGA_ECC_H_
+#define FPGA_ECC_H_
+
+#include <stdint.h>
+
+/* FPGA ECC core on the I2C bus (I2C_slave SLAVE_ADDR in Top.vhd) */
+#define FPGA_ECC_ADDRESS 0x03
+#define FPGA_ECC_WORDS 24						// 16-bit words per point
+#define FPGA_ECC_POINT_LEN 48					// X || Y, big endian
+#define FPGA_ECC_CHUNK_WORDS 8					// words per I2C write, bounds each poll to ~1.5 ms at 100 kHz
+
+/* First word of a request (CMD_REINIT, CMD_CURVE in Intermediate.vhd). Field and curve
+ * stay loaded in the core, so a compute request only carries R and C. CMD_CURVE | id
+ * selects the curve of the request, the core only uploads parameters when it changes */
+#define FPGA_ECC_CMD_COMPUTE 0x0000
+#define FPGA_ECC_CMD_REINIT 0x0001
+#define FPGA_ECC_CMD_STATS 0x0002				// next read returns the memory controller counters
+#define FPGA_ECC_CMD_CURVE 0x0100
+
+/* Curve ids of the FPGA front-end, R and C are 2 * words 16-bit words each */
+#define FPGA_ECC_CURVE_P192 0					// 12 words per coordinate
+#define FPGA_ECC_CURVE_P224 1					// 14 words
+#define FPGA_ECC_CURVE_P256 2					// 16 words
+
+/* Top.vhd busy output, high while the core computes */
+#define FPGA_ECC_BUSY_PORT GPIO_PORT_P2
+#define FPGA_ECC_BUSY_PIN GPIO_PIN5
+#define FPGA_ECC_BUSY_INT INT_PORT2
+
+/* Top.vhd done output, rises once the result is in the Intermediate and can be read.
+ * Works with either DONE_PULSE setting of the FPGA, the rising edge is used */
+#define FPGA_ECC_DONE_PORT GPIO_PORT_P2
+#define FPGA_ECC_DONE_PIN GPIO_PIN6
+
+/* Busy line handling */
+#define FPGA_ECC_MODE_POLL 0					// sample the busy line with exponential backoff
+#define FPGA_ECC_MODE_IRQ 1						// falling edge interrupt, main loop may sleep in LPM0
+#define FPGA_ECC_MODE_DONE 2					// done line interrupt, read-out starts as soon as the result is stored
+
+/* Poll backoff and timeout, in MCLK cycles */
+#define FPGA_ECC_BACKOFF_MIN 2400				// 100 us at 24 MHz
+#define FPGA_ECC_BACKOFF_MAX 240000				// 10 ms at 24 MHz
+#define FPGA_ECC_TIMEOUT 48000000				// 2 s at 24 MHz
+
+typedef enum {
+	FPGA_ECC_IDLE = 0,
+	FPGA_ECC_WRITE,		// streaming the start word, R and C
+	FPGA_ECC_COMPUTE,	// waiting for the busy line to drop or the done line to rise
+	FPGA_ECC_READ,		// burst read pending
+	FPGA_ECC_DONE,		// result ready, fetch with fpga_ecc_result()
+	FPGA_ECC_ERROR		// NACK or timeout
+} FPGA_ECC_STATE;
+
+/* Per phase timing of the last operation, in MCLK cycles */
+typedef struct _fpga_ecc_timing {
+	uint32_t write_cycles;
+	uint32_t compute_cycles;
+	uint32_t read_cycles;
+	uint32_t total_cycles;
+	uint16_t busy_polls;	// times the busy line was sampled while computing
+} FPGA_ECC_TIMING;
+
+/* Memory controller counters of the last finished job, in FPGA clock cycles.
+ * busy = cycles the unit held the memory, stall = cycles it waited for it */
+typedef struct _fpga_ecc_stats {
+	uint32_t mas_busy;
+	uint32_t mas_stall;
+	uint32_t mmm_busy;
+	uint32_t mmm_stall;
+	uint32_t mc_busy;		// microcode scheduler
+	uint32_t mc_stall;
+} FPGA_ECC_STATS;
+
+void fpga_ecc_init(uint8_t mode);
+int fpga_ecc_start(const uint8_t r[], const uint8_t c[]);
+int fpga_ecc_reinit();
+FPGA_ECC_STATE fpga_ecc_poll();
+FPGA_ECC_STATE fpga_ecc_wait();
+int fpga_ecc_result(uint8_t result[]);
+const FPGA_ECC_TIMING *fpga_ecc_timing();
+int fpga_ecc_stats(FPGA_ECC_STATS *stats);
+
+#endif /* FPGA_ECC_H_ */
@@ -0,0 +1,265 @@
+/*
+ * ecc_bench.c
+ *
+ * Host side check and benchmark of the software P-192 engine (ecc_p192.c).
+ * Verifies the known answer vectors below and the node key against the public
+ * keys of BeagleBone_Code/test_keys.txt, then times the scalar multiplication
+ * and the full rekey decryption (C - kR).
+ *
+ * Only built by host_sim/Makefile, CCS never defines HOST_SIM.
+ *
+ *   make -C host_sim bench
+ */
+
+#ifdef HOST_SIM
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../ecc_p192.h"
+#include "../node_key.h"
+
+#define BENCH_ROUNDS 200
+
+#ifndef TEST_KEYS_PATH
+#define TEST_KEYS_PATH "../../BeagleBone_Code/test_keys.txt"
+#endif
+
+/* Base point of P-192 */
+static const char *G_X = "188DA80EB03090F67CBF20EB43A18800F4FF0AFD82FF1012";
+static const char *G_Y = "07192B95FFC8DA78631011ED6B24CDD573F977A11E794811";
+static const char *P192_P = "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF";
+
+typedef struct _mult_vector {
+	const char *k;
+	const char *x;
+	const char *y;
+} MULT_VECTOR;
+
+/* k * G, generated with the coordinator's El_gamal.py arithmetic */
+static const MULT_VECTOR mult_vectors[] = {
+	{"000000000000000000000000000000000000000000000001",
+	 "188DA80EB03090F67CBF20EB43A18800F4FF0AFD82FF1012",
+	 "07192B95FFC8DA78631011ED6B24CDD573F977A11E794811"},
+	{"000000000000000000000000000000000000000000000002",
+	 "DAFEBF5828783F2AD35534631588A3F629A70FB16982A888",
+	 "DD6BDA0D993DA0FA46B27BBC141B868F59331AFA5C7E93AB"},
+	{"000000000000000000000000000000000000000000000005",
+	 "10BB8E9840049B183E078D9C300E1605590118EBDD7FF590",
+	 "31361008476F917BADC9F836E62762BE312B72543CCEAEA1"},
+	{"FFFFFFFFFFFFFFFFFFFFFFFF99DEF836146BC9B1B4D2282F",	// n - 2, gives -2G
+	 "DAFEBF5828783F2AD35534631588A3F629A70FB16982A888",
+	 "229425F266C25F05B94D8443EBE4796FA6CCE505A3816C54"},
+	{"FFFFFFFFFFFFFFFFFFFFFFFF99DEF836146BC9B1B4D22830",	// n - 1, gives -G
+	 "188DA80EB03090F67CBF20EB43A18800F4FF0AFD82FF1012",
+	 "F8E6D46A003725879CEFEE1294DB32298C06885EE186B7EE"},
+	{"FF490B4952398D90CA7431DB57D1EFB871E31FBB32FC5707",
+	 "EA1C424B4FF94942402A0F234EA96FC1607FE05CF3C7892A",
+	 "9CF09FC1EF55D25CB4183728C660161A2BCF591E2E79A861"},
+};
+
+/* Rekey for a node with private key 5 (node_key.h),
+ * using a fixed message key k, the one El_gamal.py's setup_and_rekey() used to hard-code */
+static const char *REKEY_D = "000000000000000000000000000000000000000000000005";
+static const char *REKEY_R[2] = {
+	"43272EA59EE290FA3840D5457480482339BACB22B63D0492",
+	"292E0B40FD996857065900936C832A3A39961CB0DEB1073F"};
+static const char *REKEY_C[2] = {
+	"69E62ED23BB11E544644319C67EC3FC64C10478F3E4E801A",
+	"CC7DA5B6C11429295AC8AD90620B4943C5837C6B36445EB0"};
+static const char *REKEY_M[2] = {
+	"B91CBB1EEEB80E9B96C667D6BB266AB391806E5ABB42907A",
+	"1CF537F9A42C2F1A244CFCCE576244C45F1685B4907FD8BA"};
+
+static void hex_to_limbs(uint32_t out[], const char *hex) {
+	uint8_t bytes[P192_BYTES];
+	int i;
+
+	for(i = 0; i < P192_BYTES; i++) {
+		char pair[3] = {hex[2 * i], hex[2 * i + 1], 0};
+		bytes[i] = (uint8_t)strtoul(pair, NULL, 16);
+	}
+	p192_from_bytes(out, bytes);
+}
+
+static int limbs_equal_hex(const uint32_t a[], const char *hex) {
+	uint32_t b[P192_LIMBS];
+
+	hex_to_limbs(b, hex);
+	return memcmp(a, b, sizeof(b)) == 0;
+}
+
+// "0x..." field of test_keys.txt to limbs, the leading zeros may be missing
+static int key_field_to_limbs(uint32_t out[], const char *field) {
+	char hex[2 * P192_BYTES + 1];
+	size_t len;
+
+	if(field[0] == '0' && (field[1] == 'x' || field[1] == 'X'))
+		field += 2;
+	len = strcspn(field, ";\r\n");
+	if(len == 0 || len > 2 * P192_BYTES)
+		return 0;
+	memset(hex, '0', 2 * P192_BYTES - len);
+	memcpy(&hex[2 * P192_BYTES - len], field, len);
+	hex[2 * P192_BYTES] = 0;
+	hex_to_limbs(out, hex);
+	return 1;
+}
+
+/* Every node of test_keys.txt runs this firmware, so its public key has to be
+ * node_private_key * G, and a rekey encrypted to that key the way El_gamal.py does
+ * it (R = kG, C = kY + M) has to decrypt with node_private_key. kY + M is taken as
+ * M - k(-Y), there is no point addition in the API */
+static int check_provisioned_keys(const P192_POINT *g) {
+	FILE *f = fopen(TEST_KEYS_PATH, "r");
+	char line[256], *field[4];
+	P192_POINT pub, neg, q, r, c, m, msg;
+	uint32_t d[P192_LIMBS], k[P192_LIMBS], p[P192_LIMBS];
+	uint64_t diff;
+	uint32_t borrow;
+	int i, nodes = 0, failed = 0;
+
+	if(f == NULL) {
+		printf("FAIL: cannot open %s\n", TEST_KEYS_PATH);
+		return 1;
+	}
+	p192_from_bytes(d, node_private_key);
+	hex_to_limbs(p, P192_P);
+	hex_to_limbs(k, mult_vectors[5].k);		// message key
+	hex_to_limbs(msg.x, mult_vectors[1].x);		// M = 2G
+	hex_to_limbs(msg.y, mult_vectors[1].y);
+
+	while(fgets(line, sizeof(line), f) != NULL) {
+		if(strspn(line, " \r\n") == strlen(line))
+			continue;
+		field[0] = line;
+		for(i = 1; i < 4; i++) {
+			field[i] = field[i - 1] ? strchr(field[i - 1], ';') : NULL;
+			if(field[i])
+				field[i]++;
+		}
+		nodes++;
+		if(!field[3] || !key_field_to_limbs(pub.x, field[2]) || !key_field_to_limbs(pub.y, field[3])) {
+			printf("FAIL: %s line %d is not SH;SL;0xX;0xY\n", TEST_KEYS_PATH, nodes);
+			failed++;
+			continue;
+		}
+
+		if(!p192_scalar_mult(&q, d, g) || memcmp(&q, &pub, sizeof(q))) {
+			printf("FAIL: public key of %s line %d is not node_private_key * G\n", TEST_KEYS_PATH, nodes);
+			failed++;
+			continue;
+		}
+
+		memcpy(neg.x, pub.x, sizeof(neg.x));
+		for(i = 0, borrow = 0; i < P192_LIMBS; i++) {	// -Y = (x, p - y)
+			diff = (uint64_t)p[i] - pub.y[i] - borrow;
+			neg.y[i] = (uint32_t)diff;
+			borrow = (uint32_t)(diff >> 63);
+		}
+		if(!p192_scalar_mult(&r, k, g) || !p192_elgamal_decrypt(&c, k, &neg, &msg)
+				|| !p192_elgamal_decrypt(&m, d, &r, &c) || memcmp(&m, &msg, sizeof(m))) {
+			printf("FAIL: rekey to the public key of %s line %d\n", TEST_KEYS_PATH, nodes);
+			failed++;
+		}
+	}
+	fclose(f);
+
+	if(nodes == 0) {
+		printf("FAIL: no node in %s\n", TEST_KEYS_PATH);
+		failed++;
+	}
+	return failed;
+}
+
+static double now_us(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int check_vectors(void) {
+	P192_POINT g, q, r, c, m;
+	uint32_t k[P192_LIMBS];
+	int i, failed = 0;
+
+	hex_to_limbs(g.x, G_X);
+	hex_to_limbs(g.y, G_Y);
+
+	for(i = 0; i < (int)(sizeof(mult_vectors) / sizeof(mult_vectors[0])); i++) {
+		hex_to_limbs(k, mult_vectors[i].k);
+		if(!p192_scalar_mult(&q, k, &g) || !limbs_equal_hex(q.x, mult_vectors[i].x)
+				|| !limbs_equal_hex(q.y, mult_vectors[i].y)) {
+			printf("FAIL: k * G for k = %s\n", mult_vectors[i].k);
+			failed++;
+		}
+	}
+
+	hex_to_limbs(k, REKEY_D);
+	hex_to_limbs(r.x, REKEY_R[0]);
+	hex_to_limbs(r.y, REKEY_R[1]);
+	hex_to_limbs(c.x, REKEY_C[0]);
+	hex_to_limbs(c.y, REKEY_C[1]);
+	if(!p192_elgamal_decrypt(&m, k, &r, &c) || !limbs_equal_hex(m.x, REKEY_M[0])
+			|| !limbs_equal_hex(m.y, REKEY_M[1])) {
+		printf("FAIL: C - kR\n");
+		failed++;
+	}
+
+	failed += check_provisioned_keys(&g);
+
+	// off-curve points and out of range keys must be rejected
+	r.y[0] ^= 1;
+	if(p192_elgamal_decrypt(&m, k, &r, &c)) {
+		printf("FAIL: off-curve R accepted\n");
+		failed++;
+	}
+	memset(k, 0, sizeof(k));
+	if(p192_scalar_mult(&q, k, &g)) {
+		printf("FAIL: k = 0 accepted\n");
+		failed++;
+	}
+
+	return failed;
+}
+
+int main(void) {
+	P192_POINT g, q, r, c, m;
+	uint32_t k[P192_LIMBS];
+	double start, mult_us, decrypt_us;
+	int i, failed;
+
+	failed = check_vectors();
+	printf("Known answer tests: %s\n", failed ? "FAILED" : "passed");
+	if(failed)
+		return 1;
+
+	hex_to_limbs(g.x, G_X);
+	hex_to_limbs(g.y, G_Y);
+	hex_to_limbs(k, mult_vectors[5].k);
+	start = now_us();
+	for(i = 0; i < BENCH_ROUNDS; i++)
+		p192_scalar_mult(&q, k, &g);
+	mult_us = (now_us() - start) / BENCH_ROUNDS;
+
+	hex_to_limbs(k, REKEY_D);
+	hex_to_limbs(r.x, REKEY_R[0]);
+	hex_to_limbs(r.y, REKEY_R[1]);
+	hex_to_limbs(c.x, REKEY_C[0]);
+	hex_to_limbs(c.y, REKEY_C[1]);
+	start = now_us();
+	for(i = 0; i < BENCH_ROUNDS; i++)
+		p192_elgamal_decrypt(&m, k, &r, &c);
+	decrypt_us = (now_us() - start) / BENCH_ROUNDS;
+
+	printf("k * G        : %9.1f us\n", mult_us);
+	printf("C - kR rekey : %9.1f us\n", decrypt_us);
+	printf("(%d rounds each, host time; see rekey_benchmark() for MSP432 cycles)\n", BENCH_ROUNDS);
+
+	return 0;
+}
+
+#endif /* HOST_SIM */
@@ -0,0 +1,209 @@
+/*
+ * energy_sim.c
+ *
+ * Host model of the node for the energy accounting of energy.c. Walks one hour of
+ * the main loop (boot, network join, images, rekeys, idle) through the same
+ * energy_begin()/energy_mcu()/energy_radio_tx() calls the firmware makes, with
+ * the time of every step taken from the constants below, and prints the report
+ * NODE_CMD_ENERGY returns on the LaunchPad. Durations that depend on the
+ * hardware (capture, software ECC) are estimates; put the measured values in
+ * when a board is at hand (rekey benchmark '4', node_protocol.py energy).
+ *
+ * Only built by host_sim/Makefile, CCS never defines HOST_SIM.
+ *
+ *   make -C host_sim energy
+ *   ./energy_sim [images] [image_bytes] [scan|cached|kept] [lpm0|lpm3] [rekeys] [probe_misses]
+ *
+ * probe_misses is the number of rates probe_baud() tries before the module answers,
+ * 0 when it is at the rate stored with the network. The times to join and to the first
+ * image are printed like NODE_CMD_BOOT_STATS reports them.
+ */
+
+#ifdef HOST_SIM
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../energy.h"
+#include "../image_header.h"
+#include "../ov2640_driver.h"
+#include "../ov2640_regs.h"
+#include "../ov2640_regs_opt.h"
+#include "../sw_timer.h"
+
+#define SIM_TIME_US 3600000000ULL				// simulated time
+
+#define SCCB_WRITE_US 300						// 3 bytes, start and stop at 100 kHz
+#define OV2640_RESET_MS 100						// init_OV2640_regs() after the software reset
+#define SCCB_SETTLE_MS 7						// init_ov2640()
+
+#define GUARD_MS 1250							// xbee_driver.c, pause around every command mode session
+#define CMD_MODE_TIMEOUT_MS 1500				// xbee_driver.c, wait for the OK to +++
+#define AT_REPLY_MS 20							// one AT command and its OK, polled in LPM0
+#define JOIN_SCAN_POLLS 6						// ATOI reads until the module found a network
+#define REJOIN_POLLS 2							// read_network() rounds until the cached network is back
+
+#define CAPTURE_MS 140							// Arducam capture, 640x480 JPEG, polled every ms in LPM0
+#define SPI_BYTE_US 8							// spi_Read_crc32() at 1 MHz SPICLK
+#define XBEE_BAUD 115200						// UART rate after xbee_negotiate_baud()
+#define XBEE_RF_BPS 35000						// payload rate of the radio in transparent mode, estimate; CTS holds the UART to it
+#define SOFTWARE_ECC_MS 1000					// rekey_software(), SW of benchmark '4'
+
+static uint64_t sim_us = 0;
+static uint32_t join_ms = 0, first_image_ms = 0;	// BOOT_STATS
+
+// let us microseconds pass in the given MSP432 state
+static void spend_us(uint64_t us, uint8_t mcu) {
+	if(mcu != ENERGY_MCU_ACTIVE)
+		energy_mcu(mcu);
+	sim_us += us;
+	energy_sim_now = (uint32_t)(sim_us * SW_TIMER_HZ / 1000000);
+	if(mcu != ENERGY_MCU_ACTIVE)
+		energy_mcu(ENERGY_MCU_ACTIVE);
+}
+
+static void spend_ms(uint32_t ms, uint8_t mcu) {
+	spend_us((uint64_t)ms * 1000, mcu);
+}
+
+// writes of a sensor_reg table up to the end marker
+static int table_writes(const struct sensor_reg *regs) {
+	int n = 0;
+
+	while(regs[n].reg != 0xFF || regs[n].val != 0xFF)
+		n++;
+	return n;
+}
+
+// init_ov2640(): settle delay, reset and the optimized 640x480 cold init, sleeping in i2c_wait()
+static void sim_sccb_init() {
+	uint8_t phase = energy_begin(ENERGY_PHASE_SCCB_INIT);
+
+	spend_ms(SCCB_SETTLE_MS, ENERGY_MCU_LPM0);
+	spend_us(4 * SCCB_WRITE_US, ENERGY_MCU_LPM0);			// bank select, two ID reads, COM7 reset
+	spend_ms(OV2640_RESET_MS, ENERGY_MCU_LPM0);
+	spend_us((uint64_t)table_writes(ov2640_init[OV2640_RES_640x480]) * SCCB_WRITE_US, ENERGY_MCU_LPM0);
+	energy_end(phase);
+}
+
+// one command mode session: guard time, +++, the commands, ATCN
+static void sim_at_session(int commands) {
+	spend_ms(GUARD_MS, ENERGY_MCU_LPM0);
+	spend_ms((uint32_t)(commands + 2) * AT_REPLY_MS, ENERGY_MCU_LPM0);
+}
+
+// init_XBEE() on the given join path, xbee_driver.c
+static void sim_join(const char *path, int probe_misses) {
+	uint8_t phase = energy_begin(ENERGY_PHASE_XBEE_CMD);
+	int i;
+
+	for(i = 0; i < probe_misses; i++)			// probe_baud() at a rate the module is not at
+		spend_ms(GUARD_MS + CMD_MODE_TIMEOUT_MS, ENERGY_MCU_LPM0);
+	sim_at_session(0);							// probe_baud() at the module's rate
+	sim_at_session(5);							// read_network() of rejoin_cached()
+	if(!strcmp(path, "cached")) {
+		sim_at_session(5);						// ATID, ATSC, ATDH, ATDL, ATAC
+		for(i = 0; i < REJOIN_POLLS; i++)
+			sim_at_session(5);
+	}
+	else if(!strcmp(path, "scan")) {
+		sim_at_session(1);						// ATRE
+		for(i = 0; i < 2; i++)
+			sim_at_session(3);					// ATID, ATWR, ATAC
+		for(i = 0; i < JOIN_SCAN_POLLS; i++)
+			sim_at_session(1);					// ATOI
+	}
+	join_ms = (uint32_t)(sim_us / 1000);
+	sim_at_session(5);							// read_network() for net_state_save()
+	spend_ms(GUARD_MS, ENERGY_MCU_LPM0);
+	sim_at_session(1);							// ATSH
+	sim_at_session(1);							// ATSL
+	sim_at_session(2);							// ATD7, ATAC
+	if(!strcmp(path, "scan")) {					// ATRE put the module back to 9600
+		sim_at_session(1);						// ATBD, xbee_negotiate_baud()
+		sim_at_session(1);						// ATBD read back at the new rate
+		spend_ms(GUARD_MS, ENERGY_MCU_LPM0);
+		sim_at_session(1);						// ATWR
+	}
+	energy_end(phase);
+}
+
+// capture_image() and transmit_image() of one image of size JPEG bytes
+static void sim_image(uint32_t size) {
+	uint64_t uart_us, rf_us;
+	uint8_t phase;
+
+	phase = energy_begin(ENERGY_PHASE_CAPTURE);
+	spend_ms(CAPTURE_MS, ENERGY_MCU_LPM0);
+	energy_end(phase);
+
+	phase = energy_begin(ENERGY_PHASE_READOUT);
+	spend_us((uint64_t)(size + 1) * SPI_BYTE_US, ENERGY_MCU_ACTIVE);
+	energy_end(phase);
+
+	phase = energy_begin(ENERGY_PHASE_TRANSMIT);
+	energy_radio_tx(1);
+	uart_us = (uint64_t)(IMAGE_HEADER_LEN + size) * 10 * 1000000 / XBEE_BAUD;
+	rf_us = (uint64_t)(IMAGE_HEADER_LEN + size) * 8 * 1000000 / XBEE_RF_BPS;
+	spend_us(uart_us, ENERGY_MCU_ACTIVE);
+	if(rf_us > uart_us)
+		spend_us(rf_us - uart_us, ENERGY_MCU_LPM0);		// wait_cts() sleeps while the radio catches up
+	energy_radio_tx(0);
+	energy_end(phase);
+
+	energy_count(ENERGY_EVENT_IMAGE);
+	if(first_image_ms == 0)
+		first_image_ms = (uint32_t)(sim_us / 1000);
+}
+
+// rekey_session_key() on the software engine, apply_session_key() with its ATEE and ATKY
+static void sim_rekey() {
+	uint8_t phase = energy_begin(ENERGY_PHASE_REKEY);
+
+	spend_ms(SOFTWARE_ECC_MS, ENERGY_MCU_ACTIVE);
+	sim_at_session(3);							// ATEE, ATWR, ATAC
+	spend_ms(GUARD_MS, ENERGY_MCU_LPM0);
+	sim_at_session(3);							// ATKY, ATWR, ATAC
+	spend_ms(GUARD_MS, ENERGY_MCU_LPM0);
+	spend_ms(2 * GUARD_MS, ENERGY_MCU_LPM0);	// OK answers to the coordinator
+	energy_end(phase);
+
+	energy_count(ENERGY_EVENT_REKEY);
+}
+
+int main(int argc, char *argv[]) {
+	int images = argc > 1 ? atoi(argv[1]) : 10;
+	uint32_t image_bytes = argc > 2 ? (uint32_t)atoi(argv[2]) : 24000;
+	const char *path = argc > 3 ? argv[3] : "cached";
+	uint8_t idle = argc > 4 && !strcmp(argv[4], "lpm3") ? ENERGY_MCU_LPM3 : ENERGY_MCU_LPM0;
+	int rekeys = argc > 5 ? atoi(argv[5]) : 1;
+	int probe_misses = argc > 6 ? atoi(argv[6]) : 0;
+	char report[ENERGY_REPORT_LEN + 1];
+	int i, len;
+
+	if(strcmp(path, "scan") && strcmp(path, "cached") && strcmp(path, "kept")) {
+		fprintf(stderr, "join path is scan, cached or kept\n");
+		return 1;
+	}
+
+	sim_sccb_init();
+	sim_join(path, probe_misses);
+	for(i = 0; i < images; i++)
+		sim_image(image_bytes);
+	for(i = 0; i < rekeys; i++)
+		sim_rekey();
+	if(sim_us < SIM_TIME_US)
+		spend_us(SIM_TIME_US - sim_us, idle);	// main loop in sw_timer_idle()
+
+	printf("%d images of %u bytes, %s join, idle in %s, %d rekeys, 1 h\n", images,
+			(unsigned)image_bytes, path, idle == ENERGY_MCU_LPM3 ? "LPM3" : "LPM0", rekeys);
+	printf("join %s after %u ms, first image after %u ms, %d probe misses\n", path,
+			(unsigned)join_ms, (unsigned)first_image_ms, probe_misses);
+	len = energy_report(report, ENERGY_REPORT_LEN);
+	report[len] = 0;
+	fputs(report, stdout);
+	return len < ENERGY_REPORT_LEN ? 0 : 1;		// a full buffer means the firmware report is cut
+}
+
+#endif /* HOST_SIM */
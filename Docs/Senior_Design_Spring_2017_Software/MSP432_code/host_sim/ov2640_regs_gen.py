@@ -0,0 +1,291 @@
+#Offline optimizer for the OV2640 register tables in ../ov2640_regs.h.
+#
+#Replays the cold init of init_OV2640_regs() (JPEG_INIT, YUV422, JPEG, the COM10
+#write and one resolution table) on a model of the bank switched register file and
+#writes ../ov2640_regs_opt.h with:
+#   OV2640_INIT_<res>       cold init for every resolution, dead and redundant writes dropped
+#   OV2640_DELTA_<a>_<b>    writes that take the sensor from resolution a to b
+#   ov2640_delta[a][b]      the delta tables, OV2640_RES_* order, the full resolution
+#                           table where it is shortest and reaches the same state
+#
+#Model:
+#   - register 0xFF selects the bank (0 = DSP, 1 = sensor), every other register is
+#     addressed as (bank, reg)
+#   - the values after the software reset are unknown, a write is only redundant if
+#     the same value was written before in the same sequence
+#   - SEQUENCE registers (indirect address/data ports, reset and control strobes) are
+#     replayed exactly as written, in order. The indirect PORTS have no value of their
+#     own and may not differ between resolutions
+#   - BARRIER registers may reload other registers of their bank (COM7 changes the
+#     sensor mode), known values of that bank are forgotten after them
+#   - a write that is overwritten later in the same sequence is dead, unless the
+#     register is a SEQUENCE register
+#   - a resolution switch leaves registers only the old resolution sets alone, like
+#     writing the full resolution table does. A delta ends in the state of the cold
+#     init of the new resolution for every register that cold init sets, so deltas
+#     can be chained
+#
+#Usage:
+#   python ov2640_regs_gen.py            regenerate ../ov2640_regs_opt.h
+#   python ov2640_regs_gen.py --check    print the write counts, do not write the header
+
+import os
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SOURCE = os.path.join(HERE, '..', 'ov2640_regs.h')
+OUTPUT = os.path.join(HERE, '..', 'ov2640_regs_opt.h')
+
+BANK_SELECT = 0xFF
+END = (0xFF, 0xFF)
+
+PORTS = set([
+    (0, 0x7C), (0, 0x7D),       #SDE indirect address / data
+    (0, 0x90), (0, 0x91),       #gamma indirect address / data
+    (0, 0x92), (0, 0x93),
+    (0, 0x96), (0, 0x97),
+])
+SEQUENCE = PORTS | set([
+    (0, 0x05),                  #R_BYPASS
+    (0, 0xC3),                  #CTRL1, written twice in a row by the Arducam tables
+    (0, 0xD3),                  #R_DVP_SP, written twice in a row by the Arducam tables
+    (0, 0xE0),                  #RESET, brackets the DSP setup
+])
+BARRIER = set([(1, 0x12)])      #COM7, resolution mode
+
+#OV2640_RES_* order in ../ov2640_driver.h
+RESOLUTIONS = ['160x120', '176x144', '320x240', '352x288', '640x480',
+               '800x600', '1024x768', '1280x1024', '1600x1200']
+
+#init_OV2640_regs(): tables and single writes after the software reset
+COLD_INIT = ['OV2640_JPEG_INIT', 'OV2640_YUV422', 'OV2640_JPEG', [(0xFF, 0x01), (0x15, 0x00)]]
+
+
+def load_tables(path):
+    #{name: [(reg, val), ...]} of every sensor_reg table, up to the 0xFF, 0xFF end marker
+    text = open(path).read()
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    text = re.sub(r'//[^\n]*', '', text)
+    tables = {}
+    for m in re.finditer(r'const\s+struct\s+sensor_reg\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\};', text, re.S):
+        pairs = []
+        for reg, val in re.findall(r'\{\s*(0x[0-9a-fA-F]+)\s*,\s*(0x[0-9a-fA-F]+)\s*\}', m.group(2)):
+            pair = (int(reg, 16), int(val, 16))
+            if pair == END:
+                break
+            pairs.append(pair)
+        tables[m.group(1)] = pairs
+    return tables
+
+
+def banked(pairs, bank=None):
+    #[(bank, reg, val), ...] of a raw register stream, bank selects folded in
+    out = []
+    for reg, val in pairs:
+        if reg == BANK_SELECT:
+            bank = val
+            continue
+        if bank is None:
+            raise ValueError('register 0x%02X written before a bank select' % reg)
+        out.append((bank, reg, val))
+    return out
+
+
+def optimize(writes):
+    #Drop dead and redundant writes of a banked stream, keeps the order of the rest
+    last = {}
+    for i, (bank, reg, val) in enumerate(writes):
+        last[(bank, reg)] = i
+
+    known = {}
+    out = []
+    for i, (bank, reg, val) in enumerate(writes):
+        key = (bank, reg)
+        if key in SEQUENCE:
+            out.append((bank, reg, val))
+            continue
+        if key in BARRIER:
+            out.append((bank, reg, val))
+            for k in list(known):
+                if k[0] == bank and k != key:
+                    del known[k]
+            known[key] = val
+            continue
+        if last[key] != i:
+            continue                                    #dead, written again later
+        if known.get(key) == val:
+            continue                                    #redundant, value already there
+        known[key] = val
+        out.append((bank, reg, val))
+    return out
+
+
+def final_state(writes):
+    #{(bank, reg): value} after a banked stream, indirect PORTS excluded
+    state = {}
+    for bank, reg, val in writes:
+        if (bank, reg) not in PORTS:
+            state[(bank, reg)] = val
+    return state
+
+
+def changed_keys(from_writes, to_writes):
+    #registers whose value after to_writes differs from the value after from_writes.
+    #Registers only the old resolution sets keep their value, as they do when the full
+    #resolution table is written
+    old = final_state(from_writes)
+    new = final_state(to_writes)
+    return [key for key in new if old.get(key) != new[key] and key != (0, 0xE0)]
+
+
+def delta(from_writes, to_writes, to_table):
+    #Banked stream that takes the registers from the end of from_writes to the end of
+    #to_writes
+    new = final_state(to_writes)
+    changed = changed_keys(from_writes, to_writes)
+    if not changed:
+        return []
+    if any(key in BARRIER for key in changed):
+        #mode change, the sensor bank is replayed like a cold init of that resolution
+        out = [w for w in optimize(to_writes) if w[0] == 1]
+    else:
+        out = [(1, reg, new[(1, reg)]) for bank, reg in order(changed, to_table) if bank == 1]
+    out += dsp_writes([key for key in changed if key[0] == 0], new, to_table)
+    return out
+
+
+def dsp_writes(keys, new, to_table):
+    #DSP bank writes of keys, inside the RESET bracket of the resolution table
+    dsp = [(0, reg, new[(0, reg)]) for bank, reg in order(keys, to_table)]
+    bracket = [val for bank, reg, val in to_table if (bank, reg) == (0, 0xE0)]
+    if dsp and bracket:
+        dsp = [(0, 0xE0, bracket[0])] + dsp + [(0, 0xE0, bracket[-1])]
+    return dsp
+
+
+def full_table(from_writes, to_writes, to_table):
+    #The full resolution table, followed by the registers it leaves different from the
+    #cold init of the new resolution (clock setup of the larger sizes)
+    new = final_state(to_writes)
+    covered = set((bank, reg) for bank, reg, val in to_table)
+    missed = [key for key in changed_keys(from_writes, to_writes) if key not in covered]
+    out = list(to_table)
+    out += [(1, reg, new[(1, reg)]) for bank, reg in order(missed, to_table) if bank == 1]
+    out += dsp_writes([key for key in missed if key[0] == 0], new, to_table)
+    return out
+
+
+def order(keys, table):
+    #keys in the order the resolution table writes them, the rest after
+    position = {}
+    for i, (bank, reg, val) in enumerate(table):
+        position.setdefault((bank, reg), i)
+    return sorted(keys, key=lambda k: (position.get(k, len(table)), k))
+
+
+def to_pairs(writes, bank=None):
+    #Raw register stream of a banked stream, bank selects only where the bank changes
+    pairs = []
+    for b, reg, val in writes:
+        if b != bank:
+            pairs.append((BANK_SELECT, b))
+            bank = b
+        pairs.append((reg, val))
+    return pairs
+
+
+def c_table(name, pairs, comment):
+    lines = ['/* %s */' % comment, 'const struct sensor_reg %s[]  =' % name, '{']
+    for reg, val in pairs:
+        lines.append('\t{0x%02x, 0x%02x},' % (reg, val))
+    lines.append('\t{0xff, 0xff},')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def generate(tables):
+    cold = []
+    for item in COLD_INIT:
+        cold += tables[item] if isinstance(item, str) else item
+
+    res_tables = {}
+    streams = {}
+    for res in RESOLUTIONS:
+        raw = tables['OV2640_%s_JPEG' % res]
+        res_tables[res] = banked(raw)
+        ports = [w for w in res_tables[res] if (w[0], w[1]) in PORTS]
+        if ports:
+            raise ValueError('%s writes indirect ports, deltas can not model them' % res)
+        streams[res] = banked(cold + raw)
+
+    report = []
+    out = []
+    for res in RESOLUTIONS:
+        pairs = to_pairs(optimize(streams[res]))
+        before = len(cold) + len(tables['OV2640_%s_JPEG' % res])
+        report.append('cold init %-9s %4d -> %4d writes' % (res, before, len(pairs)))
+        out.append(c_table('OV2640_INIT_%s' % res, pairs, 'Cold init, JPEG %s, %d writes instead of %d' % (res, len(pairs), before)))
+
+    names = []
+    for a in RESOLUTIONS:
+        row = []
+        for b in RESOLUTIONS:
+            name = 'OV2640_DELTA_%s_%s' % (a, b)
+            if a == b:
+                row.append('0')
+                continue
+            full = tables['OV2640_%s_JPEG' % b]
+            d = to_pairs(delta(streams[a], streams[b], res_tables[b]))
+            f = to_pairs(full_table(streams[a], streams[b], res_tables[b]))
+            if f == full and len(f) <= len(d):
+                report.append('delta %-9s -> %-9s full table, %d writes' % (a, b, len(full)))
+                row.append('OV2640_%s_JPEG' % b)
+                continue
+            if len(f) < len(d):
+                pairs = f
+                comment = '%s -> %s, full table and the registers it misses' % (a, b)
+            else:
+                pairs = d
+                comment = '%s -> %s' % (a, b)
+            report.append('delta %-9s -> %-9s %4d writes (full table %d)' % (a, b, len(pairs), len(full)))
+            out.append(c_table(name, pairs, comment))
+            row.append(name)
+        names.append(row)
+
+    index = ['/* Resolution switch tables, [from][to] in OV2640_RES_* order, 0 on the diagonal.',
+             ' * Switches the full table of ov2640_regs.h does on its own use it */',
+             'const struct sensor_reg *const ov2640_delta[%d][%d] = {' % (len(RESOLUTIONS), len(RESOLUTIONS))]
+    for i, row in enumerate(names):
+        index.append('\t{ ' + ', '.join(row) + ' }' + (',' if i < len(names) - 1 else ''))
+    index.append('};')
+    init = ['/* Cold init tables, OV2640_RES_* order */',
+            'const struct sensor_reg *const ov2640_init[%d] = {' % len(RESOLUTIONS)]
+    init.append(',\n'.join('\tOV2640_INIT_%s' % res for res in RESOLUTIONS))
+    init.append('};')
+
+    header = ['/* Generated by host_sim/ov2640_regs_gen.py from ov2640_regs.h, do not edit.',
+              ' * Dead and redundant writes of the cold init are dropped, resolution changes',
+              ' * only write the registers that differ. Include after ov2640_regs.h.',
+              ' */',
+              '',
+              '#ifndef OV2640_REGS_OPT_H_',
+              '#define OV2640_REGS_OPT_H_',
+              '']
+    text = '\n'.join(header) + '\n' + '\n\n'.join(out) + '\n\n' + '\n'.join(init) + '\n\n' + '\n'.join(index) + '\n\n#endif /* OV2640_REGS_OPT_H_ */\n'
+    return text, report
+
+
+def main(argv):
+    tables = load_tables(SOURCE)
+    text, report = generate(tables)
+    print('\n'.join(report))
+    if '--check' not in argv:
+        with open(OUTPUT, 'w') as f:
+            f.write(text.replace('\n', '\r\n'))
+        print('wrote ' + os.path.relpath(OUTPUT))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
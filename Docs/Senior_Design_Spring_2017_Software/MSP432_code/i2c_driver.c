@@ -34,6 +34,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "msp432.h"
+#include "energy.h"
 #include "i2c_driver.h"
 #include "driverlib.h"
 
@@ -42,27 +43,31 @@
 // Definitions
 //
 //*****************************************************************************
+#define I2C_DMA_CHANNEL 3						// DMA_CH3_EUSCIB1RX0
+#define I2C_DMA_MAX 1024						// items of one basic mode DMA transfer
 
 //*****************************************************************************
 //
 // Global Data
 //
 //*****************************************************************************
-volatile eUSCI_status ui8Status;
 
-uint8_t  *pData;
-uint8_t  ui8DummyRead;
-uint32_t g_ui32ByteCount;
-bool     burstMode = false;
+/* Transaction on the bus and the ones queued behind it, first to last */
+static I2C_TRANSACTION *head = 0;
+static I2C_TRANSACTION *tail = 0;
+static bool running = false;					// head is on the bus
+static uint32_t index;							// bytes of the current transaction done
+static bool nack;
 
-/* I2C Master Configuration Parameter */
-volatile eUSCI_I2C_MasterConfig i2cConfig =
+/* I2C Master Configuration Parameter, set once in initI2C(). STOP is generated
+ * by the engine, so the byte counter never has to be reprogrammed */
+eUSCI_I2C_MasterConfig i2cConfig =
 {
         EUSCI_B_I2C_CLOCKSOURCE_SMCLK,          // SMCLK Clock Source
 		0,
 		EUSCI_B_I2C_SET_DATA_RATE_100KBPS,      // Desired I2C Clock of 100khz
         0,                                      // No byte counter threshold
-        EUSCI_B_I2C_SEND_STOP_AUTOMATICALLY_ON_BYTECOUNT_THRESHOLD                // Autostop
+        EUSCI_B_I2C_NO_AUTO_STOP                // STOP from the interrupt
 };
 
 //*****************************************************************************
@@ -70,21 +75,20 @@ volatile eUSCI_I2C_MasterConfig i2cConfig =
 // Imported Data
 //
 //*****************************************************************************
-
-//*****************************************************************************
-//
-// Constants
-//
-//*****************************************************************************
+extern uint8_t controlTable[];					// DMA control table, xbee_driver.c
 
 //*****************************************************************************
 //
 // Function Prototypes
 //
 //*****************************************************************************
+static void start(I2C_TRANSACTION *t);
+static void finish(void);
 
 /***********************************************************
-  Function:
+  Function: initI2C
+  Configures EUSCI_B1 and the RX DMA channel once, transactions
+  only load the slave address
 */
 void initI2C(void)
 {
@@ -95,243 +99,161 @@ void initI2C(void)
     GPIO_setAsPeripheralModuleFunctionOutputPin(GPIO_PORT_P6, GPIO_PIN5 | GPIO_PIN4,
             GPIO_PRIMARY_MODULE_FUNCTION);
 
-    /* Initializing I2C Master to SMCLK at 400kbs with autostop */
-//    MAP_I2C_initMaster(EUSCI_B1_BASE, &i2cConfig);
+    /* Initializing I2C Master to SMCLK at 100kbs, no autostop */
+    MAP_I2C_disableModule(EUSCI_B1_BASE);
+    MAP_I2C_initMaster(EUSCI_B1_BASE, &i2cConfig);
+    MAP_I2C_enableModule(EUSCI_B1_BASE);
+    MAP_I2C_clearInterruptFlag(EUSCI_B1_BASE, EUSCI_B_I2C_STOP_INTERRUPT +
+    		EUSCI_B_I2C_NAK_INTERRUPT + EUSCI_B_I2C_TRANSMIT_INTERRUPT0 + EUSCI_B_I2C_RECEIVE_INTERRUPT0);
+    MAP_I2C_enableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_STOP_INTERRUPT + EUSCI_B_I2C_NAK_INTERRUPT);
+
+    /* RX DMA, shares the control table with the XBee UART (init_DMA sets it again later) */
+    MAP_DMA_enableModule();
+    MAP_DMA_setControlBase(controlTable);
+    MAP_DMA_assignChannel(DMA_CH3_EUSCIB1RX0);
+    MAP_DMA_setChannelControl(UDMA_PRI_SELECT | DMA_CH3_EUSCIB1RX0,
+            UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_1);
+    MAP_DMA_assignInterrupt(DMA_INT2, I2C_DMA_CHANNEL);
+    MAP_DMA_clearInterruptFlag(I2C_DMA_CHANNEL);
+    MAP_Interrupt_enableInterrupt(INT_DMA_INT2);
+
+    MAP_Interrupt_enableInterrupt(INT_EUSCIB1);
 }
 
 /***********************************************************
-  Function:
+  Function: i2c_submit
+  Queues a transaction and returns right away. t->status is
+  eUSCI_BUSY until the transaction is done, then eUSCI_SUCCESS
+  or eUSCI_NACK, and t->callback runs from the interrupt.
+  The transaction and its data belong to the engine until then
 */
-bool writeI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint8_t ui8ByteCount)
+void i2c_submit(I2C_TRANSACTION *t)
 {
-	/* Wait until ready to write */
-    while (MAP_I2C_isBusBusy(EUSCI_B1_BASE));
-
-	/* Assign Data to local Pointer */
-	pData = Data;
-
-    /* Disable I2C module to make changes */
-    MAP_I2C_disableModule(EUSCI_B1_BASE);
-
-	/* Setup the number of bytes to transmit + 1 to account for the register byte */
-    i2cConfig.byteCounterThreshold = ui8ByteCount + 1;
-    MAP_I2C_initMaster(EUSCI_B1_BASE, (const eUSCI_I2C_MasterConfig *)&i2cConfig);
+	bool masked = MAP_Interrupt_disableMaster();
 
-	/* Load device slave address */
-	MAP_I2C_setSlaveAddress(EUSCI_B1_BASE, ui8Addr);
-
-    /* Enable I2C Module to start operations */
-	MAP_I2C_enableModule(EUSCI_B1_BASE);
-
-  	/* Enable master STOP, TX and NACK interrupts */
-    MAP_I2C_enableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_STOP_INTERRUPT +
-    		EUSCI_B_I2C_NAK_INTERRUPT + EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
-
-    /* Set our local state to Busy */
-    ui8Status = eUSCI_BUSY;
-
-	/* Send start bit and register */
-  	MAP_I2C_masterSendMultiByteStart(EUSCI_B1_BASE,ui8Reg);
-
-  	/* Enable master interrupt for the remaining data */
-    MAP_Interrupt_enableInterrupt(INT_EUSCIB1);
-
-	// NOW WAIT FOR DATA BYTES TO BE SENT
-	while(ui8Status == eUSCI_BUSY)
-	{
-//#ifdef USE_LPM
-		MAP_PCM_gotoLPM0();
-//#else
-//		__no_operation();
-//#endif
-	}
-
-	/* Disable interrupts */
-	MAP_I2C_disableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_STOP_INTERRUPT +
-			EUSCI_B_I2C_NAK_INTERRUPT + EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
-    MAP_Interrupt_disableInterrupt(INT_EUSCIB1);
-
-	if(ui8Status == eUSCI_NACK)
-	{
-		return(false);
-	}
+	t->next = 0;
+	t->status = eUSCI_BUSY;
+	if(tail)
+		tail->next = t;
 	else
-	{
-		return(true);
-	}
+		head = t;
+	tail = t;
+	if(!running)
+		start(t);
+
+	if(!masked)
+		MAP_Interrupt_enableMaster();
 }
 
 /***********************************************************
-  Function:
+  Function: i2c_wait
+  Sleeps in LPM0 until a submitted transaction is done,
+  returns true if the slave acknowledged
 */
-bool readI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint8_t ui8ByteCount)
+bool i2c_wait(I2C_TRANSACTION *t)
 {
-	/* Todo: Put a delay */
-	/* Wait until ready */
-    while (MAP_I2C_isBusBusy(EUSCI_B1_BASE));
-
-	/* Assign Data to local Pointer */
-	pData = Data;
+	energy_mcu(ENERGY_MCU_LPM0);
+	for(;;) {
+		MAP_Interrupt_disableMaster();
+		if(t->status != eUSCI_BUSY)
+			break;
+		MAP_PCM_gotoLPM0();		// the pending EUSCI_B1 or DMA interrupt wakes the core
+		MAP_Interrupt_enableMaster();
+	}
+	MAP_Interrupt_enableMaster();
+	energy_mcu(ENERGY_MCU_ACTIVE);
 
-    /* Disable I2C module to make changes */
-    MAP_I2C_disableModule(EUSCI_B1_BASE);
+	return t->status == eUSCI_SUCCESS;
+}
 
-  	/* Setup the number of bytes to receive */
-    i2cConfig.byteCounterThreshold = ui8ByteCount;
-    i2cConfig.autoSTOPGeneration = EUSCI_B_I2C_SEND_STOP_AUTOMATICALLY_ON_BYTECOUNT_THRESHOLD;
-    MAP_I2C_initMaster(EUSCI_B1_BASE, (const eUSCI_I2C_MasterConfig *)&i2cConfig);
+// put the register address on the bus, the rest runs from the interrupts
+static void start(I2C_TRANSACTION *t)
+{
+	running = true;
+	index = 0;
+	nack = false;
 
 	/* Load device slave address */
-	MAP_I2C_setSlaveAddress(EUSCI_B1_BASE, ui8Addr);
-
-    /* Enable I2C Module to start operations */
-	MAP_I2C_enableModule(EUSCI_B1_BASE);
-
-  	/* Enable master STOP and NACK interrupts */
-    MAP_I2C_enableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_STOP_INTERRUPT +
-    		EUSCI_B_I2C_NAK_INTERRUPT);
+	MAP_I2C_setSlaveAddress(EUSCI_B1_BASE, t->addr);
 
-    /* Set our local state to Busy */
-    ui8Status = eUSCI_BUSY;
-
-  	/* Send start bit and register */
-  	MAP_I2C_masterSendMultiByteStart(EUSCI_B1_BASE,ui8Reg);
-
-  	/* Enable master interrupt for the remaining data */
-    MAP_Interrupt_enableInterrupt(INT_EUSCIB1);
+	/* Send start bit and register, TX interrupt once the register is in the shift register */
+  	MAP_I2C_masterSendMultiByteStart(EUSCI_B1_BASE, t->reg);
+    MAP_I2C_enableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
+}
 
-  	/* NOTE: If the number of bytes to receive = 1, then as target register is being shifted
-  	 * out during the write phase, UCBxTBCNT will be counted and will trigger STOP bit prematurely
-  	 * If count is > 1, wait for the next TXBUF empty interrupt (just after reg value has been
-  	 * shifted out
-  	 */
-	while(ui8Status == eUSCI_BUSY)
-	{
-		if(MAP_I2C_getInterruptStatus(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_INTERRUPT0))
-		{
-			ui8Status = eUSCI_IDLE;
-		}
-	}
+// STOP is on the bus: hand the result to the owner and start the next transaction
+static void finish(void)
+{
+	I2C_TRANSACTION *t = head;
 
-	ui8Status = eUSCI_BUSY;
+	MAP_I2C_disableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_INTERRUPT0 + EUSCI_B_I2C_RECEIVE_INTERRUPT0);
+	MAP_DMA_disableChannel(I2C_DMA_CHANNEL);
 
-  	/* Turn off TX and generate RE-Start */
-  	MAP_I2C_masterReceiveStart(EUSCI_B1_BASE);
+	head = t->next;
+	if(!head)
+		tail = 0;
+	running = false;
 
-  	/* Enable RX interrupt */
-    MAP_I2C_enableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_RECEIVE_INTERRUPT0);
+	t->status = nack ? eUSCI_NACK : eUSCI_SUCCESS;
+	if(t->callback)
+		t->callback(t);		// may submit the next transaction, which then starts right away
 
-	/* Wait for all data be received */
-	while(ui8Status == eUSCI_BUSY)
-	{
+	if(head && !running)
+		start(head);
+}
 
-#ifdef USE_LPM
-		MAP_PCM_gotoLPM0();
-#else
-		__no_operation();
-#endif
+// register sent on a read: repeated START in receive mode, bytes by DMA or RX interrupt
+static void start_receive(I2C_TRANSACTION *t)
+{
+	MAP_I2C_disableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
+
+	if(t->length > I2C_DMA_MIN && t->length - 1 <= I2C_DMA_MAX) {
+		/* all but the last byte by DMA, DMA_INT2 sets STOP before the last one is in */
+		MAP_DMA_setChannelTransfer(UDMA_PRI_SELECT | DMA_CH3_EUSCIB1RX0, UDMA_MODE_BASIC,
+				(void *)MAP_I2C_getReceiveBufferAddressForDMA(EUSCI_B1_BASE), t->data, t->length - 1);
+		MAP_DMA_enableChannel(I2C_DMA_CHANNEL);
+		index = t->length - 1;
+	  	MAP_I2C_masterReceiveStart(EUSCI_B1_BASE);
+		return;
 	}
 
-	/* Disable interrupts */
-	MAP_I2C_disableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_STOP_INTERRUPT +
-			EUSCI_B_I2C_NAK_INTERRUPT + EUSCI_B_I2C_RECEIVE_INTERRUPT0);
-    MAP_Interrupt_disableInterrupt(INT_EUSCIB1);
-
-	if(ui8Status == eUSCI_NACK)
-	{
-		return(false);
-	}
-	else
-	{
-		return(true);
+  	MAP_I2C_masterReceiveStart(EUSCI_B1_BASE);
+	if(t->length == 1) {
+		/* about two byte times at 100 kHz, the only wait in the engine */
+		/* STOP has to follow the address, the START flag clears once the address is acknowledged */
+		while(MAP_I2C_masterIsStartSent(EUSCI_B1_BASE) == EUSCI_B_I2C_SENDING_START
+				&& !MAP_I2C_getInterruptStatus(EUSCI_B1_BASE, EUSCI_B_I2C_NAK_INTERRUPT));
+		MAP_I2C_masterReceiveMultiByteStop(EUSCI_B1_BASE);
 	}
+    MAP_I2C_enableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_RECEIVE_INTERRUPT0);
 }
 
 /***********************************************************
-  Function:
+  Function: writeI2C, readI2C, readBurstI2C
+  Blocking forms for the SCCB code: submit and sleep until done
 */
-bool readBurstI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint32_t ui32ByteCount)
+bool writeI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint8_t ui8ByteCount)
 {
-	/* Todo: Put a delay */
-	/* Wait until ready */
-    while (MAP_I2C_isBusBusy(EUSCI_B1_BASE));
+	I2C_TRANSACTION t = { 0, ui8Addr, ui8Reg, I2C_WRITE, Data, ui8ByteCount, 0, 0 };
 
-	/* Assign Data to local Pointer */
-	pData = Data;
-
-    /* Disable I2C module to make changes */
-    MAP_I2C_disableModule(EUSCI_B1_BASE);
-
-  	/* Setup the number of bytes to receive */
-    i2cConfig.autoSTOPGeneration = EUSCI_B_I2C_NO_AUTO_STOP;
-    g_ui32ByteCount = ui32ByteCount;
-    burstMode = true;
-    MAP_I2C_initMaster(EUSCI_B1_BASE, (const eUSCI_I2C_MasterConfig *)&i2cConfig);
-
-	/* Load device slave address */
-	MAP_I2C_setSlaveAddress(EUSCI_B1_BASE, ui8Addr);
-
-    /* Enable I2C Module to start operations */
-	MAP_I2C_enableModule(EUSCI_B1_BASE);
-
-  	/* Enable master STOP and NACK interrupts */
-    MAP_I2C_enableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_STOP_INTERRUPT +
-    		EUSCI_B_I2C_NAK_INTERRUPT);
-
-    /* Set our local state to Busy */
-    ui8Status = eUSCI_BUSY;
-
-  	/* Send start bit and register */
-  	MAP_I2C_masterSendMultiByteStart(EUSCI_B1_BASE,ui8Reg);
-
-  	/* Enable master interrupt for the remaining data */
-    MAP_Interrupt_enableInterrupt(INT_EUSCIB1);
-
-  	/* NOTE: If the number of bytes to receive = 1, then as target register is being shifted
-  	 * out during the write phase, UCBxTBCNT will be counted and will trigger STOP bit prematurely
-  	 * If count is > 1, wait for the next TXBUF empty interrupt (just after reg value has been
-  	 * shifted out
-  	 */
-	while(ui8Status == eUSCI_BUSY)
-	{
-		if(MAP_I2C_getInterruptStatus(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_INTERRUPT0))
-		{
-			ui8Status = eUSCI_IDLE;
-		}
-	}
-
-	ui8Status = eUSCI_BUSY;
-
-  	/* Turn off TX and generate RE-Start */
-  	MAP_I2C_masterReceiveStart(EUSCI_B1_BASE);
-
-  	/* Enable RX interrupt */
-    MAP_I2C_enableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_RECEIVE_INTERRUPT0);
+	i2c_submit(&t);
+	return i2c_wait(&t);
+}
 
-	/* Wait for all data be received */
-	while(ui8Status == eUSCI_BUSY)
-	{
+bool readI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint8_t ui8ByteCount)
+{
+	I2C_TRANSACTION t = { 0, ui8Addr, ui8Reg, I2C_READ, Data, ui8ByteCount, 0, 0 };
 
-#ifdef USE_LPM
-		MAP_PCM_gotoLPM0();
-#else
-		__no_operation();
-#endif
-	}
+	i2c_submit(&t);
+	return i2c_wait(&t);
+}
 
-	/* Disable interrupts */
-	MAP_I2C_disableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_STOP_INTERRUPT +
-			EUSCI_B_I2C_NAK_INTERRUPT + EUSCI_B_I2C_RECEIVE_INTERRUPT0);
-    MAP_Interrupt_disableInterrupt(INT_EUSCIB1);
+bool readBurstI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint32_t ui32ByteCount)
+{
+	I2C_TRANSACTION t = { 0, ui8Addr, ui8Reg, I2C_READ, Data, ui32ByteCount, 0, 0 };
 
-	if(ui8Status == eUSCI_NACK)
-	{
-		return(false);
-	}
-	else
-	{
-		return(true);
-	}
+	i2c_submit(&t);
+	return i2c_wait(&t);
 }
 
 /***********************************************************
@@ -339,62 +261,63 @@ bool readBurstI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint32_t ui32B
  */
 void EUSCIB1_IRQHandler(void)
 {
+    I2C_TRANSACTION *t = head;
     uint_fast16_t status;
 
     status = MAP_I2C_getEnabledInterruptStatus(EUSCI_B1_BASE);
     MAP_I2C_clearInterruptFlag(EUSCI_B1_BASE, status);
 
+    if(!t)
+    	return;
+
     if (status & EUSCI_B_I2C_NAK_INTERRUPT)
     {
-    	/* Generate STOP when slave NACKS */
+    	/* Generate STOP when slave NACKS, the transaction ends on the STOP interrupt */
+    	MAP_DMA_disableChannel(I2C_DMA_CHANNEL);
+        MAP_I2C_disableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_INTERRUPT0 + EUSCI_B_I2C_RECEIVE_INTERRUPT0);
         MAP_I2C_masterSendMultiByteStop(EUSCI_B1_BASE);
-
-    	/* Clear any pending TX interrupts */
-    	MAP_I2C_clearInterruptFlag(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
-
-        /* Set our local state to NACK received */
-        ui8Status = eUSCI_NACK;
-    }
-
-    if (status & EUSCI_B_I2C_START_INTERRUPT)
-    {
-        /* Change our local state */
-        ui8Status = eUSCI_START;
+        nack = true;
     }
-
-    if (status & EUSCI_B_I2C_STOP_INTERRUPT)
+    else if (status & EUSCI_B_I2C_TRANSMIT_INTERRUPT0)
     {
-        /* Change our local state */
-        ui8Status = eUSCI_STOP;
+    	if(t->direction == I2C_READ)
+    		start_receive(t);
+    	else if(index < t->length)
+    		MAP_I2C_masterSendMultiByteNext(EUSCI_B1_BASE, t->data[index++]);	// send the next data
+    	else {
+    		/* last byte is in the shift register */
+            MAP_I2C_disableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
+    		MAP_I2C_masterSendMultiByteStop(EUSCI_B1_BASE);
+    	}
     }
 
     if (status & EUSCI_B_I2C_RECEIVE_INTERRUPT0)
     {
-    	/* RX data */
-    	*pData++ = MAP_I2C_masterReceiveMultiByteNext(EUSCI_B1_BASE);
-    	ui8DummyRead= MAP_I2C_masterReceiveMultiByteNext(EUSCI_B1_BASE);
-
-    	if (burstMode)
-    	{
-    		g_ui32ByteCount--;
-    		if (g_ui32ByteCount == 1)
-    		{
-    			burstMode = false;
-
-    			/* Generate STOP */
-    	        MAP_I2C_masterSendMultiByteStop(EUSCI_B1_BASE);
-    		}
-    	}
+    	/* RX data, STOP goes out while the last byte is received */
+    	t->data[index++] = MAP_I2C_masterReceiveMultiByteNext(EUSCI_B1_BASE);
+    	if(t->length >= 2 && index == t->length - 1)
+	        MAP_I2C_masterReceiveMultiByteStop(EUSCI_B1_BASE);
+    	if(index == t->length)
+            MAP_I2C_disableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_RECEIVE_INTERRUPT0);
     }
 
-    if (status & EUSCI_B_I2C_TRANSMIT_INTERRUPT0)
+    if (status & EUSCI_B_I2C_STOP_INTERRUPT)
     {
-    	/* Send the next data */
-    	MAP_I2C_masterSendMultiByteNext(EUSCI_B1_BASE, *pData++);
+    	finish();
     }
-
-#ifdef USE_LPM
-    MAP_Interrupt_disableSleepOnIsrExit();
-#endif
 }
 
+/***********************************************************
+  Function: DMA_INT2_IRQHandler
+  DMA has all but the last byte of a read
+ */
+void DMA_INT2_IRQHandler(void)
+{
+	MAP_DMA_clearInterruptFlag(I2C_DMA_CHANNEL);
+
+	if(!head || nack)
+		return;
+
+	MAP_I2C_masterReceiveMultiByteStop(EUSCI_B1_BASE);
+    MAP_I2C_enableInterrupt(EUSCI_B1_BASE, EUSCI_B_I2C_RECEIVE_INTERRUPT0);
+}
@@ -35,6 +35,9 @@
 #ifndef _I2C_DRIVER_H_
 #define _I2C_DRIVER_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
 //****************************************************************************
 //
 // Types
@@ -49,11 +52,30 @@ typedef enum {
 	eUSCI_START
 } eUSCI_status;
 
+#define I2C_WRITE 0
+#define I2C_READ 1
+
+/* One register access: START, slave address, register, then the data written, or a
+ * repeated START and the data read. Queued with i2c_submit(), the memory belongs to
+ * the caller and must stay valid until status leaves eUSCI_BUSY */
+typedef struct _i2c_transaction {
+	struct _i2c_transaction *next;
+	uint8_t addr;
+	uint8_t reg;
+	uint8_t direction;		// I2C_WRITE or I2C_READ
+	uint8_t *data;
+	uint32_t length;
+	void (*callback)(struct _i2c_transaction *t);	// runs in the interrupt when done, may be 0
+	void *arg;
+	volatile eUSCI_status status;
+} I2C_TRANSACTION;
+
 //*****************************************************************************
 //
 // Definitions
 //
 //*****************************************************************************
+#define I2C_DMA_MIN 4			// reads longer than this go through DMA
 
 //*****************************************************************************
 //
@@ -67,6 +89,8 @@ typedef enum {
 //
 //*****************************************************************************
 extern void initI2C(void);
+extern void i2c_submit(I2C_TRANSACTION *t);
+extern bool i2c_wait(I2C_TRANSACTION *t);
 extern bool writeI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint8_t ui8ByteCount);
 extern bool readI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint8_t ui8ByteCount);
 extern bool readBurstI2C(uint8_t ui8Addr, uint8_t ui8Reg, uint8_t *Data, uint32_t ui32ByteCount);
@@ -0,0 +1,51 @@
+/* DriverLib Includes */
+#include "driverlib.h"
+
+/* Standard Includes */
+#include <stdint.h>
+#include "image_header.h"
+#include "node_cmd.h"
+#include "sw_timer.h"
+#include "xbee_driver.h"
+
+// store a 32-bit value big-endian
+static void put32(uint8_t *p, uint32_t value) {
+	p[0] = value >> 24;
+	p[1] = value >> 16;
+	p[2] = value >> 8;
+	p[3] = value;
+}
+
+/* Function that seeds the CRC32 module for an image, the bytes are fed in
+ * by spi_Read_crc32() while they come out of the Arducam FIFO */
+void image_crc32_start() {
+	MAP_CRC32_setSeed(0xFFFFFFFF, CRC32_MODE);
+}
+
+/* Function that returns the CRC-32 of the bytes fed since image_crc32_start().
+ * Bytes written to CRC32DI are taken LSB first, so the result register already
+ * holds the reflected CRC, only the final inversion is left */
+uint32_t image_crc32_result() {
+	return MAP_CRC32_getResult(CRC32_MODE) ^ 0xFFFFFFFF;
+}
+
+/* Function that fills the IMAGE_HEADER_LEN bytes in front of an image
+ * length   --- JPEG bytes after the header
+ * crc32    --- image_crc32_result() of those bytes
+ * captured --- sw_timer_now() when the capture started */
+void image_build_header(uint8_t header[], uint32_t length, uint32_t crc32, uint32_t captured) {
+	uint16_t crc;
+
+	header[0] = IMAGE_MARKER;
+	header[1] = IMAGE_HEADER_VERSION;
+	put32(&header[2], xbee_node_id);
+	put32(&header[6], sw_timer_ms(captured));
+	header[10] = node_config.resolution;
+	header[11] = node_config.quality;
+	put32(&header[12], length);
+	put32(&header[16], crc32);
+
+	crc = node_cmd_crc(header, 20);
+	header[20] = crc >> 8;
+	header[21] = crc & 0xFF;
+}
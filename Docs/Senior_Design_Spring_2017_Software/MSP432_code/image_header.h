@@ -0,0 +1,31 @@
+/*
+ * image_header.h
+ *
+ * Header sent in front of every JPEG image, all fields big-endian:
+ *   0      IMAGE_MARKER, the coordinator knows an image follows
+ *   1      IMAGE_HEADER_VERSION
+ *   2..5   node ID, serial number low of the XBee module
+ *   6..9   capture time, ms since the node was reset
+ *   10     resolution (OV2640_RES_*) of the full frame, a PIR zone capture is a
+ *          window of it, the SOF of the JPEG has the real size
+ *   11     JPEG quantization scale
+ *   12..15 payload length, JPEG bytes after the header
+ *   16..19 CRC-32 of the payload, same value as binascii.crc32() / zlib
+ *   20..21 CRC-16/CCITT of bytes 0..19 (node_cmd_crc)
+ * The JPEG follows unchanged, starting with the FF D8 of SOI.
+ */
+
+#ifndef IMAGE_HEADER_H_
+#define IMAGE_HEADER_H_
+
+#include <stdint.h>
+
+#define IMAGE_MARKER 0x10
+#define IMAGE_HEADER_VERSION 1
+#define IMAGE_HEADER_LEN 22
+
+void image_crc32_start();
+uint32_t image_crc32_result();
+void image_build_header(uint8_t header[], uint32_t length, uint32_t crc32, uint32_t captured);
+
+#endif /* IMAGE_HEADER_H_ */
@@ -0,0 +1,37 @@
+/* Standard Includes */
+#include <stdint.h>
+#include "jpeg_rate.h"
+
+/* Estimated size * QS of the scene at the current resolution, 0 = no frame yet */
+static uint32_t complexity = 0;
+
+/* Function that forgets the frames seen so far, call after a resolution change */
+void jpeg_rate_reset() {
+	complexity = 0;
+}
+
+/* Function that returns the QS for the next frame
+ * size    --- FIFO size of the frame just captured, also when it was over the budget
+ * quality --- QS that frame was captured with
+ * budget  --- bytes a frame may take */
+uint8_t jpeg_rate_update(uint32_t size, uint8_t quality, uint32_t budget) {
+	uint32_t sample = size * quality;
+	uint32_t target = JPEG_RATE_TARGET(budget);
+	uint32_t next;
+
+	// a more complex scene is taken right away, a simpler one is averaged in, no oscillation
+	if(complexity == 0 || sample > complexity)
+		complexity = sample;
+	else
+		complexity -= (complexity - sample) / 2;
+
+	next = (complexity + target - 1) / target;
+	if(size > budget && next <= quality)
+		next = quality + 1;					// over the budget, never capture it again as it was
+
+	if(next < JPEG_RATE_QS_MIN)
+		next = JPEG_RATE_QS_MIN;
+	if(next > JPEG_RATE_QS_MAX)
+		next = JPEG_RATE_QS_MAX;
+	return next;
+}
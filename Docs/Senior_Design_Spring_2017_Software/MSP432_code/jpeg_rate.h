@@ -0,0 +1,29 @@
+/*
+ * jpeg_rate.h
+ *
+ * Closed-loop control of the JPEG size through the OV2640 quantization scale
+ * (QS, DSP register 0x44). The JPEG size of a frame is close to inversely
+ * proportional to QS, so size * QS estimates the complexity of the scene. The
+ * estimate follows the FIFO sizes of the frames captured at the current
+ * resolution, and the next QS is the smallest one expected to keep the frame
+ * under JPEG_RATE_TARGET(budget).
+ *
+ * A frame over the budget is not read out of the Arducam FIFO. Its size still
+ * updates the estimate and the frame is captured again with the larger QS.
+ */
+
+#ifndef JPEG_RATE_H_
+#define JPEG_RATE_H_
+
+#include <stdint.h>
+
+#define JPEG_RATE_DEFAULT_BUDGET 24000			// bytes, about 2.5 s of image at 115200 baud
+#define JPEG_RATE_TARGET(budget) ((budget) - (budget) / 8)	// headroom for the scene changing between frames
+#define JPEG_RATE_RETRIES 3						// captures of a frame over the budget before it is dropped
+#define JPEG_RATE_QS_MIN 1
+#define JPEG_RATE_QS_MAX 63
+
+void jpeg_rate_reset();
+uint8_t jpeg_rate_update(uint32_t size, uint8_t quality, uint32_t budget);
+
+#endif /* JPEG_RATE_H_ */
@@ -4,9 +4,11 @@
 #include "spi_driver.h"
 #include "xbee_driver.h"
 #include "motion_sensor.h"
-
-// Array where image is stored
-extern uint8_t image_buffer[];
+#include "fpga_ecc.h"
+#include "rekey.h"
+#include "node_cmd.h"
+#include "sw_timer.h"
+#include "flash_log.h"
 
 // XBee UART buffer
 extern uint8_t RXBuffer[];
@@ -14,62 +16,108 @@ extern uint8_t RXBuffer[];
 // Capture_req flag, set by PIR motion sensor ISR
 unsigned char capture_req = 0;
 
-/* Function that changes SMCLK to 12MHz for use with XBee UART
- * ---- 12MHz not necessary, however was used during our development
- * ---- if changing from 12MHz need to recalculate UART baud rate register
+// PIR zones that fired since the last capture (motion_sensor.h)
+volatile uint8_t capture_zones = 0;
+
+// Wakes the main loop to check RXBuffer, the UART DMA does not interrupt
+#define MAIN_POLL_MS 10
+SW_TIMER main_poll;
+
+/* Function that sets up the clock tree
+ * ---- MCLK = DCO = 24MHz
+ * ---- SMCLK = DCO / 2 = 12MHz for the XBee UART, SPI, I2C and the OV2640 clock
+ * ---- ACLK = REFO = 32.768kHz for the software timers
+ * ---- if changing SMCLK need to recalculate the UART baud rate table in xbee_driver.c
  * http://software-dl.ti.com/msp430/msp430_public_sw/mcu/msp430/MSP430BaudRateConverter/index.html
  */
-void init_SMCLK() {
-	/* Setting SMCLK to 12MHz to use for UART with XBEE */
-	MAP_CS_initClockSignal(CS_SMCLK, CS_MODOSC_SELECT, CS_CLOCK_DIVIDER_2);
+void init_clocks() {
+	/* 24 MHz is the highest MCLK at VCORE0, the core voltage after reset, and needs one
+	 * flash wait state. Voltage and wait states are set before MCLK gets faster */
+	MAP_PCM_setCoreVoltageLevel(PCM_VCORE0);
+	MAP_FlashCtl_setWaitState(FLASH_BANK0, FLASH_WAIT_STATES);
+	MAP_FlashCtl_setWaitState(FLASH_BANK1, FLASH_WAIT_STATES);
+
+	MAP_CS_setDCOCenteredFrequency(CS_DCO_FREQUENCY_24);
+	MAP_CS_initClockSignal(CS_MCLK, CS_DCOCLK_SELECT, CS_CLOCK_DIVIDER_1);
+	MAP_CS_initClockSignal(CS_SMCLK, CS_DCOCLK_SELECT, CS_CLOCK_DIVIDER_2);
+	MAP_CS_initClockSignal(CS_ACLK, CS_REFOCLK_SELECT, CS_CLOCK_DIVIDER_1);
 }
 
 int main(void) {
-	int size = 0;
-
     /* Stop WDT  */
     MAP_WDT_A_holdTimer();
 
-    init_SMCLK();	// initialize/start the clock signal to be provided to the OV2640
+    sw_timer_init();	// time base for all delays and timeouts (Timer_A1, ACLK)
+    MAP_Interrupt_enableMaster();	// the delays below sleep until the timer interrupt
+
+    init_clocks();	// clock tree, SMCLK also clocks the OV2640
 
     init_ov2640();	// initialize OV2640 CMOS sensor -- JPEG output, 640x480
 
     spi_init();		// initialize SPI for communication with the FPGA and FIFO of the Arducam
 
+    fpga_ecc_init(FPGA_ECC_MODE_DONE);	// time base and done line interrupt (P2.6) for the FPGA ECC core
+
 	init_XBEE();	// setup UART and wait for XBee module to join the network
 
-    motion_sensor_init();	// initial motion sensor on P3.0 -- interrupt on
+    motion_sensor_init();	// initial the PIR zone inputs on port 3 -- interrupt on
 
-    MAP_Interrupt_enableMaster();	// enable global interrupts
+	flash_log_init();	// images still queued in flash from before the reset are sent first
 
 	new_read();		// call function to set RXBuffer index = 0
 
+	sw_timer_start(&main_poll, MAIN_POLL_MS, MAIN_POLL_MS, 0, 0);
+
 	// While loop that waits for XBee command via UART
 	while (1) {
 		//MAP_PCM_gotoLPM4();	-- need to add LPM3.5, wake-up via RTC every 30 seconds
+		rekey_poll();	// advance an FPGA rekey in flight, the loop keeps serving commands meanwhile
+		node_cmd_poll();	// run a binary command received in an earlier pass
+		flash_log_poll();	// send queued images, retried with backoff until the coordinator acknowledges
+
 		if(RXBuffer[0] != 0x00) {	// check if the RXBuffer has new data (via UART from XBee)
+			if(RXBuffer[0] == NODE_CMD_SOF) {	// binary command frame, checked and queued for node_cmd_poll()
+				node_cmd_receive();
+			}
 			if(RXBuffer[0] == '2') {	// session key request
 				motion_sensor_disable();	// disable motion sensor interrupts
 				set_session_key();
 				motion_sensor_enable();		// re-enable motion sensor interrupts
 			}
+			if(RXBuffer[0] == '3') {	// ElGamal rekey, R and C follow as binary points
+				motion_sensor_disable();	// disable motion sensor interrupts
+				if(wait_bytes(1 + REKEY_FRAME_LEN))	// payload can contain 0x0D, so wait on the byte count
+					rekey_start(&RXBuffer[1]);	// FPGA engine returns right away and finishes in rekey_poll()
+				motion_sensor_enable();		// re-enable motion sensor interrupts
+			}
+			if(RXBuffer[0] == '4') {	// rekey benchmark, time both engines on the R and C that follow
+				motion_sensor_disable();	// disable motion sensor interrupts
+				if(wait_bytes(1 + REKEY_FRAME_LEN)) {
+					REKEY_BENCH bench;
+					char report[REKEY_REPORT_LEN];
+
+					rekey_benchmark(&RXBuffer[1], &bench);
+					transmit_array(report, rekey_benchmark_report(&bench, report));
+				}
+				motion_sensor_enable();		// re-enable motion sensor interrupts
+			}
 			if(RXBuffer[0] == '5') {	// capture image request
 				motion_sensor_disable();	// disable motion sensor interrupts
-				size = capture_image();		// call capture image function, which returns the image size and fill image_buffer
-				image_buffer[0] = 0x10;		// set the first byte = 0x10 to indicate to ZigBee coord. image is being transmitted
-				transmit_image(image_buffer, size+1);	// transmit image of size given by capture_image
+				node_capture(1);	// capture an image and transmit it, the header (image_header.h) starts with 0x10 so the ZigBee coord. knows an image follows
 				motion_sensor_enable();		// re-enable motion sensor interrupts
 			}
 			new_read();		// reset RXBuffer values and index
 		}
 		else if(capture_req == 1) {		// check if the PIR interrupts
 			motion_sensor_disable();	// disable motion sensor interrupts, while capturing and transmitting
-			size = capture_image();		// capture image
-			image_buffer[0] = 0x10;		// set the first byte of the image = 0x10, so the coordinator knows end dev. is sending an image
-			transmit_image(image_buffer, size+1);	// transmit the image
+			node_capture_zones(node_config.burst, capture_zones);	// capture and transmit the configured number of images of the zones that fired
 			capture_req = 0;	// reset capture request flag
+			capture_zones = 0;
 			motion_sensor_enable();		// re-enable PIR interrupts after image has finished sending
 		}
+		else {
+			sw_timer_idle();	// nothing to do, sleep in LPM0 until the poll timer, PIR or FPGA interrupt
+		}
 	}
 
 }
@@ -82,7 +130,8 @@ void PORT3_IRQHandler(void)
     status = MAP_GPIO_getEnabledInterruptStatus(GPIO_PORT_P3);
     MAP_GPIO_clearInterruptFlag(GPIO_PORT_P3, status);
 
-    if(status & GPIO_PIN0) {
+    if(motion_sensor_zones(status)) {
+    	capture_zones |= motion_sensor_zones(status);	// zones of the frame to capture
     	capture_req = 1;	// if motion sensor interrupt, set capture_req flag
     }
 }
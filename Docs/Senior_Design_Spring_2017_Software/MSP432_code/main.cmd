@@ -40,7 +40,9 @@
 
 MEMORY
 {
-    MAIN       (RX) : origin = 0x00000000, length = 0x00040000
+    MAIN       (RX) : origin = 0x00000000, length = 0x0001F000
+    NET_STATE  (R)  : origin = 0x0001F000, length = 0x00001000    /* last sector of bank 0, net_state.c */
+    IMAGE_LOG  (R)  : origin = 0x00020000, length = 0x00020000    /* bank 1, flash_log.c */
     INFO       (RX) : origin = 0x00200000, length = 0x00004000
     SRAM_CODE  (RWX): origin = 0x01000000, length = 0x00010000
     SRAM_DATA  (RW) : origin = 0x20000000, length = 0x00010000
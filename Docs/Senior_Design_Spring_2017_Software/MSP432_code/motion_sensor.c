@@ -1,21 +1,67 @@
 #include "driverlib.h"
+#include "motion_sensor.h"
+
+/* Quadrants of the frame, zone 0 is the original PIR on P3.0 */
+const MOTION_ZONE motion_zones[MOTION_ZONE_COUNT] = {
+	{ GPIO_PIN0, 0, 0, 4, 4 },		// top left
+	{ GPIO_PIN5, 4, 0, 4, 4 },		// top right
+	{ GPIO_PIN6, 0, 4, 4, 4 },		// bottom left
+	{ GPIO_PIN7, 4, 4, 4, 4 }		// bottom right
+};
+
+#define MOTION_PINS (GPIO_PIN0 | GPIO_PIN5 | GPIO_PIN6 | GPIO_PIN7)
 
 void motion_sensor_init() {
-    /* Configuring P3.0 as an input and enabling interrupts */
-    MAP_GPIO_setAsInputPinWithPullUpResistor(GPIO_PORT_P3, GPIO_PIN0);
-    MAP_GPIO_clearInterruptFlag(GPIO_PORT_P3, GPIO_PIN0);
-    MAP_GPIO_enableInterrupt(GPIO_PORT_P3, GPIO_PIN0);
+    /* Configuring the PIR inputs on port 3 and enabling interrupts */
+    MAP_GPIO_setAsInputPinWithPullUpResistor(GPIO_PORT_P3, MOTION_PINS);
+    MAP_GPIO_clearInterruptFlag(GPIO_PORT_P3, MOTION_PINS);
+    MAP_GPIO_enableInterrupt(GPIO_PORT_P3, MOTION_PINS);
     MAP_Interrupt_enableInterrupt(INT_PORT3);
 }
 
 void motion_sensor_disable() {
-    MAP_GPIO_clearInterruptFlag(GPIO_PORT_P3, GPIO_PIN0);
-    MAP_GPIO_disableInterrupt(GPIO_PORT_P3, GPIO_PIN0);
+    MAP_GPIO_clearInterruptFlag(GPIO_PORT_P3, MOTION_PINS);
+    MAP_GPIO_disableInterrupt(GPIO_PORT_P3, MOTION_PINS);
     MAP_Interrupt_disableInterrupt(INT_PORT3);
 }
 
 void motion_sensor_enable() {
-    MAP_GPIO_clearInterruptFlag(GPIO_PORT_P3, GPIO_PIN0);
-    MAP_GPIO_enableInterrupt(GPIO_PORT_P3, GPIO_PIN0);
+    MAP_GPIO_clearInterruptFlag(GPIO_PORT_P3, MOTION_PINS);
+    MAP_GPIO_enableInterrupt(GPIO_PORT_P3, MOTION_PINS);
     MAP_Interrupt_enableInterrupt(INT_PORT3);
 }
+
+/* Function that returns the zone mask (bit n = motion_zones[n]) of a port 3 interrupt status */
+uint8_t motion_sensor_zones(uint32_t status) {
+	uint8_t zones = 0;
+	int i;
+
+	for(i = 0; i < MOTION_ZONE_COUNT; i++)
+		if(status & motion_zones[i].pin)
+			zones |= 1 << i;
+	return zones;
+}
+
+/* Function that returns the rectangle around all zones of a mask, in eighths of the frame.
+ * An empty mask gives the whole frame */
+void motion_sensor_window(uint8_t zones, uint8_t *x, uint8_t *y, uint8_t *w, uint8_t *h) {
+	uint8_t x0 = 8, y0 = 8, x1 = 0, y1 = 0;
+	int i;
+
+	for(i = 0; i < MOTION_ZONE_COUNT; i++) {
+		if(!(zones & (1 << i)))
+			continue;
+		if(motion_zones[i].x < x0) x0 = motion_zones[i].x;
+		if(motion_zones[i].y < y0) y0 = motion_zones[i].y;
+		if(motion_zones[i].x + motion_zones[i].w > x1) x1 = motion_zones[i].x + motion_zones[i].w;
+		if(motion_zones[i].y + motion_zones[i].h > y1) y1 = motion_zones[i].y + motion_zones[i].h;
+	}
+	if(x1 <= x0 || y1 <= y0) {
+		x0 = y0 = 0;
+		x1 = y1 = 8;
+	}
+	*x = x0;
+	*y = y0;
+	*w = x1 - x0;
+	*h = y1 - y0;
+}
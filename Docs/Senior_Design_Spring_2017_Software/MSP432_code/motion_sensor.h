@@ -3,13 +3,32 @@
  *
  *  Created on: May 6, 2017
  *      Author: Logan
+ *
+ * PIR sensors on port 3, each one watching a zone of the camera's field of view.
+ * A trigger captures only the window around the zones that fired (ov2640_set_window).
+ * Zone rectangles are in eighths of the frame, the PIRs are mounted to match.
  */
 
 #ifndef MOTION_SENSOR_H_
 #define MOTION_SENSOR_H_
 
+#include <stdint.h>
+
+#define MOTION_ZONE_COUNT 4
+#define MOTION_ZONES_ALL ((1 << MOTION_ZONE_COUNT) - 1)
+
+/* PIR input and the part of the frame it covers */
+typedef struct _motion_zone {
+	uint16_t pin;				// GPIO_PINx on port 3
+	uint8_t x, y, w, h;			// eighths of the frame
+} MOTION_ZONE;
+
+extern const MOTION_ZONE motion_zones[MOTION_ZONE_COUNT];
+
 void motion_sensor_init();
 void motion_sensor_disable();
 void motion_sensor_enable();
+uint8_t motion_sensor_zones(uint32_t status);
+void motion_sensor_window(uint8_t zones, uint8_t *x, uint8_t *y, uint8_t *w, uint8_t *h);
 
 #endif /* MOTION_SENSOR_H_ */
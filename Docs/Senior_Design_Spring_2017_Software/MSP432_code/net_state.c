@@ -0,0 +1,67 @@
+/* DriverLib Includes */
+#include "driverlib.h"
+
+/* Standard Includes */
+#include <stdint.h>
+#include <string.h>
+#include "flash_log.h"
+#include "net_state.h"
+
+#define RECORD(n) ((const NET_STATE *)(NET_STATE_BASE + (n) * sizeof(NET_STATE)))
+
+// ~sum of the words of a record in front of the check word
+static uint32_t check_word(const NET_STATE *state) {
+	const uint32_t *w = (const uint32_t *)state;
+	uint32_t sum = 0;
+	int i;
+
+	for(i = 0; i < (int)(sizeof(NET_STATE) / 4) - 1; i++)
+		sum += w[i];
+	return ~sum;
+}
+
+// index of the first erased record, NET_STATE_RECORDS if the sector is full
+static int first_free() {
+	int i;
+
+	for(i = 0; i < NET_STATE_RECORDS; i++)
+		if(RECORD(i)->magic == 0xFFFFFFFF)
+			break;
+	return i;
+}
+
+/* Function that copies the network joined last to state, returns 0 if none is stored */
+int net_state_load(NET_STATE *state) {
+	int i;
+
+	for(i = first_free() - 1; i >= 0; i--) {
+		if(RECORD(i)->magic == NET_STATE_MAGIC && RECORD(i)->check == check_word(RECORD(i))) {
+			memcpy(state, RECORD(i), sizeof(NET_STATE));
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Function that stores the network just joined, nothing is written if it is the one
+ * stored already. Returns 0 if the flash could not be written */
+int net_state_save(NET_STATE *state) {
+	NET_STATE stored;
+	int n, ok;
+
+	state->magic = NET_STATE_MAGIC;
+	state->check = check_word(state);
+	if(net_state_load(&stored) && !memcmp(&stored, state, sizeof(NET_STATE)))
+		return 1;
+
+	n = first_free();
+	MAP_FlashCtl_setWaitState(FLASH_BANK0, FLASH_WAIT_STATES);	// before program or erase, as in init_clocks()
+	MAP_FlashCtl_unprotectSector(FLASH_MAIN_MEMORY_SPACE_BANK0, 1UL << NET_STATE_SECTOR);
+	if(n == NET_STATE_RECORDS) {
+		MAP_FlashCtl_eraseSector(NET_STATE_BASE);
+		n = 0;
+	}
+	ok = MAP_FlashCtl_programMemory(state, (void *)RECORD(n), sizeof(NET_STATE));
+	MAP_FlashCtl_protectSector(FLASH_MAIN_MEMORY_SPACE_BANK0, 1UL << NET_STATE_SECTOR);
+	return ok;
+}
@@ -0,0 +1,41 @@
+/*
+ * net_state.h
+ *
+ * Network the XBee module joined last, kept in the last sector of flash bank 0
+ * (NET_STATE in main.cmd). After a power cycle or brownout init_XBEE() rejoins
+ * that PAN on its channel directly, the reset and scan of all channels is only
+ * done when the direct rejoin fails.
+ *
+ * The record also holds the UART rate negotiated with the module, probe_baud() tries
+ * it first.
+ *
+ * Records are appended until the sector is full, the last one with a good check
+ * word is the current state. The sector is erased when no record fits any more.
+ */
+
+#ifndef NET_STATE_H_
+#define NET_STATE_H_
+
+#include <stdint.h>
+
+#define NET_STATE_BASE 0x0001F000				// sector 31 of bank 0
+#define NET_STATE_SECTOR 31
+#define NET_STATE_SECTOR_SIZE 4096
+#define NET_STATE_MAGIC 0x4E455431				// "NET1"
+
+typedef struct _net_state {
+	uint32_t magic;
+	char pan_id[16];			// ATOP, extended PAN ID, 16 hex digits
+	uint16_t oi;				// ATOI, operating 16-bit PAN ID
+	uint8_t channel;			// ATCH
+	uint8_t baud;				// index into xbee_bauds[] (xbee_driver.c), 0xFF in records of older firmware
+	uint32_t dh, dl;			// ATDH, ATDL, address of the coordinator the node sends to
+	uint32_t check;				// ~sum of the words before it
+} NET_STATE;
+
+#define NET_STATE_RECORDS (NET_STATE_SECTOR_SIZE / sizeof(NET_STATE))
+
+int net_state_load(NET_STATE *state);
+int net_state_save(NET_STATE *state);
+
+#endif /* NET_STATE_H_ */
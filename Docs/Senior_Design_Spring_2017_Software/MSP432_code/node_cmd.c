@@ -0,0 +1,397 @@
+/* DriverLib Includes */
+#include "driverlib.h"
+
+/* Standard Includes */
+#include <stdint.h>
+#include <string.h>
+#include "energy.h"
+#include "flash_log.h"
+#include "image_header.h"
+#include "jpeg_rate.h"
+#include "motion_sensor.h"
+#include "node_cmd.h"
+#include "ov2640_driver.h"
+#include "rekey.h"
+#include "sw_timer.h"
+#include "xbee_driver.h"
+
+#define NODE_CMD_REPLY_MAX 16
+
+#if NODE_CMD_HEADER_LEN + NODE_CMD_MAX_PARAMS + NODE_CMD_CRC_LEN > RX_DMA_LEN
+#error "a command frame with NODE_CMD_MAX_PARAMS does not fit one RX DMA transfer"
+#endif
+
+// Array where image is stored
+extern uint8_t image_buffer[];
+
+// XBee UART buffer
+extern uint8_t RXBuffer[];
+
+NODE_CONFIG node_config = { OV2640_RES_640x480, OV2640_QUALITY_DEFAULT, 1, JPEG_RATE_DEFAULT_BUDGET };
+
+/* Handler of one opcode, returns the status byte of the answer
+ * params, length --- parameters of the frame, already checked against the table
+ * reply, reply_len --- data after the status byte, at most NODE_CMD_REPLY_MAX bytes */
+typedef uint8_t (*NODE_CMD_HANDLER)(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len);
+
+typedef struct _node_cmd_entry {
+	uint8_t min_len;
+	uint8_t max_len;
+	NODE_CMD_HANDLER handler;
+} NODE_CMD_ENTRY;
+
+/* Set while node_capture_zones() has a window of the frame selected */
+static uint8_t windowed = 0;
+
+/* ms after reset the first image was captured and handed to the log or the radio */
+static uint32_t first_image_ms = 0;
+
+/* energy_report() text, sent by node_cmd_poll() after the answer of NODE_CMD_ENERGY */
+static char energy_text[ENERGY_REPORT_LEN];
+static int energy_text_len = 0;
+
+/* Command received and checked, run by node_cmd_poll() */
+static uint8_t pending = 0;
+static uint8_t pending_opcode;
+static uint8_t pending_len;
+static uint8_t pending_params[NODE_CMD_MAX_PARAMS];
+
+/* CRC-16/CCITT, polynomial 0x1021, initial value 0xFFFF */
+uint16_t node_cmd_crc(const uint8_t data[], int length) {
+	uint16_t crc = 0xFFFF;
+	int i, bit;
+
+	for(i = 0; i < length; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for(bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+/* Function that sends a frame to the coordinator: SOF | opcode | length | data | CRC
+ * length --- at most NODE_CMD_REPLY_MAX + 1 bytes */
+void node_cmd_send(uint8_t opcode, const uint8_t data[], uint8_t length) {
+	uint8_t frame[NODE_CMD_HEADER_LEN + 1 + NODE_CMD_REPLY_MAX + NODE_CMD_CRC_LEN];
+	uint16_t crc;
+	int len = 0;
+
+	frame[len++] = NODE_CMD_SOF;
+	frame[len++] = opcode;
+	frame[len++] = length;
+	memcpy(&frame[len], data, length);
+	len += length;
+
+	crc = node_cmd_crc(&frame[1], len - 1);
+	frame[len++] = crc >> 8;
+	frame[len++] = crc & 0xFF;
+
+	transmit_array((char *)frame, len);
+}
+
+// send an answer frame: opcode | NODE_CMD_REPLY, status, data
+static void send_reply(uint8_t opcode, uint8_t status, const uint8_t data[], uint8_t data_len) {
+	uint8_t reply[1 + NODE_CMD_REPLY_MAX];
+
+	reply[0] = status;
+	memcpy(&reply[1], data, data_len);
+	node_cmd_send(opcode | NODE_CMD_REPLY, reply, 1 + data_len);
+}
+
+// move the quantization scale to where the rate control wants it after a frame of size bytes
+static void rate_control(int size) {
+	uint8_t quality;
+
+	if(node_config.budget == 0)
+		return;
+	quality = jpeg_rate_update(size, node_config.quality, node_config.budget);
+	if(quality != node_config.quality && ov2640_set_quality(quality))
+		node_config.quality = quality;
+}
+
+/* Function that captures one frame under the budget, returns its size, 0 on error or
+ * when it is still over the budget after JPEG_RATE_RETRIES captures */
+static int capture_in_budget(uint32_t *crc32, uint32_t *captured) {
+	int size, tries = 0;
+	int max_size = node_config.budget ? node_config.budget : 0x7FFFFFFF;
+
+	for(;;) {
+		*captured = sw_timer_now();
+		size = capture_image(crc32, max_size);	// capture image, fills image_buffer after the header
+		if(size >= 0)
+			return size;
+		if(++tries > JPEG_RATE_RETRIES)
+			return 0;
+		if(node_config.budget == 0) {			// larger than the buffer at a fixed quality
+			if(node_config.quality >= JPEG_RATE_QS_MAX || !ov2640_set_quality(node_config.quality + 1))
+				return 0;
+			node_config.quality++;
+		}
+		else {
+			rate_control(-size);				// FIFO size of the frame left unread
+		}
+	}
+}
+
+/* Function that captures count images and queues each one in flash for the coordinator,
+ * returns the number of images captured. An image the log cannot take is sent right away */
+int node_capture(uint8_t count) {
+	int size, sent = 0;
+	uint32_t crc32, captured;
+
+	while(count--) {
+		size = capture_in_budget(&crc32, &captured);
+		if(size == 0)
+			break;
+		image_build_header(image_buffer, size, crc32, captured);	// starts with 0x10, so the coordinator knows end dev. is sending an image
+		if(!flash_log_append(image_buffer, IMAGE_HEADER_LEN + size))	// sent by flash_log_poll() until acknowledged
+			transmit_image(image_buffer, IMAGE_HEADER_LEN + size);	// transmit the image, lost if the link is down
+		sent++;
+		energy_count(ENERGY_EVENT_IMAGE);
+		if(first_image_ms == 0)
+			first_image_ms = sw_timer_ms(sw_timer_now());	// time to first image after power-up
+		if(!windowed)			// a window says little about the whole scene
+			rate_control(size);	// after the header took the quality this frame was captured with
+	}
+	return sent;
+}
+
+// back to the full frame after a window. If that NACKs the driver forgot the resolution,
+// so the whole table of the configured one is written instead
+static void restore_full_frame() {
+	if(!ov2640_set_window(0, 0, 8, 8))
+		ov2640_set_resolution(node_config.resolution);
+}
+
+/* Function that captures count images of the window around the PIR zones that fired
+ * (motion_sensor.h) and restores the full frame, returns the number of images captured.
+ * The whole frame is captured if the window can not be set */
+int node_capture_zones(uint8_t count, uint8_t zones) {
+	uint8_t x, y, w, h;
+	int sent;
+
+	motion_sensor_window(zones, &x, &y, &w, &h);
+	if(w == 8 && h == 8)
+		return node_capture(count);
+	if(!ov2640_set_window(x, y, w, h))
+		return node_capture(count);
+
+	windowed = 1;
+	sent = node_capture(count);
+	windowed = 0;
+	restore_full_frame();
+	return sent;
+}
+
+static uint8_t cmd_status(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	FLASH_LOG_STATS log;
+
+	reply[0] = NODE_CMD_VERSION;
+	reply[1] = node_config.resolution;
+	reply[2] = node_config.quality;
+	reply[3] = node_config.burst;
+	reply[4] = rekey_engine;
+	flash_log_stats(&log);
+	reply[5] = log.queued;
+	reply[6] = node_config.budget >> 8;
+	reply[7] = node_config.budget & 0xFF;
+	*reply_len = 8;
+	return NODE_CMD_OK;
+}
+
+static uint8_t cmd_capture(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	uint8_t count = length ? params[0] : node_config.burst;
+
+	if(count == 0 || count > NODE_MAX_BURST)
+		return NODE_CMD_BAD_PARAM;
+
+	reply[0] = node_capture(count);
+	*reply_len = 1;
+	return reply[0] == count ? NODE_CMD_OK : NODE_CMD_FAILED;
+}
+
+static uint8_t cmd_set_resolution(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	if(params[0] >= OV2640_RES_COUNT)
+		return NODE_CMD_BAD_PARAM;
+	if(!ov2640_set_resolution(params[0]))
+		return NODE_CMD_FAILED;
+	if(params[0] != node_config.resolution)
+		jpeg_rate_reset();				// the size of the scene changes with the resolution
+	node_config.resolution = params[0];
+	return NODE_CMD_OK;
+}
+
+static uint8_t cmd_set_quality(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	if(params[0] == 0 || params[0] > 63)
+		return NODE_CMD_BAD_PARAM;
+	if(!ov2640_set_quality(params[0]))
+		return NODE_CMD_FAILED;
+	node_config.quality = params[0];
+	return NODE_CMD_OK;
+}
+
+static uint8_t cmd_set_burst(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	if(params[0] == 0 || params[0] > NODE_MAX_BURST)
+		return NODE_CMD_BAD_PARAM;
+	node_config.burst = params[0];
+	return NODE_CMD_OK;
+}
+
+static uint8_t cmd_set_engine(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	if(params[0] != REKEY_ENGINE_SOFTWARE && params[0] != REKEY_ENGINE_FPGA)
+		return NODE_CMD_BAD_PARAM;
+	rekey_engine = params[0];
+	return NODE_CMD_OK;
+}
+
+static uint8_t cmd_image_ack(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	flash_log_ack((uint32_t)params[0] << 24 | (uint32_t)params[1] << 16 | (uint32_t)params[2] << 8 | params[3]);
+	return NODE_CMD_OK;
+}
+
+static uint8_t cmd_set_budget(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	uint16_t budget = (uint16_t)params[0] << 8 | params[1];
+
+	if(budget > OV2640_BUF_SIZE - IMAGE_HEADER_LEN)
+		return NODE_CMD_BAD_PARAM;		// capture_image() refuses such frames, the rate control would not see them
+	node_config.budget = budget;
+	jpeg_rate_reset();
+	return NODE_CMD_OK;
+}
+
+// store the FIFO size of one capture of the current window, 24-bit big-endian
+static int bench_capture(uint8_t reply[]) {
+	uint32_t crc32;
+	int size = -capture_image(&crc32, 0);	// nothing is read out, only the FIFO size counts
+
+	reply[0] = size >> 16;
+	reply[1] = size >> 8;
+	reply[2] = size;
+	return size > 0;
+}
+
+/* Bytes per alert: the full frame against the window of every PIR zone, same scene */
+static uint8_t cmd_zone_bench(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	uint8_t x, y, w, h;
+	int i, ok;
+
+	ok = bench_capture(&reply[0]);
+	for(i = 0; i < MOTION_ZONE_COUNT; i++) {
+		motion_sensor_window(1 << i, &x, &y, &w, &h);
+		ok &= ov2640_set_window(x, y, w, h) && bench_capture(&reply[3 + 3 * i]);
+	}
+	restore_full_frame();
+	*reply_len = 3 + 3 * MOTION_ZONE_COUNT;
+	return ok ? NODE_CMD_OK : NODE_CMD_FAILED;
+}
+
+// store a 32-bit value big-endian
+static void put32(uint8_t *p, uint32_t value) {
+	p[0] = value >> 24;
+	p[1] = value >> 16;
+	p[2] = value >> 8;
+	p[3] = value;
+}
+
+static uint8_t cmd_boot_stats(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	reply[0] = xbee_join_path;
+	put32(&reply[1], xbee_join_ms);
+	put32(&reply[5], first_image_ms);
+	*reply_len = 9;
+	return NODE_CMD_OK;
+}
+
+static uint8_t cmd_energy(const uint8_t params[], uint8_t length, uint8_t reply[], uint8_t *reply_len) {
+	if(length == 1 && params[0] > 1)
+		return NODE_CMD_BAD_PARAM;
+	energy_text_len = energy_report(energy_text, ENERGY_REPORT_LEN);
+	if(length == 1 && params[0] == 1)
+		energy_reset();
+	reply[0] = energy_text_len >> 8;
+	reply[1] = energy_text_len & 0xFF;
+	*reply_len = 2;
+	return NODE_CMD_OK;
+}
+
+/* Dispatch table, indexed by opcode: accepted parameter length and handler */
+static const NODE_CMD_ENTRY cmd_table[NODE_CMD_COUNT] = {
+	{ 0, 0, 0 },							// 0x00 unused
+	{ 0, 0, cmd_status },					// NODE_CMD_STATUS
+	{ 0, 1, cmd_capture },					// NODE_CMD_CAPTURE
+	{ 1, 1, cmd_set_resolution },			// NODE_CMD_SET_RESOLUTION
+	{ 1, 1, cmd_set_quality },				// NODE_CMD_SET_QUALITY
+	{ 1, 1, cmd_set_burst },				// NODE_CMD_SET_BURST
+	{ 1, 1, cmd_set_engine },				// NODE_CMD_SET_ENGINE
+	{ 4, 4, cmd_image_ack },				// NODE_CMD_IMAGE_ACK
+	{ 2, 2, cmd_set_budget },				// NODE_CMD_SET_BUDGET
+	{ 0, 0, cmd_zone_bench },				// NODE_CMD_ZONE_BENCH
+	{ 0, 0, cmd_boot_stats },				// NODE_CMD_BOOT_STATS
+	{ 0, 1, cmd_energy }					// NODE_CMD_ENERGY
+};
+
+/* Function that checks the frame at the start of RXBuffer (RXBuffer[0] == NODE_CMD_SOF)
+ * and queues it for node_cmd_poll(). Bad frames are answered right away.
+ * Returns 1 if a command was queued, the caller restarts the read either way */
+int node_cmd_receive() {
+	uint8_t opcode, length;
+	uint16_t crc;
+
+	if(!wait_bytes(NODE_CMD_HEADER_LEN))	// incomplete header, nothing to answer to
+		return 0;
+
+	opcode = RXBuffer[1];
+	length = RXBuffer[2];
+	if(length > NODE_CMD_MAX_PARAMS) {
+		send_reply(opcode, NODE_CMD_BAD_LENGTH, 0, 0);
+		return 0;
+	}
+	// payload can contain 0x0D, so wait on the byte count
+	if(!wait_bytes(NODE_CMD_HEADER_LEN + length + NODE_CMD_CRC_LEN)) {
+		send_reply(opcode, NODE_CMD_BAD_LENGTH, 0, 0);
+		return 0;
+	}
+
+	crc = (uint16_t)RXBuffer[NODE_CMD_HEADER_LEN + length] << 8 | RXBuffer[NODE_CMD_HEADER_LEN + length + 1];
+	if(crc != node_cmd_crc(&RXBuffer[1], 2 + length)) {
+		send_reply(opcode, NODE_CMD_BAD_CRC, 0, 0);
+		return 0;
+	}
+	if(opcode >= NODE_CMD_COUNT || !cmd_table[opcode].handler) {
+		send_reply(opcode, NODE_CMD_BAD_OPCODE, 0, 0);
+		return 0;
+	}
+	if(length < cmd_table[opcode].min_len || length > cmd_table[opcode].max_len) {
+		send_reply(opcode, NODE_CMD_BAD_LENGTH, 0, 0);
+		return 0;
+	}
+	if(pending) {
+		send_reply(opcode, NODE_CMD_BUSY, 0, 0);
+		return 0;
+	}
+
+	pending_opcode = opcode;
+	pending_len = length;
+	memcpy(pending_params, &RXBuffer[NODE_CMD_HEADER_LEN], length);	// RXBuffer is reused for the next read
+	pending = 1;
+	return 1;
+}
+
+/* Function that runs a queued command and answers it, call from the main loop */
+void node_cmd_poll() {
+	uint8_t reply[NODE_CMD_REPLY_MAX];
+	uint8_t reply_len = 0;
+	uint8_t status;
+
+	if(!pending)
+		return;
+
+	motion_sensor_disable();	// disable motion sensor interrupts while the command runs
+	status = cmd_table[pending_opcode].handler(pending_params, pending_len, reply, &reply_len);
+	send_reply(pending_opcode, status, reply, reply_len);
+	if(energy_text_len) {
+		transmit_array(energy_text, energy_text_len);	// length is in the answer
+		energy_text_len = 0;
+	}
+	motion_sensor_enable();		// re-enable motion sensor interrupts
+	pending = 0;
+}
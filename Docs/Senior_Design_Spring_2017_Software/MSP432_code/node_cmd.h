@@ -0,0 +1,74 @@
+/*
+ * node_cmd.h
+ *
+ * Binary command protocol between the coordinator and the node, next to the
+ * single byte ASCII commands ('2' .. '5') handled in main.c.
+ *
+ * Frame, both directions:
+ *   SOF | opcode | length | params (length bytes) | CRC-16 high | CRC-16 low
+ * CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF) over opcode, length and params.
+ *
+ * The node answers every frame with opcode | NODE_CMD_REPLY, a status byte and the
+ * data of the handler. Frames are checked when they arrive and the handler runs later
+ * from the main loop (node_cmd_poll), one command at a time. Handlers are looked up
+ * by opcode in a const table. BeagleBone_Code/node_protocol.py is the coordinator side.
+ */
+
+#ifndef NODE_CMD_H_
+#define NODE_CMD_H_
+
+#include <stdint.h>
+
+#define NODE_CMD_SOF 0xA5						// not an ASCII command, not the 0x10 image marker
+#define NODE_CMD_HEADER_LEN 3					// SOF, opcode, length
+#define NODE_CMD_CRC_LEN 2
+#define NODE_CMD_MAX_PARAMS 64					// frame has to fit RX_DMA_LEN of xbee_driver.h, checked in node_cmd.c
+#define NODE_CMD_REPLY 0x80						// set in the opcode of an answer
+#define NODE_CMD_VERSION 2						// protocol version, first byte of the status data
+
+/* Opcodes, params in brackets */
+#define NODE_CMD_STATUS 0x01					// -> version, resolution, quality, burst, rekey engine, images queued, budget (2)
+#define NODE_CMD_CAPTURE 0x02					// [count], default is the burst count -> images sent
+#define NODE_CMD_SET_RESOLUTION 0x03			// resolution index (OV2640_RES_*)
+#define NODE_CMD_SET_QUALITY 0x04				// JPEG quantization scale, 1 (best) .. 63, starting point of the rate control
+#define NODE_CMD_SET_BURST 0x05					// images per capture, 1 .. NODE_MAX_BURST
+#define NODE_CMD_SET_ENGINE 0x06				// rekey engine, REKEY_ENGINE_SOFTWARE or REKEY_ENGINE_FPGA
+#define NODE_CMD_IMAGE_ACK 0x07					// sequence number (4, big-endian) of an image received, see flash_log.h
+#define NODE_CMD_SET_BUDGET 0x08				// JPEG bytes per image (2, big-endian), 0 = fixed quality, at most OV2640_BUF_SIZE - IMAGE_HEADER_LEN, see jpeg_rate.h
+#define NODE_CMD_ZONE_BENCH 0x09				// -> JPEG bytes (3, big-endian) of the full frame, then of each PIR zone window
+#define NODE_CMD_BOOT_STATS 0x0A				// -> join path (XBEE_JOIN_*), ms after reset on the network (4), ms after reset the first image was ready (4, 0 = none yet)
+#define NODE_CMD_ENERGY 0x0B					// [1 = reset the accounts after] -> report length (2), the energy_report() text follows the frame
+#define NODE_CMD_COUNT 0x0C						// size of the dispatch table
+
+/* Sent by the node without a request */
+#define NODE_CMD_IMAGE 0x40						// sequence number (4), length (4), the image bytes follow the frame
+
+/* Status byte of an answer */
+#define NODE_CMD_OK 0
+#define NODE_CMD_BAD_CRC 1
+#define NODE_CMD_BAD_OPCODE 2
+#define NODE_CMD_BAD_LENGTH 3
+#define NODE_CMD_BAD_PARAM 4
+#define NODE_CMD_BUSY 5							// previous command has not run yet
+#define NODE_CMD_FAILED 6						// handler ran but the device did not respond
+
+#define NODE_MAX_BURST 8
+
+/* Capture parameters, changed over the air and used for PIR captures too */
+typedef struct _node_config {
+	uint8_t resolution;
+	uint8_t quality;
+	uint8_t burst;
+	uint16_t budget;		// JPEG bytes per image, 0 = quality stays where NODE_CMD_SET_QUALITY put it
+} NODE_CONFIG;
+
+extern NODE_CONFIG node_config;
+
+uint16_t node_cmd_crc(const uint8_t data[], int length);
+void node_cmd_send(uint8_t opcode, const uint8_t data[], uint8_t length);
+int node_cmd_receive();
+void node_cmd_poll();
+int node_capture(uint8_t count);
+int node_capture_zones(uint8_t count, uint8_t zones);
+
+#endif /* NODE_CMD_H_ */
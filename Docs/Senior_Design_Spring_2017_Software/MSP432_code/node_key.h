@@ -0,0 +1,25 @@
+/*
+ * node_key.h
+ *
+ * Private key of the node for the ElGamal rekey, big endian. The coordinator
+ * encrypts to the public key provisioned for the node's serial number in
+ * BeagleBone_Code/test_keys.txt (the key store is built from that file), which
+ * has to be this key times G. The FPGA scheduler wires the same key into its
+ * ElGamal path (data_dest_sel "101" in ECC_Mult_LW_Scheduler.vhd), so a change
+ * here needs the FPGA and test_keys.txt changed with it.
+ *
+ * host_sim/ecc_bench.c checks the key against test_keys.txt.
+ */
+
+#ifndef NODE_KEY_H_
+#define NODE_KEY_H_
+
+#include <stdint.h>
+#include "ecc_p192.h"
+
+static const uint8_t node_private_key[P192_BYTES] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05
+};
+
+#endif /* NODE_KEY_H_ */
@@ -1,9 +1,14 @@
 /* DriverLib Includes */
 #include <string.h>
 #include "driverlib.h"
+#include "energy.h"
 #include "i2c_driver.h"
+#include "image_header.h"
+#include "ov2640_driver.h"
 #include "ov2640_regs.h"
+#include "ov2640_regs_opt.h"
 #include "spi_driver.h"
+#include "sw_timer.h"
 
 /* Error Codes */
 #define WRITE_ERROR -1
@@ -35,17 +40,78 @@ bool sccb_write_reg(uint8_t addr, uint8_t reg, uint8_t value) {
 	return writeI2C(addr, reg, (uint8_t *)&value, 1);
 }
 
-/* Function that writes an array of registers/value pairs to the OV2640 CMOS sensor */
-bool sccb_write_reg_array(uint8_t addr, const struct sensor_reg array[]) {
-	int i = 0;
-
-	while(!(array[i].reg == 0xFF && array[i].val == 0xFF)) {
-		if(!sccb_write_reg(addr, array[i].reg, array[i].val)) return false;
-		i++;
+/* Register array written in the background, the completion of each pair queues the next */
+static struct {
+	I2C_TRANSACTION t;
+	const struct sensor_reg *next;
+	uint8_t value;
+	volatile uint8_t busy;
+	SCCB_DONE done;
+} reg_writer;
+
+// completion of one pair, runs in the EUSCI_B1 interrupt
+static void reg_writer_next(I2C_TRANSACTION *t) {
+	bool ok = t->status == eUSCI_SUCCESS;
+
+	if(ok && !(reg_writer.next->reg == 0xFF && reg_writer.next->val == 0xFF)) {
+		t->reg = reg_writer.next->reg;
+		reg_writer.value = reg_writer.next->val;
+		reg_writer.next++;
+		i2c_submit(t);
+		return;
 	}
+
+	reg_writer.busy = 0;
+	if(reg_writer.done)
+		reg_writer.done(ok);
+}
+
+/* Function that starts writing an array of registers/value pairs, returns right away
+ * done --- called from the interrupt after the last pair or the first NACK, may be 0
+ * Returns false if an array is still being written or the array is empty */
+bool sccb_write_reg_array_async(uint8_t addr, const struct sensor_reg *array, SCCB_DONE done) {
+	if(reg_writer.busy || (array[0].reg == 0xFF && array[0].val == 0xFF))
+		return false;
+
+	reg_writer.busy = 1;
+	reg_writer.done = done;
+	reg_writer.next = &array[1];
+	reg_writer.value = array[0].val;
+	reg_writer.t.addr = addr;
+	reg_writer.t.reg = array[0].reg;
+	reg_writer.t.direction = I2C_WRITE;
+	reg_writer.t.data = &reg_writer.value;
+	reg_writer.t.length = 1;
+	reg_writer.t.callback = reg_writer_next;
+	i2c_submit(&reg_writer.t);
 	return true;
 }
 
+/* Function that writes an array of registers/value pairs to the OV2640 CMOS sensor,
+ * sleeps in LPM0 while the interrupts work through the array */
+bool sccb_write_reg_array(uint8_t addr, const struct sensor_reg array[]) {
+	if(array[0].reg == 0xFF && array[0].val == 0xFF)
+		return true;
+	if(!sccb_write_reg_array_async(addr, array, 0))
+		return false;
+
+	energy_mcu(ENERGY_MCU_LPM0);
+	for(;;) {
+		MAP_Interrupt_disableMaster();
+		if(!reg_writer.busy)
+			break;
+		MAP_PCM_gotoLPM0();
+		MAP_Interrupt_enableMaster();
+	}
+	MAP_Interrupt_enableMaster();
+	energy_mcu(ENERGY_MCU_ACTIVE);
+
+	return reg_writer.t.status == eUSCI_SUCCESS;
+}
+
+/* Resolution the sensor registers are in, OV2640_RES_COUNT when unknown */
+static uint8_t current_resolution = OV2640_RES_COUNT;
+
 /* Function that initialize the OV2640 registers for JPEG, 640x480 operation */
 int8_t init_OV2640_regs(void) {
 	uint8_t vid = 0x00, pid = 0x00;
@@ -61,33 +127,160 @@ int8_t init_OV2640_regs(void) {
 
     sccb_write_reg(OV2640_ADDRESS, 0x12, 0x80);		// reset the registers in the OV2640
 
-    _delay_cycles(300000);	// delay after SW reset of OV2640
+    sw_timer_delay_ms(100);	// delay after SW reset of OV2640
 
     // configure OV2640 registers for operation --- JPEG, 640x480
-    sccb_write_reg_array(OV2640_ADDRESS, OV2640_JPEG_INIT);
-    sccb_write_reg_array(OV2640_ADDRESS, OV2640_YUV422);
-    sccb_write_reg_array(OV2640_ADDRESS, OV2640_JPEG);
-    sccb_write_reg(OV2640_ADDRESS, 0xFF, 0x01);
-    sccb_write_reg(OV2640_ADDRESS, 0x15, 0x00);
-    sccb_write_reg_array(OV2640_ADDRESS, OV2640_640x480_JPEG);
+    // JPEG_INIT, YUV422, JPEG, COM10 and the 640x480 table with the dead and redundant writes dropped
+    current_resolution = OV2640_RES_COUNT;
+    if(!sccb_write_reg_array(OV2640_ADDRESS, ov2640_init[OV2640_RES_640x480])) return WRITE_ERROR;
+    current_resolution = OV2640_RES_640x480;
 
 	return 0;
 }
 
+/* Register tables of the JPEG output sizes, in OV2640_RES_* order */
+static const struct sensor_reg *const resolution_regs[OV2640_RES_COUNT] = {
+	OV2640_160x120_JPEG,
+	OV2640_176x144_JPEG,
+	OV2640_320x240_JPEG,
+	OV2640_352x288_JPEG,
+	OV2640_640x480_JPEG,
+	OV2640_800x600_JPEG,
+	OV2640_1024x768_JPEG,
+	OV2640_1280x1024_JPEG,
+	OV2640_1600x1200_JPEG
+};
+
+/* Function that changes the JPEG output size, returns 0 on a bad index or NACK
+ * Only the registers that differ from the current size are written (ov2640_delta),
+ * the full table after a failed write
+ * resolution --- OV2640_RES_* */
+int ov2640_set_resolution(uint8_t resolution) {
+	const struct sensor_reg *regs;
+
+	if(resolution >= OV2640_RES_COUNT)
+		return 0;
+	if(resolution == current_resolution)
+		return 1;
+
+	if(current_resolution < OV2640_RES_COUNT)
+		regs = ov2640_delta[current_resolution][resolution];
+	else
+		regs = resolution_regs[resolution];
+
+	current_resolution = OV2640_RES_COUNT;	// unknown until the whole table is in
+	if(!sccb_write_reg_array(OV2640_ADDRESS, regs))
+		return 0;
+	current_resolution = resolution;
+	return 1;
+}
+
+// value a register table leaves in a DSP register, 0 if the table does not write it
+static uint8_t dsp_value(const struct sensor_reg *regs, uint8_t reg) {
+	uint8_t bank = 0xFF, val = 0;
+
+	for(; !(regs->reg == 0xFF && regs->val == 0xFF); regs++) {
+		if(regs->reg == 0xFF)
+			bank = regs->val;
+		else if(bank == 0x00 && regs->reg == reg)
+			val = regs->val;
+	}
+	return val;
+}
+
+/* Function that makes the DSP encode only a window of the frame, returns 0 on NACK or
+ * while the resolution is unknown. The window keeps the scale of the full frame, a
+ * quarter of the frame gives an image of half the width and height. After a NACK the
+ * DSP registers are unknown, the next ov2640_set_resolution() writes the whole table.
+ * x, y, w, h --- eighths of the frame, 0, 0, 8, 8 restores the full frame */
+int ov2640_set_window(uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
+	const struct sensor_reg *regs;
+	struct sensor_reg window[14];
+	uint16_t full_w, full_h, full_out_w, full_out_h;
+	uint16_t win_w, win_h, out_w, out_h, off_x, off_y;
+	uint8_t vhyx, zmhh;
+	int n = 0;
+
+	if(current_resolution >= OV2640_RES_COUNT || w == 0 || h == 0 || x + w > 8 || y + h > 8)
+		return 0;
+	regs = resolution_regs[current_resolution];
+
+	// DSP input window (real / 4) and output size (real / 4) of the full frame
+	vhyx = dsp_value(regs, 0x55);
+	zmhh = dsp_value(regs, 0x5C);
+	full_w = (dsp_value(regs, 0x51) | (vhyx & 0x08) << 5 | (dsp_value(regs, 0x57) & 0x80) << 2) * 4;
+	full_h = (dsp_value(regs, 0x52) | (vhyx & 0x80) << 1) * 4;
+	full_out_w = (dsp_value(regs, 0x5A) | (zmhh & 0x03) << 8) * 4;
+	full_out_h = (dsp_value(regs, 0x5B) | (zmhh & 0x04) << 6) * 4;
+
+	// output of the window in whole JPEG blocks (16x8 for YUV422), input window at the same scale
+	out_w = full_out_w * w / 8 & ~15;
+	out_h = full_out_h * h / 8 & ~7;
+	if(out_w == 0) out_w = 16;
+	if(out_h == 0) out_h = 8;
+	win_w = ((uint32_t)out_w * full_w / full_out_w + 3) & ~3;
+	win_h = ((uint32_t)out_h * full_h / full_out_h + 3) & ~3;
+	if(win_w > full_w) win_w = full_w;
+	if(win_h > full_h) win_h = full_h;
+	off_x = (uint32_t)full_w * x / 8;
+	off_y = (uint32_t)full_h * y / 8;
+	if(off_x + win_w > full_w) off_x = full_w - win_w;
+	if(off_y + win_h > full_h) off_y = full_h - win_h;
+
+	window[n].reg = 0xFF; window[n++].val = 0x00;				// DSP register bank
+	window[n].reg = 0xE0; window[n++].val = 0x04;				// hold the DVP while the window changes
+	window[n].reg = 0x51; window[n++].val = win_w / 4;			// HSIZE
+	window[n].reg = 0x52; window[n++].val = win_h / 4;			// VSIZE
+	window[n].reg = 0x53; window[n++].val = off_x;				// XOFFL
+	window[n].reg = 0x54; window[n++].val = off_y;				// YOFFL
+	window[n].reg = 0x55;										// VHYX
+	window[n++].val = (win_h / 4 & 0x100) >> 1 | (off_y >> 4 & 0x70) | (win_w / 4 & 0x100) >> 5 | (off_x >> 8 & 0x07);
+	window[n].reg = 0x57; window[n++].val = (win_w / 4 & 0x200) >> 2;	// TEST, H_SIZE[9]
+	window[n].reg = 0x5A; window[n++].val = out_w / 4;			// ZMOW
+	window[n].reg = 0x5B; window[n++].val = out_h / 4;			// ZMOH
+	window[n].reg = 0x5C;										// ZMHH, zoom speed kept
+	window[n++].val = (zmhh & 0xF0) | (out_h / 4 & 0x100) >> 6 | (out_w / 4 >> 8 & 0x03);
+	window[n].reg = 0xE0; window[n++].val = 0x00;
+	window[n].reg = 0xFF; window[n++].val = 0xFF;
+
+	if(!sccb_write_reg_array(OV2640_ADDRESS, window)) {
+		current_resolution = OV2640_RES_COUNT;
+		return 0;
+	}
+	return 1;
+}
+
+/* Function that sets the JPEG quantization scale (DSP register 0x44), returns 0 on NACK
+ * quality --- 1 (largest image, best quality) to 63 (smallest image) */
+int ov2640_set_quality(uint8_t quality) {
+	if(!sccb_write_reg(OV2640_ADDRESS, 0xFF, 0x00))	// DSP register bank
+		return 0;
+	return sccb_write_reg(OV2640_ADDRESS, 0x44, quality);
+}
+
 /* Function that sets up image_buffer array, I2C for OV2640, and OV2640 registers */
 void init_ov2640() {
+	uint8_t phase = energy_begin(ENERGY_PHASE_SCCB_INIT);
+
     memset(image_buffer, 0x00, 10000);	// clear the memory allocated for the image
 
 	initI2C();		// initialize I2C between MSP432 and OV2640
 
-	_delay_cycles(20000);
+	sw_timer_delay_ms(7);	// let the SCCB bus settle
 
     init_OV2640_regs();	// initialize OV2640 registers/verify OV2640 over I2C
+
+	energy_end(phase);
 }
 
-/* Function that captures an image --- returns image size */
-int capture_image() {
+/* Function that captures an image --- returns image size, 0 on error
+ * The JPEG goes to image_buffer after IMAGE_HEADER_LEN bytes left for the header,
+ * crc32 is its CRC-32, computed while the bytes come out of the FIFO.
+ * A frame larger than max_size or the buffer is left in the FIFO and -size is
+ * returned, it is never cut short */
+int capture_image(uint32_t *crc32, int max_size) {
     unsigned char complete_flag = 0x00, size1 = 0x00, size2 = 0x00, size3 = 0x00;
+    uint8_t phase;
 
     spi_Write(0x80, 0x27);	// write to test register
 
@@ -95,26 +288,33 @@ int capture_image() {
 
 	if(complete_flag != 0x27) return 0;	// if value does not equal the value written --- return 0
 
+    phase = energy_begin(ENERGY_PHASE_CAPTURE);
     spi_Write(0x84, 0x01);	// clear FIFO done flag
     spi_Write(0x84, 0x02);	// start capture
 	spi_Read(0x41, &complete_flag, 2);	// read complete flag
 
     while((complete_flag & 0x08) != 0x08) {	// wait for the complete flag to be set
     	spi_Read(0x41, &complete_flag, 2);
-    	_delay_cycles(10);
+    	sw_timer_delay_ms(1);	// capture takes tens of ms, sleep between polls
     }
 
     // read bytes of the image size from Arducam
     spi_Read(0x42, &size1, 2);
     spi_Read(0x43, &size2, 2);
     spi_Read(0x44, &size3, 2);
+    energy_end(phase);
 
     // shift bytes into integer value of image size
     int size = ((size3 << 16) | (size2 << 8) | size1) & 0x07fffff;
 
-    if(size >= 60000) size = 60000;		// if size bigger than allocated for an image --- set to max
+    if(size == 0) return 0;
+    if(size > max_size || size > BUF_SIZE - IMAGE_HEADER_LEN) return -size;	// a truncated JPEG does not decode, let the caller raise QS
 
-    spi_Read(0x3c, image_buffer, size);	// read the image from the Arducam
+    phase = energy_begin(ENERGY_PHASE_READOUT);
+    image_crc32_start();
+    spi_Read_crc32(0x3c, &image_buffer[IMAGE_HEADER_LEN], size + 1);	// read the image from the Arducam, first transfer is the address
+    *crc32 = image_crc32_result();
+    energy_end(phase);
 
     return size;
 }
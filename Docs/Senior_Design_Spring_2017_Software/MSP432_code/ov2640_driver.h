@@ -8,7 +8,33 @@
 #ifndef OV2640_DRIVER_H_
 #define OV2640_DRIVER_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
+/* JPEG output sizes, index for ov2640_set_resolution() */
+#define OV2640_RES_160x120 0
+#define OV2640_RES_176x144 1
+#define OV2640_RES_320x240 2
+#define OV2640_RES_352x288 3
+#define OV2640_RES_640x480 4		// set by init_ov2640()
+#define OV2640_RES_800x600 5
+#define OV2640_RES_1024x768 6
+#define OV2640_RES_1280x1024 7
+#define OV2640_RES_1600x1200 8
+#define OV2640_RES_COUNT 9
+
+#define OV2640_BUF_SIZE 60000		// image_buffer, IMAGE_HEADER_LEN bytes of header and the JPEG
+
+#define OV2640_QUALITY_DEFAULT 0x0C	// sensor reset value of the quantization scale
+
+struct sensor_reg;	// ov2640_regs.h
+typedef void (*SCCB_DONE)(bool ok);
+
 void init_ov2640();
-int capture_image();
+bool sccb_write_reg_array_async(uint8_t addr, const struct sensor_reg *array, SCCB_DONE done);
+int capture_image(uint32_t *crc32, int max_size);
+int ov2640_set_resolution(uint8_t resolution);
+int ov2640_set_quality(uint8_t quality);
+int ov2640_set_window(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
 
 #endif /* OV2640_DRIVER_H_ */
@@ -6,7 +6,7 @@
 #ifndef OV2640_REGS_H_
 #define OV2640_REGS_H_
 
-#define BUF_SIZE 60000
+#define BUF_SIZE OV2640_BUF_SIZE
 
 /* Structure for register address, value pair */
 struct sensor_reg {
@@ -0,0 +1,3204 @@
+/* Generated by host_sim/ov2640_regs_gen.py from ov2640_regs.h, do not edit.
+ * Dead and redundant writes of the cold init are dropped, resolution changes
+ * only write the registers that differ. Include after ov2640_regs.h.
+ */
+
+#ifndef OV2640_REGS_OPT_H_
+#define OV2640_REGS_OPT_H_
+
+/* Cold init, JPEG 160x120, 187 writes instead of 248 */
+const struct sensor_reg OV2640_INIT_160x120[]  =
+{
+	{0xff, 0x00},
+	{0x2c, 0xff},
+	{0x2e, 0xdf},
+	{0xff, 0x01},
+	{0x3c, 0x32},
+	{0x11, 0x00},
+	{0x09, 0x02},
+	{0x13, 0xe5},
+	{0x14, 0x48},
+	{0x2c, 0x0c},
+	{0x33, 0x78},
+	{0x3a, 0x33},
+	{0x3b, 0xfb},
+	{0x3e, 0x00},
+	{0x43, 0x11},
+	{0x16, 0x10},
+	{0x48, 0x00},
+	{0x5b, 0x00},
+	{0x42, 0x03},
+	{0x4a, 0x81},
+	{0x21, 0x99},
+	{0x24, 0x40},
+	{0x25, 0x38},
+	{0x26, 0x82},
+	{0x5c, 0x00},
+	{0x63, 0x00},
+	{0x61, 0x70},
+	{0x62, 0x80},
+	{0x7c, 0x05},
+	{0x20, 0x80},
+	{0x28, 0x30},
+	{0x6c, 0x00},
+	{0x6e, 0x00},
+	{0x70, 0x02},
+	{0x71, 0x94},
+	{0x73, 0xc1},
+	{0x12, 0x40},
+	{0x3d, 0x38},
+	{0x46, 0x3f},
+	{0x0c, 0x3c},
+	{0xff, 0x00},
+	{0xf9, 0xc0},
+	{0x41, 0x24},
+	{0xe0, 0x14},
+	{0x76, 0xff},
+	{0x42, 0x20},
+	{0x43, 0x18},
+	{0x4c, 0x00},
+	{0x87, 0xd5},
+	{0x88, 0x3f},
+	{0xd9, 0x10},
+	{0xd3, 0x82},
+	{0xc8, 0x08},
+	{0xc9, 0x80},
+	{0x7c, 0x00},
+	{0x7d, 0x00},
+	{0x7c, 0x03},
+	{0x7d, 0x48},
+	{0x7d, 0x48},
+	{0x7c, 0x08},
+	{0x7d, 0x20},
+	{0x7d, 0x10},
+	{0x7d, 0x0e},
+	{0x90, 0x00},
+	{0x91, 0x0e},
+	{0x91, 0x1a},
+	{0x91, 0x31},
+	{0x91, 0x5a},
+	{0x91, 0x69},
+	{0x91, 0x75},
+	{0x91, 0x7e},
+	{0x91, 0x88},
+	{0x91, 0x8f},
+	{0x91, 0x96},
+	{0x91, 0xa3},
+	{0x91, 0xaf},
+	{0x91, 0xc4},
+	{0x91, 0xd7},
+	{0x91, 0xe8},
+	{0x91, 0x20},
+	{0x92, 0x00},
+	{0x93, 0x06},
+	{0x93, 0xe3},
+	{0x93, 0x05},
+	{0x93, 0x05},
+	{0x93, 0x00},
+	{0x93, 0x04},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x96, 0x00},
+	{0x97, 0x08},
+	{0x97, 0x19},
+	{0x97, 0x02},
+	{0x97, 0x0c},
+	{0x97, 0x24},
+	{0x97, 0x30},
+	{0x97, 0x28},
+	{0x97, 0x26},
+	{0x97, 0x02},
+	{0x97, 0x98},
+	{0x97, 0x80},
+	{0x97, 0x00},
+	{0x97, 0x00},
+	{0xc3, 0xed},
+	{0xa4, 0x00},
+	{0xa8, 0x00},
+	{0xc5, 0x11},
+	{0xc6, 0x51},
+	{0xbf, 0x80},
+	{0xc7, 0x10},
+	{0xb6, 0x66},
+	{0xb8, 0xa5},
+	{0xb7, 0x64},
+	{0xb9, 0x7c},
+	{0xb3, 0xaf},
+	{0xb4, 0x97},
+	{0xb5, 0xff},
+	{0xb0, 0xc5},
+	{0xb1, 0x94},
+	{0xb2, 0x0f},
+	{0xc4, 0x5c},
+	{0xd3, 0x00},
+	{0xc3, 0xed},
+	{0x7f, 0x00},
+	{0xe0, 0x00},
+	{0xdd, 0x7f},
+	{0x05, 0x00},
+	{0x12, 0x40},
+	{0xd3, 0x04},
+	{0x8c, 0x00},
+	{0x05, 0x00},
+	{0xdf, 0x00},
+	{0x33, 0x80},
+	{0x3c, 0x40},
+	{0x00, 0x00},
+	{0xe0, 0x14},
+	{0xe1, 0x77},
+	{0xe5, 0x1f},
+	{0xd7, 0x03},
+	{0xda, 0x10},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x04, 0x08},
+	{0x15, 0x00},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x28},
+	{0x5b, 0x1e},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* Cold init, JPEG 176x144, 187 writes instead of 248 */
+const struct sensor_reg OV2640_INIT_176x144[]  =
+{
+	{0xff, 0x00},
+	{0x2c, 0xff},
+	{0x2e, 0xdf},
+	{0xff, 0x01},
+	{0x3c, 0x32},
+	{0x11, 0x00},
+	{0x09, 0x02},
+	{0x13, 0xe5},
+	{0x14, 0x48},
+	{0x2c, 0x0c},
+	{0x33, 0x78},
+	{0x3a, 0x33},
+	{0x3b, 0xfb},
+	{0x3e, 0x00},
+	{0x43, 0x11},
+	{0x16, 0x10},
+	{0x48, 0x00},
+	{0x5b, 0x00},
+	{0x42, 0x03},
+	{0x4a, 0x81},
+	{0x21, 0x99},
+	{0x24, 0x40},
+	{0x25, 0x38},
+	{0x26, 0x82},
+	{0x5c, 0x00},
+	{0x63, 0x00},
+	{0x61, 0x70},
+	{0x62, 0x80},
+	{0x7c, 0x05},
+	{0x20, 0x80},
+	{0x28, 0x30},
+	{0x6c, 0x00},
+	{0x6e, 0x00},
+	{0x70, 0x02},
+	{0x71, 0x94},
+	{0x73, 0xc1},
+	{0x12, 0x40},
+	{0x3d, 0x38},
+	{0x46, 0x3f},
+	{0x0c, 0x3c},
+	{0xff, 0x00},
+	{0xf9, 0xc0},
+	{0x41, 0x24},
+	{0xe0, 0x14},
+	{0x76, 0xff},
+	{0x42, 0x20},
+	{0x43, 0x18},
+	{0x4c, 0x00},
+	{0x87, 0xd5},
+	{0x88, 0x3f},
+	{0xd9, 0x10},
+	{0xd3, 0x82},
+	{0xc8, 0x08},
+	{0xc9, 0x80},
+	{0x7c, 0x00},
+	{0x7d, 0x00},
+	{0x7c, 0x03},
+	{0x7d, 0x48},
+	{0x7d, 0x48},
+	{0x7c, 0x08},
+	{0x7d, 0x20},
+	{0x7d, 0x10},
+	{0x7d, 0x0e},
+	{0x90, 0x00},
+	{0x91, 0x0e},
+	{0x91, 0x1a},
+	{0x91, 0x31},
+	{0x91, 0x5a},
+	{0x91, 0x69},
+	{0x91, 0x75},
+	{0x91, 0x7e},
+	{0x91, 0x88},
+	{0x91, 0x8f},
+	{0x91, 0x96},
+	{0x91, 0xa3},
+	{0x91, 0xaf},
+	{0x91, 0xc4},
+	{0x91, 0xd7},
+	{0x91, 0xe8},
+	{0x91, 0x20},
+	{0x92, 0x00},
+	{0x93, 0x06},
+	{0x93, 0xe3},
+	{0x93, 0x05},
+	{0x93, 0x05},
+	{0x93, 0x00},
+	{0x93, 0x04},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x96, 0x00},
+	{0x97, 0x08},
+	{0x97, 0x19},
+	{0x97, 0x02},
+	{0x97, 0x0c},
+	{0x97, 0x24},
+	{0x97, 0x30},
+	{0x97, 0x28},
+	{0x97, 0x26},
+	{0x97, 0x02},
+	{0x97, 0x98},
+	{0x97, 0x80},
+	{0x97, 0x00},
+	{0x97, 0x00},
+	{0xc3, 0xed},
+	{0xa4, 0x00},
+	{0xa8, 0x00},
+	{0xc5, 0x11},
+	{0xc6, 0x51},
+	{0xbf, 0x80},
+	{0xc7, 0x10},
+	{0xb6, 0x66},
+	{0xb8, 0xa5},
+	{0xb7, 0x64},
+	{0xb9, 0x7c},
+	{0xb3, 0xaf},
+	{0xb4, 0x97},
+	{0xb5, 0xff},
+	{0xb0, 0xc5},
+	{0xb1, 0x94},
+	{0xb2, 0x0f},
+	{0xc4, 0x5c},
+	{0xd3, 0x00},
+	{0xc3, 0xed},
+	{0x7f, 0x00},
+	{0xe0, 0x00},
+	{0xdd, 0x7f},
+	{0x05, 0x00},
+	{0x12, 0x40},
+	{0xd3, 0x04},
+	{0x8c, 0x00},
+	{0x05, 0x00},
+	{0xdf, 0x00},
+	{0x33, 0x80},
+	{0x3c, 0x40},
+	{0x00, 0x00},
+	{0xe0, 0x14},
+	{0xe1, 0x77},
+	{0xe5, 0x1f},
+	{0xd7, 0x03},
+	{0xda, 0x10},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x04, 0x08},
+	{0x15, 0x00},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x2c},
+	{0x5b, 0x24},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* Cold init, JPEG 320x240, 187 writes instead of 248 */
+const struct sensor_reg OV2640_INIT_320x240[]  =
+{
+	{0xff, 0x00},
+	{0x2c, 0xff},
+	{0x2e, 0xdf},
+	{0xff, 0x01},
+	{0x3c, 0x32},
+	{0x11, 0x00},
+	{0x09, 0x02},
+	{0x13, 0xe5},
+	{0x14, 0x48},
+	{0x2c, 0x0c},
+	{0x33, 0x78},
+	{0x3a, 0x33},
+	{0x3b, 0xfb},
+	{0x3e, 0x00},
+	{0x43, 0x11},
+	{0x16, 0x10},
+	{0x48, 0x00},
+	{0x5b, 0x00},
+	{0x42, 0x03},
+	{0x4a, 0x81},
+	{0x21, 0x99},
+	{0x24, 0x40},
+	{0x25, 0x38},
+	{0x26, 0x82},
+	{0x5c, 0x00},
+	{0x63, 0x00},
+	{0x61, 0x70},
+	{0x62, 0x80},
+	{0x7c, 0x05},
+	{0x20, 0x80},
+	{0x28, 0x30},
+	{0x6c, 0x00},
+	{0x6e, 0x00},
+	{0x70, 0x02},
+	{0x71, 0x94},
+	{0x73, 0xc1},
+	{0x12, 0x40},
+	{0x3d, 0x38},
+	{0x46, 0x3f},
+	{0x0c, 0x3c},
+	{0xff, 0x00},
+	{0xf9, 0xc0},
+	{0x41, 0x24},
+	{0xe0, 0x14},
+	{0x76, 0xff},
+	{0x42, 0x20},
+	{0x43, 0x18},
+	{0x4c, 0x00},
+	{0x87, 0xd5},
+	{0x88, 0x3f},
+	{0xd9, 0x10},
+	{0xd3, 0x82},
+	{0xc8, 0x08},
+	{0xc9, 0x80},
+	{0x7c, 0x00},
+	{0x7d, 0x00},
+	{0x7c, 0x03},
+	{0x7d, 0x48},
+	{0x7d, 0x48},
+	{0x7c, 0x08},
+	{0x7d, 0x20},
+	{0x7d, 0x10},
+	{0x7d, 0x0e},
+	{0x90, 0x00},
+	{0x91, 0x0e},
+	{0x91, 0x1a},
+	{0x91, 0x31},
+	{0x91, 0x5a},
+	{0x91, 0x69},
+	{0x91, 0x75},
+	{0x91, 0x7e},
+	{0x91, 0x88},
+	{0x91, 0x8f},
+	{0x91, 0x96},
+	{0x91, 0xa3},
+	{0x91, 0xaf},
+	{0x91, 0xc4},
+	{0x91, 0xd7},
+	{0x91, 0xe8},
+	{0x91, 0x20},
+	{0x92, 0x00},
+	{0x93, 0x06},
+	{0x93, 0xe3},
+	{0x93, 0x05},
+	{0x93, 0x05},
+	{0x93, 0x00},
+	{0x93, 0x04},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x96, 0x00},
+	{0x97, 0x08},
+	{0x97, 0x19},
+	{0x97, 0x02},
+	{0x97, 0x0c},
+	{0x97, 0x24},
+	{0x97, 0x30},
+	{0x97, 0x28},
+	{0x97, 0x26},
+	{0x97, 0x02},
+	{0x97, 0x98},
+	{0x97, 0x80},
+	{0x97, 0x00},
+	{0x97, 0x00},
+	{0xc3, 0xed},
+	{0xa4, 0x00},
+	{0xa8, 0x00},
+	{0xc5, 0x11},
+	{0xc6, 0x51},
+	{0xbf, 0x80},
+	{0xc7, 0x10},
+	{0xb6, 0x66},
+	{0xb8, 0xa5},
+	{0xb7, 0x64},
+	{0xb9, 0x7c},
+	{0xb3, 0xaf},
+	{0xb4, 0x97},
+	{0xb5, 0xff},
+	{0xb0, 0xc5},
+	{0xb1, 0x94},
+	{0xb2, 0x0f},
+	{0xc4, 0x5c},
+	{0xd3, 0x00},
+	{0xc3, 0xed},
+	{0x7f, 0x00},
+	{0xe0, 0x00},
+	{0xdd, 0x7f},
+	{0x05, 0x00},
+	{0x12, 0x40},
+	{0xd3, 0x04},
+	{0x8c, 0x00},
+	{0x05, 0x00},
+	{0xdf, 0x00},
+	{0x33, 0x80},
+	{0x3c, 0x40},
+	{0x00, 0x00},
+	{0xe0, 0x14},
+	{0xe1, 0x77},
+	{0xe5, 0x1f},
+	{0xd7, 0x03},
+	{0xda, 0x10},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x04, 0x08},
+	{0x15, 0x00},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x50},
+	{0x5b, 0x3c},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* Cold init, JPEG 352x288, 187 writes instead of 248 */
+const struct sensor_reg OV2640_INIT_352x288[]  =
+{
+	{0xff, 0x00},
+	{0x2c, 0xff},
+	{0x2e, 0xdf},
+	{0xff, 0x01},
+	{0x3c, 0x32},
+	{0x11, 0x00},
+	{0x09, 0x02},
+	{0x13, 0xe5},
+	{0x14, 0x48},
+	{0x2c, 0x0c},
+	{0x33, 0x78},
+	{0x3a, 0x33},
+	{0x3b, 0xfb},
+	{0x3e, 0x00},
+	{0x43, 0x11},
+	{0x16, 0x10},
+	{0x48, 0x00},
+	{0x5b, 0x00},
+	{0x42, 0x03},
+	{0x4a, 0x81},
+	{0x21, 0x99},
+	{0x24, 0x40},
+	{0x25, 0x38},
+	{0x26, 0x82},
+	{0x5c, 0x00},
+	{0x63, 0x00},
+	{0x61, 0x70},
+	{0x62, 0x80},
+	{0x7c, 0x05},
+	{0x20, 0x80},
+	{0x28, 0x30},
+	{0x6c, 0x00},
+	{0x6e, 0x00},
+	{0x70, 0x02},
+	{0x71, 0x94},
+	{0x73, 0xc1},
+	{0x12, 0x40},
+	{0x3d, 0x38},
+	{0x46, 0x3f},
+	{0x0c, 0x3c},
+	{0xff, 0x00},
+	{0xf9, 0xc0},
+	{0x41, 0x24},
+	{0xe0, 0x14},
+	{0x76, 0xff},
+	{0x42, 0x20},
+	{0x43, 0x18},
+	{0x4c, 0x00},
+	{0x87, 0xd5},
+	{0x88, 0x3f},
+	{0xd9, 0x10},
+	{0xd3, 0x82},
+	{0xc8, 0x08},
+	{0xc9, 0x80},
+	{0x7c, 0x00},
+	{0x7d, 0x00},
+	{0x7c, 0x03},
+	{0x7d, 0x48},
+	{0x7d, 0x48},
+	{0x7c, 0x08},
+	{0x7d, 0x20},
+	{0x7d, 0x10},
+	{0x7d, 0x0e},
+	{0x90, 0x00},
+	{0x91, 0x0e},
+	{0x91, 0x1a},
+	{0x91, 0x31},
+	{0x91, 0x5a},
+	{0x91, 0x69},
+	{0x91, 0x75},
+	{0x91, 0x7e},
+	{0x91, 0x88},
+	{0x91, 0x8f},
+	{0x91, 0x96},
+	{0x91, 0xa3},
+	{0x91, 0xaf},
+	{0x91, 0xc4},
+	{0x91, 0xd7},
+	{0x91, 0xe8},
+	{0x91, 0x20},
+	{0x92, 0x00},
+	{0x93, 0x06},
+	{0x93, 0xe3},
+	{0x93, 0x05},
+	{0x93, 0x05},
+	{0x93, 0x00},
+	{0x93, 0x04},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x96, 0x00},
+	{0x97, 0x08},
+	{0x97, 0x19},
+	{0x97, 0x02},
+	{0x97, 0x0c},
+	{0x97, 0x24},
+	{0x97, 0x30},
+	{0x97, 0x28},
+	{0x97, 0x26},
+	{0x97, 0x02},
+	{0x97, 0x98},
+	{0x97, 0x80},
+	{0x97, 0x00},
+	{0x97, 0x00},
+	{0xc3, 0xed},
+	{0xa4, 0x00},
+	{0xa8, 0x00},
+	{0xc5, 0x11},
+	{0xc6, 0x51},
+	{0xbf, 0x80},
+	{0xc7, 0x10},
+	{0xb6, 0x66},
+	{0xb8, 0xa5},
+	{0xb7, 0x64},
+	{0xb9, 0x7c},
+	{0xb3, 0xaf},
+	{0xb4, 0x97},
+	{0xb5, 0xff},
+	{0xb0, 0xc5},
+	{0xb1, 0x94},
+	{0xb2, 0x0f},
+	{0xc4, 0x5c},
+	{0xd3, 0x00},
+	{0xc3, 0xed},
+	{0x7f, 0x00},
+	{0xe0, 0x00},
+	{0xdd, 0x7f},
+	{0x05, 0x00},
+	{0x12, 0x40},
+	{0xd3, 0x04},
+	{0x8c, 0x00},
+	{0x05, 0x00},
+	{0xdf, 0x00},
+	{0x33, 0x80},
+	{0x3c, 0x40},
+	{0x00, 0x00},
+	{0xe0, 0x14},
+	{0xe1, 0x77},
+	{0xe5, 0x1f},
+	{0xd7, 0x03},
+	{0xda, 0x10},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x04, 0x08},
+	{0x15, 0x00},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x58},
+	{0x5b, 0x48},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* Cold init, JPEG 640x480, 189 writes instead of 249 */
+const struct sensor_reg OV2640_INIT_640x480[]  =
+{
+	{0xff, 0x00},
+	{0x2c, 0xff},
+	{0x2e, 0xdf},
+	{0xff, 0x01},
+	{0x3c, 0x32},
+	{0x09, 0x02},
+	{0x13, 0xe5},
+	{0x14, 0x48},
+	{0x2c, 0x0c},
+	{0x33, 0x78},
+	{0x3a, 0x33},
+	{0x3b, 0xfb},
+	{0x3e, 0x00},
+	{0x43, 0x11},
+	{0x16, 0x10},
+	{0x23, 0x00},
+	{0x36, 0x1a},
+	{0x07, 0xc0},
+	{0x4c, 0x00},
+	{0x48, 0x00},
+	{0x5b, 0x00},
+	{0x42, 0x03},
+	{0x4a, 0x81},
+	{0x21, 0x99},
+	{0x24, 0x40},
+	{0x25, 0x38},
+	{0x26, 0x82},
+	{0x5c, 0x00},
+	{0x63, 0x00},
+	{0x61, 0x70},
+	{0x62, 0x80},
+	{0x7c, 0x05},
+	{0x20, 0x80},
+	{0x28, 0x30},
+	{0x6c, 0x00},
+	{0x6e, 0x00},
+	{0x70, 0x02},
+	{0x71, 0x94},
+	{0x73, 0xc1},
+	{0x12, 0x40},
+	{0x46, 0x3f},
+	{0x0c, 0x3c},
+	{0xff, 0x00},
+	{0xf9, 0xc0},
+	{0x41, 0x24},
+	{0xe0, 0x14},
+	{0x76, 0xff},
+	{0x42, 0x20},
+	{0x43, 0x18},
+	{0x4c, 0x00},
+	{0x87, 0xd5},
+	{0x88, 0x3f},
+	{0xd9, 0x10},
+	{0xd3, 0x82},
+	{0xc8, 0x08},
+	{0xc9, 0x80},
+	{0x7c, 0x00},
+	{0x7d, 0x00},
+	{0x7c, 0x03},
+	{0x7d, 0x48},
+	{0x7d, 0x48},
+	{0x7c, 0x08},
+	{0x7d, 0x20},
+	{0x7d, 0x10},
+	{0x7d, 0x0e},
+	{0x90, 0x00},
+	{0x91, 0x0e},
+	{0x91, 0x1a},
+	{0x91, 0x31},
+	{0x91, 0x5a},
+	{0x91, 0x69},
+	{0x91, 0x75},
+	{0x91, 0x7e},
+	{0x91, 0x88},
+	{0x91, 0x8f},
+	{0x91, 0x96},
+	{0x91, 0xa3},
+	{0x91, 0xaf},
+	{0x91, 0xc4},
+	{0x91, 0xd7},
+	{0x91, 0xe8},
+	{0x91, 0x20},
+	{0x92, 0x00},
+	{0x93, 0x06},
+	{0x93, 0xe3},
+	{0x93, 0x05},
+	{0x93, 0x05},
+	{0x93, 0x00},
+	{0x93, 0x04},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x96, 0x00},
+	{0x97, 0x08},
+	{0x97, 0x19},
+	{0x97, 0x02},
+	{0x97, 0x0c},
+	{0x97, 0x24},
+	{0x97, 0x30},
+	{0x97, 0x28},
+	{0x97, 0x26},
+	{0x97, 0x02},
+	{0x97, 0x98},
+	{0x97, 0x80},
+	{0x97, 0x00},
+	{0x97, 0x00},
+	{0xc3, 0xed},
+	{0xa4, 0x00},
+	{0xa8, 0x00},
+	{0xc5, 0x11},
+	{0xc6, 0x51},
+	{0xbf, 0x80},
+	{0xc7, 0x10},
+	{0xb6, 0x66},
+	{0xb8, 0xa5},
+	{0xb7, 0x64},
+	{0xb9, 0x7c},
+	{0xb3, 0xaf},
+	{0xb4, 0x97},
+	{0xb5, 0xff},
+	{0xb0, 0xc5},
+	{0xb1, 0x94},
+	{0xb2, 0x0f},
+	{0xc4, 0x5c},
+	{0xd3, 0x00},
+	{0xc3, 0xed},
+	{0x7f, 0x00},
+	{0xe0, 0x00},
+	{0xdd, 0x7f},
+	{0x05, 0x00},
+	{0x12, 0x40},
+	{0xd3, 0x04},
+	{0x8c, 0x00},
+	{0x05, 0x00},
+	{0xdf, 0x00},
+	{0x33, 0x80},
+	{0x3c, 0x40},
+	{0x00, 0x00},
+	{0xe0, 0x14},
+	{0xe1, 0x77},
+	{0xe5, 0x1f},
+	{0xd7, 0x03},
+	{0xda, 0x10},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x04, 0x08},
+	{0x15, 0x00},
+	{0x11, 0x01},
+	{0x12, 0x00},
+	{0x17, 0x11},
+	{0x18, 0x75},
+	{0x32, 0x36},
+	{0x19, 0x01},
+	{0x1a, 0x97},
+	{0x03, 0x0f},
+	{0x4f, 0xbb},
+	{0x50, 0x9c},
+	{0x5a, 0x57},
+	{0x6d, 0x80},
+	{0x3d, 0x34},
+	{0x39, 0x02},
+	{0x35, 0x88},
+	{0x22, 0x0a},
+	{0x37, 0x40},
+	{0x34, 0xa0},
+	{0x06, 0x02},
+	{0x0d, 0xb7},
+	{0x0e, 0x01},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0xc8},
+	{0xc1, 0x96},
+	{0x86, 0x3d},
+	{0x50, 0x89},
+	{0x51, 0x90},
+	{0x52, 0x2c},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x88},
+	{0x57, 0x00},
+	{0x5a, 0xa0},
+	{0x5b, 0x78},
+	{0x5c, 0x00},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* Cold init, JPEG 800x600, 189 writes instead of 249 */
+const struct sensor_reg OV2640_INIT_800x600[]  =
+{
+	{0xff, 0x00},
+	{0x2c, 0xff},
+	{0x2e, 0xdf},
+	{0xff, 0x01},
+	{0x3c, 0x32},
+	{0x09, 0x02},
+	{0x13, 0xe5},
+	{0x14, 0x48},
+	{0x2c, 0x0c},
+	{0x33, 0x78},
+	{0x3a, 0x33},
+	{0x3b, 0xfb},
+	{0x3e, 0x00},
+	{0x43, 0x11},
+	{0x16, 0x10},
+	{0x23, 0x00},
+	{0x36, 0x1a},
+	{0x07, 0xc0},
+	{0x4c, 0x00},
+	{0x48, 0x00},
+	{0x5b, 0x00},
+	{0x42, 0x03},
+	{0x4a, 0x81},
+	{0x21, 0x99},
+	{0x24, 0x40},
+	{0x25, 0x38},
+	{0x26, 0x82},
+	{0x5c, 0x00},
+	{0x63, 0x00},
+	{0x61, 0x70},
+	{0x62, 0x80},
+	{0x7c, 0x05},
+	{0x20, 0x80},
+	{0x28, 0x30},
+	{0x6c, 0x00},
+	{0x6e, 0x00},
+	{0x70, 0x02},
+	{0x71, 0x94},
+	{0x73, 0xc1},
+	{0x12, 0x40},
+	{0x46, 0x3f},
+	{0x0c, 0x3c},
+	{0xff, 0x00},
+	{0xf9, 0xc0},
+	{0x41, 0x24},
+	{0xe0, 0x14},
+	{0x76, 0xff},
+	{0x42, 0x20},
+	{0x43, 0x18},
+	{0x4c, 0x00},
+	{0x87, 0xd5},
+	{0x88, 0x3f},
+	{0xd9, 0x10},
+	{0xd3, 0x82},
+	{0xc8, 0x08},
+	{0xc9, 0x80},
+	{0x7c, 0x00},
+	{0x7d, 0x00},
+	{0x7c, 0x03},
+	{0x7d, 0x48},
+	{0x7d, 0x48},
+	{0x7c, 0x08},
+	{0x7d, 0x20},
+	{0x7d, 0x10},
+	{0x7d, 0x0e},
+	{0x90, 0x00},
+	{0x91, 0x0e},
+	{0x91, 0x1a},
+	{0x91, 0x31},
+	{0x91, 0x5a},
+	{0x91, 0x69},
+	{0x91, 0x75},
+	{0x91, 0x7e},
+	{0x91, 0x88},
+	{0x91, 0x8f},
+	{0x91, 0x96},
+	{0x91, 0xa3},
+	{0x91, 0xaf},
+	{0x91, 0xc4},
+	{0x91, 0xd7},
+	{0x91, 0xe8},
+	{0x91, 0x20},
+	{0x92, 0x00},
+	{0x93, 0x06},
+	{0x93, 0xe3},
+	{0x93, 0x05},
+	{0x93, 0x05},
+	{0x93, 0x00},
+	{0x93, 0x04},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x96, 0x00},
+	{0x97, 0x08},
+	{0x97, 0x19},
+	{0x97, 0x02},
+	{0x97, 0x0c},
+	{0x97, 0x24},
+	{0x97, 0x30},
+	{0x97, 0x28},
+	{0x97, 0x26},
+	{0x97, 0x02},
+	{0x97, 0x98},
+	{0x97, 0x80},
+	{0x97, 0x00},
+	{0x97, 0x00},
+	{0xc3, 0xed},
+	{0xa4, 0x00},
+	{0xa8, 0x00},
+	{0xc5, 0x11},
+	{0xc6, 0x51},
+	{0xbf, 0x80},
+	{0xc7, 0x10},
+	{0xb6, 0x66},
+	{0xb8, 0xa5},
+	{0xb7, 0x64},
+	{0xb9, 0x7c},
+	{0xb3, 0xaf},
+	{0xb4, 0x97},
+	{0xb5, 0xff},
+	{0xb0, 0xc5},
+	{0xb1, 0x94},
+	{0xb2, 0x0f},
+	{0xc4, 0x5c},
+	{0xd3, 0x00},
+	{0xc3, 0xed},
+	{0x7f, 0x00},
+	{0xe0, 0x00},
+	{0xdd, 0x7f},
+	{0x05, 0x00},
+	{0x12, 0x40},
+	{0xd3, 0x04},
+	{0x8c, 0x00},
+	{0x05, 0x00},
+	{0xdf, 0x00},
+	{0x33, 0x80},
+	{0x3c, 0x40},
+	{0x00, 0x00},
+	{0xe0, 0x14},
+	{0xe1, 0x77},
+	{0xe5, 0x1f},
+	{0xd7, 0x03},
+	{0xda, 0x10},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x04, 0x08},
+	{0x15, 0x00},
+	{0x11, 0x01},
+	{0x12, 0x00},
+	{0x17, 0x11},
+	{0x18, 0x75},
+	{0x32, 0x36},
+	{0x19, 0x01},
+	{0x1a, 0x97},
+	{0x03, 0x0f},
+	{0x4f, 0xbb},
+	{0x50, 0x9c},
+	{0x5a, 0x57},
+	{0x6d, 0x80},
+	{0x3d, 0x34},
+	{0x39, 0x02},
+	{0x35, 0x88},
+	{0x22, 0x0a},
+	{0x37, 0x40},
+	{0x34, 0xa0},
+	{0x06, 0x02},
+	{0x0d, 0xb7},
+	{0x0e, 0x01},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0xc8},
+	{0xc1, 0x96},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0x90},
+	{0x52, 0x2c},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x88},
+	{0x57, 0x00},
+	{0x5a, 0xc8},
+	{0x5b, 0x96},
+	{0x5c, 0x00},
+	{0xd3, 0x02},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* Cold init, JPEG 1024x768, 186 writes instead of 247 */
+const struct sensor_reg OV2640_INIT_1024x768[]  =
+{
+	{0xff, 0x00},
+	{0x2c, 0xff},
+	{0x2e, 0xdf},
+	{0xff, 0x01},
+	{0x3c, 0x32},
+	{0x09, 0x02},
+	{0x13, 0xe5},
+	{0x14, 0x48},
+	{0x2c, 0x0c},
+	{0x33, 0x78},
+	{0x3a, 0x33},
+	{0x3b, 0xfb},
+	{0x3e, 0x00},
+	{0x43, 0x11},
+	{0x16, 0x10},
+	{0x23, 0x00},
+	{0x36, 0x1a},
+	{0x07, 0xc0},
+	{0x4c, 0x00},
+	{0x48, 0x00},
+	{0x5b, 0x00},
+	{0x42, 0x03},
+	{0x4a, 0x81},
+	{0x21, 0x99},
+	{0x24, 0x40},
+	{0x25, 0x38},
+	{0x26, 0x82},
+	{0x5c, 0x00},
+	{0x63, 0x00},
+	{0x61, 0x70},
+	{0x62, 0x80},
+	{0x7c, 0x05},
+	{0x20, 0x80},
+	{0x28, 0x30},
+	{0x6c, 0x00},
+	{0x6e, 0x00},
+	{0x70, 0x02},
+	{0x71, 0x94},
+	{0x73, 0xc1},
+	{0x12, 0x40},
+	{0x46, 0x3f},
+	{0x0c, 0x3c},
+	{0xff, 0x00},
+	{0xf9, 0xc0},
+	{0x41, 0x24},
+	{0xe0, 0x14},
+	{0x76, 0xff},
+	{0x42, 0x20},
+	{0x43, 0x18},
+	{0x4c, 0x00},
+	{0x87, 0xd5},
+	{0x88, 0x3f},
+	{0xd9, 0x10},
+	{0xd3, 0x82},
+	{0xc8, 0x08},
+	{0xc9, 0x80},
+	{0x7c, 0x00},
+	{0x7d, 0x00},
+	{0x7c, 0x03},
+	{0x7d, 0x48},
+	{0x7d, 0x48},
+	{0x7c, 0x08},
+	{0x7d, 0x20},
+	{0x7d, 0x10},
+	{0x7d, 0x0e},
+	{0x90, 0x00},
+	{0x91, 0x0e},
+	{0x91, 0x1a},
+	{0x91, 0x31},
+	{0x91, 0x5a},
+	{0x91, 0x69},
+	{0x91, 0x75},
+	{0x91, 0x7e},
+	{0x91, 0x88},
+	{0x91, 0x8f},
+	{0x91, 0x96},
+	{0x91, 0xa3},
+	{0x91, 0xaf},
+	{0x91, 0xc4},
+	{0x91, 0xd7},
+	{0x91, 0xe8},
+	{0x91, 0x20},
+	{0x92, 0x00},
+	{0x93, 0x06},
+	{0x93, 0xe3},
+	{0x93, 0x05},
+	{0x93, 0x05},
+	{0x93, 0x00},
+	{0x93, 0x04},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x96, 0x00},
+	{0x97, 0x08},
+	{0x97, 0x19},
+	{0x97, 0x02},
+	{0x97, 0x0c},
+	{0x97, 0x24},
+	{0x97, 0x30},
+	{0x97, 0x28},
+	{0x97, 0x26},
+	{0x97, 0x02},
+	{0x97, 0x98},
+	{0x97, 0x80},
+	{0x97, 0x00},
+	{0x97, 0x00},
+	{0xc3, 0xed},
+	{0xa4, 0x00},
+	{0xa8, 0x00},
+	{0xc5, 0x11},
+	{0xc6, 0x51},
+	{0xbf, 0x80},
+	{0xc7, 0x10},
+	{0xb6, 0x66},
+	{0xb8, 0xa5},
+	{0xb7, 0x64},
+	{0xb9, 0x7c},
+	{0xb3, 0xaf},
+	{0xb4, 0x97},
+	{0xb5, 0xff},
+	{0xb0, 0xc5},
+	{0xb1, 0x94},
+	{0xb2, 0x0f},
+	{0xc4, 0x5c},
+	{0xd3, 0x00},
+	{0xc3, 0xed},
+	{0x7f, 0x00},
+	{0xe0, 0x00},
+	{0xdd, 0x7f},
+	{0x05, 0x00},
+	{0x12, 0x40},
+	{0xd3, 0x04},
+	{0x05, 0x00},
+	{0xdf, 0x00},
+	{0x33, 0x80},
+	{0x3c, 0x40},
+	{0x00, 0x00},
+	{0xe0, 0x14},
+	{0xe1, 0x77},
+	{0xe5, 0x1f},
+	{0xd7, 0x03},
+	{0xda, 0x10},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x04, 0x08},
+	{0x15, 0x00},
+	{0x11, 0x01},
+	{0x12, 0x00},
+	{0x17, 0x11},
+	{0x18, 0x75},
+	{0x32, 0x36},
+	{0x19, 0x01},
+	{0x1a, 0x97},
+	{0x03, 0x0f},
+	{0x4f, 0xbb},
+	{0x50, 0x9c},
+	{0x5a, 0x57},
+	{0x6d, 0x80},
+	{0x3d, 0x34},
+	{0x39, 0x02},
+	{0x35, 0x88},
+	{0x22, 0x0a},
+	{0x37, 0x40},
+	{0x34, 0xa0},
+	{0x06, 0x02},
+	{0x0d, 0xb7},
+	{0x0e, 0x01},
+	{0xff, 0x00},
+	{0xc0, 0xc8},
+	{0xc1, 0x96},
+	{0x8c, 0x00},
+	{0x86, 0x3d},
+	{0x50, 0x00},
+	{0x51, 0x90},
+	{0x52, 0x2c},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x88},
+	{0x5a, 0x00},
+	{0x5b, 0xc0},
+	{0x5c, 0x01},
+	{0xd3, 0x02},
+	{0xff, 0xff},
+};
+
+/* Cold init, JPEG 1280x1024, 189 writes instead of 249 */
+const struct sensor_reg OV2640_INIT_1280x1024[]  =
+{
+	{0xff, 0x00},
+	{0x2c, 0xff},
+	{0x2e, 0xdf},
+	{0xff, 0x01},
+	{0x3c, 0x32},
+	{0x09, 0x02},
+	{0x13, 0xe5},
+	{0x14, 0x48},
+	{0x2c, 0x0c},
+	{0x33, 0x78},
+	{0x3a, 0x33},
+	{0x3b, 0xfb},
+	{0x3e, 0x00},
+	{0x43, 0x11},
+	{0x16, 0x10},
+	{0x23, 0x00},
+	{0x36, 0x1a},
+	{0x07, 0xc0},
+	{0x4c, 0x00},
+	{0x48, 0x00},
+	{0x5b, 0x00},
+	{0x42, 0x03},
+	{0x4a, 0x81},
+	{0x21, 0x99},
+	{0x24, 0x40},
+	{0x25, 0x38},
+	{0x26, 0x82},
+	{0x5c, 0x00},
+	{0x63, 0x00},
+	{0x61, 0x70},
+	{0x62, 0x80},
+	{0x7c, 0x05},
+	{0x20, 0x80},
+	{0x28, 0x30},
+	{0x6c, 0x00},
+	{0x6e, 0x00},
+	{0x70, 0x02},
+	{0x71, 0x94},
+	{0x73, 0xc1},
+	{0x12, 0x40},
+	{0x46, 0x3f},
+	{0x0c, 0x3c},
+	{0xff, 0x00},
+	{0xf9, 0xc0},
+	{0x41, 0x24},
+	{0xe0, 0x14},
+	{0x76, 0xff},
+	{0x42, 0x20},
+	{0x43, 0x18},
+	{0x4c, 0x00},
+	{0x87, 0xd5},
+	{0x88, 0x3f},
+	{0xd9, 0x10},
+	{0xd3, 0x82},
+	{0xc8, 0x08},
+	{0xc9, 0x80},
+	{0x7c, 0x00},
+	{0x7d, 0x00},
+	{0x7c, 0x03},
+	{0x7d, 0x48},
+	{0x7d, 0x48},
+	{0x7c, 0x08},
+	{0x7d, 0x20},
+	{0x7d, 0x10},
+	{0x7d, 0x0e},
+	{0x90, 0x00},
+	{0x91, 0x0e},
+	{0x91, 0x1a},
+	{0x91, 0x31},
+	{0x91, 0x5a},
+	{0x91, 0x69},
+	{0x91, 0x75},
+	{0x91, 0x7e},
+	{0x91, 0x88},
+	{0x91, 0x8f},
+	{0x91, 0x96},
+	{0x91, 0xa3},
+	{0x91, 0xaf},
+	{0x91, 0xc4},
+	{0x91, 0xd7},
+	{0x91, 0xe8},
+	{0x91, 0x20},
+	{0x92, 0x00},
+	{0x93, 0x06},
+	{0x93, 0xe3},
+	{0x93, 0x05},
+	{0x93, 0x05},
+	{0x93, 0x00},
+	{0x93, 0x04},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x96, 0x00},
+	{0x97, 0x08},
+	{0x97, 0x19},
+	{0x97, 0x02},
+	{0x97, 0x0c},
+	{0x97, 0x24},
+	{0x97, 0x30},
+	{0x97, 0x28},
+	{0x97, 0x26},
+	{0x97, 0x02},
+	{0x97, 0x98},
+	{0x97, 0x80},
+	{0x97, 0x00},
+	{0x97, 0x00},
+	{0xc3, 0xed},
+	{0xa4, 0x00},
+	{0xa8, 0x00},
+	{0xc5, 0x11},
+	{0xc6, 0x51},
+	{0xbf, 0x80},
+	{0xc7, 0x10},
+	{0xb6, 0x66},
+	{0xb8, 0xa5},
+	{0xb7, 0x64},
+	{0xb9, 0x7c},
+	{0xb3, 0xaf},
+	{0xb4, 0x97},
+	{0xb5, 0xff},
+	{0xb0, 0xc5},
+	{0xb1, 0x94},
+	{0xb2, 0x0f},
+	{0xc4, 0x5c},
+	{0xd3, 0x00},
+	{0xc3, 0xed},
+	{0x7f, 0x00},
+	{0xe0, 0x00},
+	{0xdd, 0x7f},
+	{0x05, 0x00},
+	{0x12, 0x40},
+	{0xd3, 0x04},
+	{0x8c, 0x00},
+	{0x05, 0x00},
+	{0xdf, 0x00},
+	{0x33, 0x80},
+	{0x3c, 0x40},
+	{0x00, 0x00},
+	{0xe0, 0x14},
+	{0xe1, 0x77},
+	{0xe5, 0x1f},
+	{0xd7, 0x03},
+	{0xda, 0x10},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x04, 0x08},
+	{0x15, 0x00},
+	{0x11, 0x01},
+	{0x12, 0x00},
+	{0x17, 0x11},
+	{0x18, 0x75},
+	{0x32, 0x36},
+	{0x19, 0x01},
+	{0x1a, 0x97},
+	{0x03, 0x0f},
+	{0x4f, 0xbb},
+	{0x50, 0x9c},
+	{0x5a, 0x57},
+	{0x6d, 0x80},
+	{0x3d, 0x34},
+	{0x39, 0x02},
+	{0x35, 0x88},
+	{0x22, 0x0a},
+	{0x37, 0x40},
+	{0x34, 0xa0},
+	{0x06, 0x02},
+	{0x0d, 0xb7},
+	{0x0e, 0x01},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0xc8},
+	{0xc1, 0x96},
+	{0x86, 0x3d},
+	{0x50, 0x00},
+	{0x51, 0x90},
+	{0x52, 0x2c},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x88},
+	{0x57, 0x00},
+	{0x5a, 0x40},
+	{0x5b, 0xf0},
+	{0x5c, 0x01},
+	{0xd3, 0x02},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* Cold init, JPEG 1600x1200, 189 writes instead of 249 */
+const struct sensor_reg OV2640_INIT_1600x1200[]  =
+{
+	{0xff, 0x00},
+	{0x2c, 0xff},
+	{0x2e, 0xdf},
+	{0xff, 0x01},
+	{0x3c, 0x32},
+	{0x09, 0x02},
+	{0x13, 0xe5},
+	{0x14, 0x48},
+	{0x2c, 0x0c},
+	{0x33, 0x78},
+	{0x3a, 0x33},
+	{0x3b, 0xfb},
+	{0x3e, 0x00},
+	{0x43, 0x11},
+	{0x16, 0x10},
+	{0x23, 0x00},
+	{0x36, 0x1a},
+	{0x07, 0xc0},
+	{0x4c, 0x00},
+	{0x48, 0x00},
+	{0x5b, 0x00},
+	{0x42, 0x03},
+	{0x4a, 0x81},
+	{0x21, 0x99},
+	{0x24, 0x40},
+	{0x25, 0x38},
+	{0x26, 0x82},
+	{0x5c, 0x00},
+	{0x63, 0x00},
+	{0x61, 0x70},
+	{0x62, 0x80},
+	{0x7c, 0x05},
+	{0x20, 0x80},
+	{0x28, 0x30},
+	{0x6c, 0x00},
+	{0x6e, 0x00},
+	{0x70, 0x02},
+	{0x71, 0x94},
+	{0x73, 0xc1},
+	{0x12, 0x40},
+	{0x46, 0x3f},
+	{0x0c, 0x3c},
+	{0xff, 0x00},
+	{0xf9, 0xc0},
+	{0x41, 0x24},
+	{0xe0, 0x14},
+	{0x76, 0xff},
+	{0x42, 0x20},
+	{0x43, 0x18},
+	{0x4c, 0x00},
+	{0x87, 0xd5},
+	{0x88, 0x3f},
+	{0xd9, 0x10},
+	{0xd3, 0x82},
+	{0xc8, 0x08},
+	{0xc9, 0x80},
+	{0x7c, 0x00},
+	{0x7d, 0x00},
+	{0x7c, 0x03},
+	{0x7d, 0x48},
+	{0x7d, 0x48},
+	{0x7c, 0x08},
+	{0x7d, 0x20},
+	{0x7d, 0x10},
+	{0x7d, 0x0e},
+	{0x90, 0x00},
+	{0x91, 0x0e},
+	{0x91, 0x1a},
+	{0x91, 0x31},
+	{0x91, 0x5a},
+	{0x91, 0x69},
+	{0x91, 0x75},
+	{0x91, 0x7e},
+	{0x91, 0x88},
+	{0x91, 0x8f},
+	{0x91, 0x96},
+	{0x91, 0xa3},
+	{0x91, 0xaf},
+	{0x91, 0xc4},
+	{0x91, 0xd7},
+	{0x91, 0xe8},
+	{0x91, 0x20},
+	{0x92, 0x00},
+	{0x93, 0x06},
+	{0x93, 0xe3},
+	{0x93, 0x05},
+	{0x93, 0x05},
+	{0x93, 0x00},
+	{0x93, 0x04},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x93, 0x00},
+	{0x96, 0x00},
+	{0x97, 0x08},
+	{0x97, 0x19},
+	{0x97, 0x02},
+	{0x97, 0x0c},
+	{0x97, 0x24},
+	{0x97, 0x30},
+	{0x97, 0x28},
+	{0x97, 0x26},
+	{0x97, 0x02},
+	{0x97, 0x98},
+	{0x97, 0x80},
+	{0x97, 0x00},
+	{0x97, 0x00},
+	{0xc3, 0xed},
+	{0xa4, 0x00},
+	{0xa8, 0x00},
+	{0xc5, 0x11},
+	{0xc6, 0x51},
+	{0xbf, 0x80},
+	{0xc7, 0x10},
+	{0xb6, 0x66},
+	{0xb8, 0xa5},
+	{0xb7, 0x64},
+	{0xb9, 0x7c},
+	{0xb3, 0xaf},
+	{0xb4, 0x97},
+	{0xb5, 0xff},
+	{0xb0, 0xc5},
+	{0xb1, 0x94},
+	{0xb2, 0x0f},
+	{0xc4, 0x5c},
+	{0xd3, 0x00},
+	{0xc3, 0xed},
+	{0x7f, 0x00},
+	{0xe0, 0x00},
+	{0xdd, 0x7f},
+	{0x05, 0x00},
+	{0x12, 0x40},
+	{0xd3, 0x04},
+	{0x8c, 0x00},
+	{0x05, 0x00},
+	{0xdf, 0x00},
+	{0x33, 0x80},
+	{0x3c, 0x40},
+	{0x00, 0x00},
+	{0xe0, 0x14},
+	{0xe1, 0x77},
+	{0xe5, 0x1f},
+	{0xd7, 0x03},
+	{0xda, 0x10},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x04, 0x08},
+	{0x15, 0x00},
+	{0x11, 0x01},
+	{0x12, 0x00},
+	{0x17, 0x11},
+	{0x18, 0x75},
+	{0x32, 0x36},
+	{0x19, 0x01},
+	{0x1a, 0x97},
+	{0x03, 0x0f},
+	{0x4f, 0xbb},
+	{0x50, 0x9c},
+	{0x5a, 0x57},
+	{0x6d, 0x80},
+	{0x3d, 0x34},
+	{0x39, 0x02},
+	{0x35, 0x88},
+	{0x22, 0x0a},
+	{0x37, 0x40},
+	{0x34, 0xa0},
+	{0x06, 0x02},
+	{0x0d, 0xb7},
+	{0x0e, 0x01},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0xc8},
+	{0xc1, 0x96},
+	{0x86, 0x3d},
+	{0x50, 0x00},
+	{0x51, 0x90},
+	{0x52, 0x2c},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x88},
+	{0x57, 0x00},
+	{0x5a, 0x90},
+	{0x5b, 0x2c},
+	{0x5c, 0x05},
+	{0xd3, 0x02},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 160x120 -> 176x144 */
+const struct sensor_reg OV2640_DELTA_160x120_176x144[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x5a, 0x2c},
+	{0x5b, 0x24},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 160x120 -> 320x240 */
+const struct sensor_reg OV2640_DELTA_160x120_320x240[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x89},
+	{0x5a, 0x50},
+	{0x5b, 0x3c},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 160x120 -> 352x288 */
+const struct sensor_reg OV2640_DELTA_160x120_352x288[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x89},
+	{0x5a, 0x58},
+	{0x5b, 0x48},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 176x144 -> 160x120 */
+const struct sensor_reg OV2640_DELTA_176x144_160x120[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x5a, 0x28},
+	{0x5b, 0x1e},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 176x144 -> 320x240 */
+const struct sensor_reg OV2640_DELTA_176x144_320x240[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x89},
+	{0x5a, 0x50},
+	{0x5b, 0x3c},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 176x144 -> 352x288 */
+const struct sensor_reg OV2640_DELTA_176x144_352x288[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x89},
+	{0x5a, 0x58},
+	{0x5b, 0x48},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 320x240 -> 160x120 */
+const struct sensor_reg OV2640_DELTA_320x240_160x120[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x92},
+	{0x5a, 0x28},
+	{0x5b, 0x1e},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 320x240 -> 176x144 */
+const struct sensor_reg OV2640_DELTA_320x240_176x144[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x92},
+	{0x5a, 0x2c},
+	{0x5b, 0x24},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 320x240 -> 352x288 */
+const struct sensor_reg OV2640_DELTA_320x240_352x288[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x5a, 0x58},
+	{0x5b, 0x48},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 352x288 -> 160x120 */
+const struct sensor_reg OV2640_DELTA_352x288_160x120[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x92},
+	{0x5a, 0x28},
+	{0x5b, 0x1e},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 352x288 -> 176x144 */
+const struct sensor_reg OV2640_DELTA_352x288_176x144[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x92},
+	{0x5a, 0x2c},
+	{0x5b, 0x24},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 352x288 -> 320x240 */
+const struct sensor_reg OV2640_DELTA_352x288_320x240[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x5a, 0x50},
+	{0x5b, 0x3c},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 640x480 -> 160x120, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_640x480_160x120[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x28},
+	{0x5b, 0x1e},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0xff},
+};
+
+/* 640x480 -> 176x144, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_640x480_176x144[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x2c},
+	{0x5b, 0x24},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0xff},
+};
+
+/* 640x480 -> 320x240, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_640x480_320x240[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x50},
+	{0x5b, 0x3c},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0xff},
+};
+
+/* 640x480 -> 352x288, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_640x480_352x288[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x58},
+	{0x5b, 0x48},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0xff},
+};
+
+/* 640x480 -> 800x600 */
+const struct sensor_reg OV2640_DELTA_640x480_800x600[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x86, 0x35},
+	{0x5a, 0xc8},
+	{0x5b, 0x96},
+	{0xd3, 0x02},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 640x480 -> 1024x768 */
+const struct sensor_reg OV2640_DELTA_640x480_1024x768[]  =
+{
+	{0xff, 0x00},
+	{0x50, 0x00},
+	{0x5a, 0x00},
+	{0x5b, 0xc0},
+	{0x5c, 0x01},
+	{0xd3, 0x02},
+	{0xff, 0xff},
+};
+
+/* 640x480 -> 1280x1024 */
+const struct sensor_reg OV2640_DELTA_640x480_1280x1024[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x00},
+	{0x5a, 0x40},
+	{0x5b, 0xf0},
+	{0x5c, 0x01},
+	{0xd3, 0x02},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 640x480 -> 1600x1200 */
+const struct sensor_reg OV2640_DELTA_640x480_1600x1200[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x00},
+	{0x5a, 0x90},
+	{0x5b, 0x2c},
+	{0x5c, 0x05},
+	{0xd3, 0x02},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 800x600 -> 160x120, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_800x600_160x120[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x28},
+	{0x5b, 0x1e},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 800x600 -> 176x144, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_800x600_176x144[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x2c},
+	{0x5b, 0x24},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 800x600 -> 320x240, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_800x600_320x240[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x50},
+	{0x5b, 0x3c},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 800x600 -> 352x288, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_800x600_352x288[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x58},
+	{0x5b, 0x48},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 800x600 -> 640x480 */
+const struct sensor_reg OV2640_DELTA_800x600_640x480[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x86, 0x3d},
+	{0x5a, 0xa0},
+	{0x5b, 0x78},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 800x600 -> 1024x768 */
+const struct sensor_reg OV2640_DELTA_800x600_1024x768[]  =
+{
+	{0xff, 0x00},
+	{0x86, 0x3d},
+	{0x50, 0x00},
+	{0x5a, 0x00},
+	{0x5b, 0xc0},
+	{0x5c, 0x01},
+	{0xff, 0xff},
+};
+
+/* 800x600 -> 1280x1024 */
+const struct sensor_reg OV2640_DELTA_800x600_1280x1024[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x86, 0x3d},
+	{0x50, 0x00},
+	{0x5a, 0x40},
+	{0x5b, 0xf0},
+	{0x5c, 0x01},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 800x600 -> 1600x1200 */
+const struct sensor_reg OV2640_DELTA_800x600_1600x1200[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x86, 0x3d},
+	{0x50, 0x00},
+	{0x5a, 0x90},
+	{0x5b, 0x2c},
+	{0x5c, 0x05},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1024x768 -> 160x120, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1024x768_160x120[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x28},
+	{0x5b, 0x1e},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1024x768 -> 176x144, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1024x768_176x144[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x2c},
+	{0x5b, 0x24},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1024x768 -> 320x240, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1024x768_320x240[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x50},
+	{0x5b, 0x3c},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1024x768 -> 352x288, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1024x768_352x288[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x58},
+	{0x5b, 0x48},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1024x768 -> 640x480 */
+const struct sensor_reg OV2640_DELTA_1024x768_640x480[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x89},
+	{0x57, 0x00},
+	{0x5a, 0xa0},
+	{0x5b, 0x78},
+	{0x5c, 0x00},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1024x768 -> 800x600 */
+const struct sensor_reg OV2640_DELTA_1024x768_800x600[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x57, 0x00},
+	{0x5a, 0xc8},
+	{0x5b, 0x96},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1024x768 -> 1280x1024 */
+const struct sensor_reg OV2640_DELTA_1024x768_1280x1024[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x57, 0x00},
+	{0x5a, 0x40},
+	{0x5b, 0xf0},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1024x768 -> 1600x1200 */
+const struct sensor_reg OV2640_DELTA_1024x768_1600x1200[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x57, 0x00},
+	{0x5a, 0x90},
+	{0x5b, 0x2c},
+	{0x5c, 0x05},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1280x1024 -> 160x120, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1280x1024_160x120[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x28},
+	{0x5b, 0x1e},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1280x1024 -> 176x144, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1280x1024_176x144[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x2c},
+	{0x5b, 0x24},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1280x1024 -> 320x240, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1280x1024_320x240[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x50},
+	{0x5b, 0x3c},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1280x1024 -> 352x288, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1280x1024_352x288[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x58},
+	{0x5b, 0x48},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1280x1024 -> 640x480 */
+const struct sensor_reg OV2640_DELTA_1280x1024_640x480[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x89},
+	{0x5a, 0xa0},
+	{0x5b, 0x78},
+	{0x5c, 0x00},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1280x1024 -> 800x600 */
+const struct sensor_reg OV2640_DELTA_1280x1024_800x600[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x5a, 0xc8},
+	{0x5b, 0x96},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1280x1024 -> 1024x768 */
+const struct sensor_reg OV2640_DELTA_1280x1024_1024x768[]  =
+{
+	{0xff, 0x00},
+	{0x5a, 0x00},
+	{0x5b, 0xc0},
+	{0xff, 0xff},
+};
+
+/* 1280x1024 -> 1600x1200 */
+const struct sensor_reg OV2640_DELTA_1280x1024_1600x1200[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x5a, 0x90},
+	{0x5b, 0x2c},
+	{0x5c, 0x05},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1600x1200 -> 160x120, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1600x1200_160x120[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x28},
+	{0x5b, 0x1e},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1600x1200 -> 176x144, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1600x1200_176x144[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x92},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x2c},
+	{0x5b, 0x24},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1600x1200 -> 320x240, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1600x1200_320x240[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x50},
+	{0x5b, 0x3c},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1600x1200 -> 352x288, full table and the registers it misses */
+const struct sensor_reg OV2640_DELTA_1600x1200_352x288[]  =
+{
+	{0xff, 0x01},
+	{0x12, 0x40},
+	{0x17, 0x11},
+	{0x18, 0x43},
+	{0x19, 0x00},
+	{0x1a, 0x4b},
+	{0x32, 0x09},
+	{0x4f, 0xca},
+	{0x50, 0xa8},
+	{0x5a, 0x23},
+	{0x6d, 0x00},
+	{0x39, 0x12},
+	{0x35, 0xda},
+	{0x22, 0x1a},
+	{0x37, 0xc3},
+	{0x23, 0x00},
+	{0x34, 0xc0},
+	{0x36, 0x1a},
+	{0x06, 0x88},
+	{0x07, 0xc0},
+	{0x0d, 0x87},
+	{0x0e, 0x41},
+	{0x4c, 0x00},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xc0, 0x64},
+	{0xc1, 0x4b},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x51, 0xc8},
+	{0x52, 0x96},
+	{0x53, 0x00},
+	{0x54, 0x00},
+	{0x55, 0x00},
+	{0x57, 0x00},
+	{0x5a, 0x58},
+	{0x5b, 0x48},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0x01},
+	{0x11, 0x00},
+	{0x3d, 0x38},
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1600x1200 -> 640x480 */
+const struct sensor_reg OV2640_DELTA_1600x1200_640x480[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x50, 0x89},
+	{0x5a, 0xa0},
+	{0x5b, 0x78},
+	{0x5c, 0x00},
+	{0xd3, 0x04},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1600x1200 -> 800x600 */
+const struct sensor_reg OV2640_DELTA_1600x1200_800x600[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x86, 0x35},
+	{0x50, 0x89},
+	{0x5a, 0xc8},
+	{0x5b, 0x96},
+	{0x5c, 0x00},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* 1600x1200 -> 1024x768 */
+const struct sensor_reg OV2640_DELTA_1600x1200_1024x768[]  =
+{
+	{0xff, 0x00},
+	{0x5a, 0x00},
+	{0x5b, 0xc0},
+	{0x5c, 0x01},
+	{0xff, 0xff},
+};
+
+/* 1600x1200 -> 1280x1024 */
+const struct sensor_reg OV2640_DELTA_1600x1200_1280x1024[]  =
+{
+	{0xff, 0x00},
+	{0xe0, 0x04},
+	{0x5a, 0x40},
+	{0x5b, 0xf0},
+	{0x5c, 0x01},
+	{0xe0, 0x00},
+	{0xff, 0xff},
+};
+
+/* Cold init tables, OV2640_RES_* order */
+const struct sensor_reg *const ov2640_init[9] = {
+	OV2640_INIT_160x120,
+	OV2640_INIT_176x144,
+	OV2640_INIT_320x240,
+	OV2640_INIT_352x288,
+	OV2640_INIT_640x480,
+	OV2640_INIT_800x600,
+	OV2640_INIT_1024x768,
+	OV2640_INIT_1280x1024,
+	OV2640_INIT_1600x1200
+};
+
+/* Resolution switch tables, [from][to] in OV2640_RES_* order, 0 on the diagonal.
+ * Switches the full table of ov2640_regs.h does on its own use it */
+const struct sensor_reg *const ov2640_delta[9][9] = {
+	{ 0, OV2640_DELTA_160x120_176x144, OV2640_DELTA_160x120_320x240, OV2640_DELTA_160x120_352x288, OV2640_640x480_JPEG, OV2640_800x600_JPEG, OV2640_1024x768_JPEG, OV2640_1280x1024_JPEG, OV2640_1600x1200_JPEG },
+	{ OV2640_DELTA_176x144_160x120, 0, OV2640_DELTA_176x144_320x240, OV2640_DELTA_176x144_352x288, OV2640_640x480_JPEG, OV2640_800x600_JPEG, OV2640_1024x768_JPEG, OV2640_1280x1024_JPEG, OV2640_1600x1200_JPEG },
+	{ OV2640_DELTA_320x240_160x120, OV2640_DELTA_320x240_176x144, 0, OV2640_DELTA_320x240_352x288, OV2640_640x480_JPEG, OV2640_800x600_JPEG, OV2640_1024x768_JPEG, OV2640_1280x1024_JPEG, OV2640_1600x1200_JPEG },
+	{ OV2640_DELTA_352x288_160x120, OV2640_DELTA_352x288_176x144, OV2640_DELTA_352x288_320x240, 0, OV2640_640x480_JPEG, OV2640_800x600_JPEG, OV2640_1024x768_JPEG, OV2640_1280x1024_JPEG, OV2640_1600x1200_JPEG },
+	{ OV2640_DELTA_640x480_160x120, OV2640_DELTA_640x480_176x144, OV2640_DELTA_640x480_320x240, OV2640_DELTA_640x480_352x288, 0, OV2640_DELTA_640x480_800x600, OV2640_DELTA_640x480_1024x768, OV2640_DELTA_640x480_1280x1024, OV2640_DELTA_640x480_1600x1200 },
+	{ OV2640_DELTA_800x600_160x120, OV2640_DELTA_800x600_176x144, OV2640_DELTA_800x600_320x240, OV2640_DELTA_800x600_352x288, OV2640_DELTA_800x600_640x480, 0, OV2640_DELTA_800x600_1024x768, OV2640_DELTA_800x600_1280x1024, OV2640_DELTA_800x600_1600x1200 },
+	{ OV2640_DELTA_1024x768_160x120, OV2640_DELTA_1024x768_176x144, OV2640_DELTA_1024x768_320x240, OV2640_DELTA_1024x768_352x288, OV2640_DELTA_1024x768_640x480, OV2640_DELTA_1024x768_800x600, 0, OV2640_DELTA_1024x768_1280x1024, OV2640_DELTA_1024x768_1600x1200 },
+	{ OV2640_DELTA_1280x1024_160x120, OV2640_DELTA_1280x1024_176x144, OV2640_DELTA_1280x1024_320x240, OV2640_DELTA_1280x1024_352x288, OV2640_DELTA_1280x1024_640x480, OV2640_DELTA_1280x1024_800x600, OV2640_DELTA_1280x1024_1024x768, 0, OV2640_DELTA_1280x1024_1600x1200 },
+	{ OV2640_DELTA_1600x1200_160x120, OV2640_DELTA_1600x1200_176x144, OV2640_DELTA_1600x1200_320x240, OV2640_DELTA_1600x1200_352x288, OV2640_DELTA_1600x1200_640x480, OV2640_DELTA_1600x1200_800x600, OV2640_DELTA_1600x1200_1024x768, OV2640_DELTA_1600x1200_1280x1024, 0 }
+};
+
+#endif /* OV2640_REGS_OPT_H_ */
@@ -0,0 +1,230 @@
+/* DriverLib Includes */
+#include "driverlib.h"
+
+/* Standard Includes */
+#include <stdint.h>
+#include <string.h>
+#include "ecc_p192.h"
+#include "energy.h"
+#include "fpga_ecc.h"
+#include "node_key.h"
+#include "rekey.h"
+#include "xbee_driver.h"
+
+uint8_t rekey_engine = REKEY_ENGINE;
+
+/* FPGA rekey in flight, finished from the main loop by rekey_poll() */
+static uint8_t pending_frame[REKEY_FRAME_LEN];
+static uint8_t rekey_pending = 0;
+static uint8_t pending_superseded = 0;	// a later rekey was installed, the result of this one is dropped
+
+/* Decrypt in software, frame = R || C */
+static int rekey_software(const uint8_t frame[], uint8_t message[]) {
+	P192_POINT r, c, m;
+	uint32_t k[P192_LIMBS];
+	int ok;
+
+	p192_from_bytes(k, node_private_key);
+	p192_point_from_bytes(&r, frame);
+	p192_point_from_bytes(&c, &frame[REKEY_POINT_LEN]);
+
+	ok = p192_elgamal_decrypt(&m, k, &r, &c);
+	if(ok)
+		p192_point_to_bytes(message, &m);
+
+	memset(k, 0, sizeof(k));
+	return ok;
+}
+
+/* Decrypt on the FPGA ECC core, blocking */
+static int rekey_fpga(const uint8_t frame[], uint8_t message[]) {
+	if(!fpga_ecc_start(frame, &frame[REKEY_POINT_LEN]))
+		return 0;
+	if(fpga_ecc_wait() != FPGA_ECC_DONE)
+		return 0;
+	return fpga_ecc_result(message);
+}
+
+/* Function that decrypts M = C - kR with the given engine
+ * frame   --- R || C, 96 bytes
+ * message --- M, 48 bytes */
+int rekey_decrypt(uint8_t engine, const uint8_t frame[], uint8_t message[]) {
+	if(engine == REKEY_ENGINE_FPGA)
+		return rekey_fpga(frame, message);
+	return rekey_software(frame, message);
+}
+
+/* Session key = the first 32 significant hex digits of M.x, the same string
+ * El_gamal.py takes with str(hex(M[0]))[0:34] */
+static void session_key_from_message(const uint8_t message[]) {
+	uint8_t hex[2 * P192_BYTES];
+	int start = 0;
+
+	hex_array_to_ascii(hex, (unsigned char *)message, P192_BYTES);
+	while(start < 2 * P192_BYTES - SESSION_KEY_LEN && hex[start] == '0')
+		start++;
+	memcpy(session_key, &hex[start], SESSION_KEY_LEN);
+}
+
+// load the session key of a decrypted message into the XBee, message is cleared
+static int install_session_key(uint8_t message[]) {
+	int ok;
+
+	session_key_from_message(message);
+	memset(message, 0, REKEY_POINT_LEN);
+
+	ok = apply_session_key();
+	if(ok)
+		energy_count(ENERGY_EVENT_REKEY);
+	return ok;
+}
+
+/* Function that recovers the session key from R and C and loads it into the XBee */
+int rekey_session_key(const uint8_t frame[]) {
+	uint8_t message[REKEY_POINT_LEN];
+	uint8_t phase = energy_begin(ENERGY_PHASE_REKEY);
+	int ok = 0;
+
+	if(rekey_decrypt(rekey_engine, frame, message))
+		ok = install_session_key(message);
+
+	energy_end(phase);
+	return ok;
+}
+
+/* Function that starts a rekey without waiting for the FPGA. The software engine
+ * finishes here; an FPGA rekey completes later in rekey_poll(), so capture and
+ * radio work keep running while the core computes. frame is copied, RXBuffer can be reused.
+ * If the core is busy, with an earlier rekey or otherwise, the software engine decrypts
+ * right away; the key of an earlier rekey still on the FPGA is then dropped in rekey_poll() */
+int rekey_start(const uint8_t frame[]) {
+	uint8_t message[REKEY_POINT_LEN];
+	uint8_t phase = energy_begin(ENERGY_PHASE_REKEY);
+	int ok = 0;
+
+	if(rekey_engine == REKEY_ENGINE_FPGA && !rekey_pending
+			&& fpga_ecc_start(frame, &frame[REKEY_POINT_LEN])) {
+		memcpy(pending_frame, frame, REKEY_FRAME_LEN);	// kept for the software fallback in rekey_poll()
+		rekey_pending = 1;
+		pending_superseded = 0;
+		energy_end(phase);
+		return 1;
+	}
+
+	if(rekey_pending)
+		pending_superseded = 1;
+	if(rekey_software(frame, message))
+		ok = install_session_key(message);
+	energy_end(phase);
+	return ok;
+}
+
+/* Function that advances a pending FPGA rekey, call from the main loop.
+ * If the FPGA fails (NACK or timeout) the rekey falls back to the software engine */
+void rekey_poll() {
+	uint8_t message[REKEY_POINT_LEN];
+	uint8_t phase;
+	FPGA_ECC_STATE s;
+
+	if(!rekey_pending)
+		return;
+
+	s = fpga_ecc_poll();
+	if(pending_superseded && (s == FPGA_ECC_DONE || s == FPGA_ECC_ERROR || s == FPGA_ECC_IDLE)) {
+		rekey_pending = 0;		// core is free again, its key is older than the one installed
+		pending_superseded = 0;
+	}
+	else if(s == FPGA_ECC_DONE) {
+		phase = energy_begin(ENERGY_PHASE_REKEY);
+		rekey_pending = 0;
+		fpga_ecc_result(message);
+		install_session_key(message);
+		energy_end(phase);
+	}
+	else if(s == FPGA_ECC_ERROR || s == FPGA_ECC_IDLE) {
+		phase = energy_begin(ENERGY_PHASE_REKEY);
+		rekey_pending = 0;
+		if(rekey_software(pending_frame, message))
+			install_session_key(message);
+		energy_end(phase);
+	}
+}
+
+/* Timer32 counts MCLK cycles down from 0xFFFFFFFF */
+static void bench_timer_start() {
+	MAP_Timer32_initModule(TIMER32_0_BASE, TIMER32_PRESCALER_1, TIMER32_32BIT, TIMER32_FREE_RUN_MODE);
+	MAP_Timer32_setCount(TIMER32_0_BASE, 0xFFFFFFFF);
+	MAP_Timer32_startTimer(TIMER32_0_BASE, false);
+}
+
+static uint32_t bench_timer_elapsed() {
+	uint32_t cycles = 0xFFFFFFFF - MAP_Timer32_getValue(TIMER32_0_BASE);
+
+	MAP_Timer32_haltTimer(TIMER32_0_BASE);
+	return cycles;
+}
+
+/* Function that times the full rekey decryption on both engines with the same R and C,
+ * so the engine for a deployment can be picked from measured numbers.
+ * The FPGA time is the complete I2C round trip, its phases come from the driver */
+void rekey_benchmark(const uint8_t frame[], REKEY_BENCH *bench) {
+	uint8_t sw_message[REKEY_POINT_LEN], fpga_message[REKEY_POINT_LEN];
+	int sw_ok, fpga_ok;
+
+	bench->mclk = MAP_CS_getMCLK();
+
+	bench_timer_start();
+	sw_ok = rekey_software(frame, sw_message);
+	bench->software_cycles = bench_timer_elapsed();
+
+	bench_timer_start();
+	fpga_ok = rekey_fpga(frame, fpga_message);
+	bench->fpga_cycles = bench_timer_elapsed();
+	bench->fpga_phases = *fpga_ecc_timing();
+
+	bench->results_match = sw_ok && fpga_ok && !memcmp(sw_message, fpga_message, sizeof(sw_message));
+}
+
+// append the decimal value of n to report, returns the new length
+static int append_uint(char report[], int len, uint32_t n) {
+	char digits[10];
+	int i = 0;
+
+	do {
+		digits[i++] = '0' + n % 10;
+		n /= 10;
+	} while(n);
+	while(i)
+		report[len++] = digits[--i];
+	return len;
+}
+
+static int append_str(char report[], int len, const char *str) {
+	while(*str)
+		report[len++] = *str++;
+	return len;
+}
+
+/* Format the benchmark for the coordinator:
+ * "SW <us> FPGA <us> W <us> C <us> R <us> MATCH|DIFF\r", W/C/R being the FPGA write, compute and read phases */
+int rekey_benchmark_report(const REKEY_BENCH *bench, char report[]) {
+	uint32_t cycles_per_us = bench->mclk / 1000000;
+	int len = 0;
+
+	if(cycles_per_us == 0)
+		cycles_per_us = 1;
+
+	len = append_str(report, len, "SW ");
+	len = append_uint(report, len, bench->software_cycles / cycles_per_us);
+	len = append_str(report, len, " FPGA ");
+	len = append_uint(report, len, bench->fpga_cycles / cycles_per_us);
+	len = append_str(report, len, " W ");
+	len = append_uint(report, len, bench->fpga_phases.write_cycles / cycles_per_us);
+	len = append_str(report, len, " C ");
+	len = append_uint(report, len, bench->fpga_phases.compute_cycles / cycles_per_us);
+	len = append_str(report, len, " R ");
+	len = append_uint(report, len, bench->fpga_phases.read_cycles / cycles_per_us);
+	len = append_str(report, len, bench->results_match ? " MATCH\r" : " DIFF\r");
+
+	return len;
+}
@@ -0,0 +1,45 @@
+/*
+ * rekey.h
+ *
+ * Node side of the ElGamal rekey: recovers the message point M = C - kR sent
+ * by the coordinator and turns it into the XBee session key. The decryption
+ * can run on the FPGA ECC core or in software (ecc_p192.c), selected per
+ * deployment with REKEY_ENGINE or at run time through rekey_engine.
+ */
+
+#ifndef REKEY_H_
+#define REKEY_H_
+
+#include <stdint.h>
+#include "fpga_ecc.h"
+
+#define REKEY_ENGINE_SOFTWARE 0
+#define REKEY_ENGINE_FPGA 1
+
+// Engine used after reset, override in the build settings (-DREKEY_ENGINE=1)
+#ifndef REKEY_ENGINE
+#define REKEY_ENGINE REKEY_ENGINE_SOFTWARE
+#endif
+
+#define REKEY_POINT_LEN 48						// X || Y, 24 bytes each, big endian
+#define REKEY_FRAME_LEN (2 * REKEY_POINT_LEN)	// R || C as sent after the '3'/'4' command byte
+#define REKEY_REPORT_LEN 80
+
+typedef struct _rekey_bench {
+	uint32_t software_cycles;
+	uint32_t fpga_cycles;
+	uint32_t mclk;
+	FPGA_ECC_TIMING fpga_phases;
+	uint8_t results_match;
+} REKEY_BENCH;
+
+extern uint8_t rekey_engine;
+
+int rekey_decrypt(uint8_t engine, const uint8_t frame[], uint8_t message[]);
+int rekey_session_key(const uint8_t frame[]);
+int rekey_start(const uint8_t frame[]);
+void rekey_poll();
+void rekey_benchmark(const uint8_t frame[], REKEY_BENCH *bench);
+int rekey_benchmark_report(const REKEY_BENCH *bench, char report[]);
+
+#endif /* REKEY_H_ */
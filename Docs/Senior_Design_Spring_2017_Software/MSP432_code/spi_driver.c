@@ -75,4 +75,29 @@ int spi_Read(unsigned char addr, unsigned char *data, int len)
     return len;
 }
 
+/* Same as spi_Read, every data byte also goes to the CRC32 module while the
+ * next one is on the bus. The caller seeds the module (image_crc32_start) */
+int spi_Read_crc32(unsigned char addr, unsigned char *data, int len)
+{
+    int i = 0;
+
+    ASSERT_CS();
+
+    for (i = 0; i < len; i ++)
+    {
+        while (!(UCB0IFG&UCTXIFG));		// wait for TX flag
+        if(i >= 1) UCB0TXBUF = 0x00;	// send dummy byte if greater than 1
+        else UCB0TXBUF = addr;	// send address if this is the first send
+        if(i >= 2) MAP_CRC32_set8BitData(data[i - 2], CRC32_MODE);	// previous byte, overlaps the transfer
+        while (!(UCB0IFG&UCRXIFG));		// wait for RX flag
+        if(i >= 1) data[i - 1] = UCB0RXBUF;	// store data if the address has already been sent
+        else UCB0RXBUF;	// don't care about first byte sent from Arducam
+    }
+    if(len >= 2) MAP_CRC32_set8BitData(data[len - 2], CRC32_MODE);	// last byte
+
+    DEASSERT_CS();
+
+    return len;
+}
+
 
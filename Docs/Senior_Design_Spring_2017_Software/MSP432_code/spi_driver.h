@@ -5,6 +5,7 @@
 void spi_init(void);
 void spi_Write(unsigned char addr, unsigned char value);
 int spi_Read(unsigned char addr, unsigned char *data, int len);
+int spi_Read_crc32(unsigned char addr, unsigned char *data, int len);
 
 #endif
 #endif /* SL_IF_TYPE_UART */
@@ -57,7 +57,11 @@ extern unsigned long __STACK_END;
 /* External declarations for the interrupt handlers used by the application. */
 extern void EUSCIA2_IRQHandler(void);
 extern void EUSCIB1_IRQHandler(void);
+extern void DMA_INT2_IRQHandler(void);
+extern void PORT2_IRQHandler(void);
 extern void PORT3_IRQHandler(void);
+extern void TA1_0_IRQHandler(void);
+extern void TA1_N_IRQHandler(void);
 
 /* Interrupt vector table.  Note that the proper constructs must be placed on this to  */
 /* ensure that it ends up at physical address 0x0000.0000 or at the start of          */
@@ -93,8 +97,8 @@ void (* const interruptVectors[])(void) =
     defaultISR,                             /* COMP1 ISR                 */
     defaultISR,                             /* TA0_0 ISR                 */
     defaultISR,                             /* TA0_N ISR                 */
-	defaultISR,      	                    /* TA1_0 ISR                 */
-    defaultISR,                             /* TA1_N ISR                 */
+	TA1_0_IRQHandler,      	                /* TA1_0 ISR                 */
+    TA1_N_IRQHandler,                       /* TA1_N ISR                 */
     defaultISR,                             /* TA2_0 ISR                 */
     defaultISR,                             /* TA2_N ISR                 */
     defaultISR,                             /* TA3_0 ISR                 */
@@ -115,11 +119,11 @@ void (* const interruptVectors[])(void) =
     defaultISR,                             /* RTC ISR                   */
     defaultISR,                             /* DMA_ERR ISR               */
     defaultISR,                             /* DMA_INT3 ISR              */
-	defaultISR,                             /* DMA_INT2 ISR              */
+	DMA_INT2_IRQHandler,                    /* DMA_INT2 ISR              */
 	defaultISR,   					   	    /* DMA_INT1 ISR              */
     defaultISR,                             /* DMA_INT0 ISR              */
     defaultISR,                             /* PORT1 ISR                 */
-    defaultISR,                             /* PORT2 ISR                 */
+    PORT2_IRQHandler,                       /* PORT2 ISR                 */
 	PORT3_IRQHandler, 		                /* PORT3 ISR                 */
     defaultISR,                             /* PORT4 ISR                 */
     defaultISR,                             /* PORT5 ISR                 */
@@ -0,0 +1,195 @@
+/* DriverLib Includes */
+#include "driverlib.h"
+
+/* Standard Includes */
+#include <stdint.h>
+#include "energy.h"
+#include "sw_timer.h"
+
+static volatile uint32_t overflows = 0;	// upper 16 bits of the time base
+static SW_TIMER *head = 0;				// active timers, earliest deadline first
+
+const Timer_A_ContinuousModeConfig sw_timer_config = {
+		TIMER_A_CLOCKSOURCE_ACLK,				// ACLK Clock Source
+		TIMER_A_CLOCKSOURCE_DIVIDER_1,			// 32.768 kHz, 30.5 us per tick
+		TIMER_A_TAIE_INTERRUPT_ENABLE,			// overflow interrupt extends the counter
+		TIMER_A_DO_CLEAR						// Clear counter
+};
+
+// deadline a is before deadline b, valid across the 32-bit wrap
+#define BEFORE(a, b) ((int32_t)((a) - (b)) < 0)
+
+/* Function that starts the time base, call first in main() */
+void sw_timer_init() {
+	MAP_Timer_A_configureContinuousMode(TIMER_A1_BASE, &sw_timer_config);
+	MAP_Timer_A_setCompareValue(TIMER_A1_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_0, 0);
+	MAP_Interrupt_enableInterrupt(INT_TA1_0);
+	MAP_Interrupt_enableInterrupt(INT_TA1_N);
+	MAP_Timer_A_startCounter(TIMER_A1_BASE, TIMER_A_CONTINUOUS_MODE);
+}
+
+/* Time base with interrupts masked or from an ISR. An overflow that is not serviced
+ * yet is counted here, the low word is read again after the flag is seen */
+static uint32_t now_locked() {
+	uint16_t low = MAP_Timer_A_getCounterValue(TIMER_A1_BASE);
+	uint32_t high = overflows;
+
+	if(MAP_Timer_A_getInterruptStatus(TIMER_A1_BASE) == TIMER_A_INTERRUPT_PENDING) {
+		low = MAP_Timer_A_getCounterValue(TIMER_A1_BASE);
+		high++;
+	}
+	return high << 16 | low;
+}
+
+/* Function that returns the time base in ticks (SW_TIMER_HZ) */
+uint32_t sw_timer_now() {
+	bool masked = MAP_Interrupt_disableMaster();
+	uint32_t t = now_locked();
+
+	if(!masked)
+		MAP_Interrupt_enableMaster();
+	return t;
+}
+
+static void insert(SW_TIMER *timer) {
+	SW_TIMER **p = &head;
+
+	while(*p && !BEFORE(timer->deadline, (*p)->deadline))
+		p = &(*p)->next;
+	timer->next = *p;
+	*p = timer;
+	timer->active = 1;
+}
+
+static void unlink(SW_TIMER *timer) {
+	SW_TIMER **p = &head;
+
+	while(*p && *p != timer)
+		p = &(*p)->next;
+	if(*p)
+		*p = timer->next;
+	timer->active = 0;
+}
+
+/* Fire every timer whose deadline has passed and set CCR0 to the next one. CCR0 only
+ * holds the low word, a deadline further out makes it match once per wrap until the
+ * high word is reached. Runs with interrupts masked or from the CCR0 ISR */
+static void service() {
+	SW_TIMER *timer;
+
+	for(;;) {
+		while(head && !BEFORE(now_locked(), head->deadline)) {
+			timer = head;
+			head = timer->next;
+			timer->active = 0;
+			timer->expired = 1;
+			if(timer->period) {
+				timer->deadline += timer->period;
+				insert(timer);
+			}
+			if(timer->callback)
+				timer->callback(timer->arg);
+		}
+		if(!head) {
+			MAP_Timer_A_disableCaptureCompareInterrupt(TIMER_A1_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_0);
+			return;
+		}
+
+		MAP_Timer_A_setCompareValue(TIMER_A1_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_0, (uint16_t)head->deadline);
+		MAP_Timer_A_clearCaptureCompareInterrupt(TIMER_A1_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_0);
+		MAP_Timer_A_enableCaptureCompareInterrupt(TIMER_A1_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_0);
+
+		// a deadline that passed while CCR0 was written would only match after the next wrap
+		if(BEFORE(now_locked() + 1, head->deadline))
+			return;
+	}
+}
+
+/* Function that starts (or restarts) a timer
+ * delay_ms  --- time to the first expiry
+ * period_ms --- time between expiries after that, 0 for a one-shot timer
+ * callback  --- called from the interrupt on expiry, may be 0 */
+void sw_timer_start(SW_TIMER *timer, uint32_t delay_ms, uint32_t period_ms, SW_TIMER_CALLBACK callback, void *arg) {
+	bool masked = MAP_Interrupt_disableMaster();
+
+	if(timer->active)
+		unlink(timer);
+	timer->deadline = now_locked() + SW_TIMER_TICKS(delay_ms);
+	timer->period = SW_TIMER_TICKS(period_ms);
+	timer->callback = callback;
+	timer->arg = arg;
+	timer->expired = 0;
+	insert(timer);
+	service();
+
+	if(!masked)
+		MAP_Interrupt_enableMaster();
+}
+
+void sw_timer_stop(SW_TIMER *timer) {
+	bool masked = MAP_Interrupt_disableMaster();
+
+	if(timer->active) {
+		unlink(timer);
+		service();
+	}
+
+	if(!masked)
+		MAP_Interrupt_enableMaster();
+}
+
+/* Sleep in LPM0 until the next interrupt. The master is disabled around the sleep,
+ * a pending interrupt still wakes the core and is serviced after */
+void sw_timer_idle() {
+	energy_mcu(ENERGY_MCU_LPM0);
+	MAP_Interrupt_disableMaster();
+	MAP_PCM_gotoLPM0();
+	MAP_Interrupt_enableMaster();
+	energy_mcu(ENERGY_MCU_ACTIVE);
+}
+
+/* Function that sleeps for ms milliseconds, replaces _delay_cycles */
+void sw_timer_delay_ms(uint32_t ms) {
+	SW_TIMER timer;
+
+	timer.active = 0;
+	sw_timer_start(&timer, ms, 0, 0, 0);
+	energy_mcu(ENERGY_MCU_LPM0);
+	for(;;) {
+		MAP_Interrupt_disableMaster();
+		if(timer.expired)
+			break;
+		MAP_PCM_gotoLPM0();
+		MAP_Interrupt_enableMaster();
+	}
+	MAP_Interrupt_enableMaster();
+	energy_mcu(ENERGY_MCU_ACTIVE);
+}
+
+/* Timeouts: deadline = sw_timer_deadline(ms), then poll sw_timer_passed(deadline) */
+uint32_t sw_timer_deadline(uint32_t ms) {
+	return sw_timer_now() + SW_TIMER_TICKS(ms);
+}
+
+int sw_timer_passed(uint32_t deadline) {
+	return !BEFORE(sw_timer_now(), deadline);
+}
+
+/* Function that converts ticks to ms, sw_timer_now() gives ms since reset */
+uint32_t sw_timer_ms(uint32_t ticks) {
+	return ticks / SW_TIMER_HZ * 1000 + ticks % SW_TIMER_HZ * 1000 / SW_TIMER_HZ;
+}
+
+/* Timer_A1 CCR0 ISR, deadline of the first timer */
+void TA1_0_IRQHandler(void)
+{
+	MAP_Timer_A_clearCaptureCompareInterrupt(TIMER_A1_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_0);
+	service();
+}
+
+/* Timer_A1 overflow ISR, upper half of the time base */
+void TA1_N_IRQHandler(void)
+{
+	MAP_Timer_A_clearInterruptFlag(TIMER_A1_BASE);
+	overflows++;
+}
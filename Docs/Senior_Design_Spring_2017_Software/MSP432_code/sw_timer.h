@@ -0,0 +1,43 @@
+/*
+ * sw_timer.h
+ *
+ * Software timer service on Timer_A1, clocked from ACLK (32.768 kHz REFO) in
+ * continuous mode. The 16-bit counter is extended to 32 bits in the overflow
+ * interrupt, CCR0 is set to the deadline of the first timer of an ordered list.
+ * Timers are one-shot or periodic, the memory of a timer belongs to the caller.
+ *
+ * Delays and timeouts sleep in LPM0 until their deadline, SMCLK keeps running so
+ * the UART, DMA and SPI are not disturbed. Callbacks run in the interrupt.
+ */
+
+#ifndef SW_TIMER_H_
+#define SW_TIMER_H_
+
+#include <stdint.h>
+
+#define SW_TIMER_HZ 32768						// ACLK
+#define SW_TIMER_TICKS(ms) ((uint32_t)(ms) * SW_TIMER_HZ / 1000)
+
+typedef void (*SW_TIMER_CALLBACK)(void *arg);
+
+typedef struct _sw_timer {
+	struct _sw_timer *next;
+	uint32_t deadline;			// ticks
+	uint32_t period;			// ticks, 0 = one-shot
+	SW_TIMER_CALLBACK callback;	// may be 0, runs in the interrupt
+	void *arg;
+	volatile uint8_t expired;	// set every time the timer fires
+	uint8_t active;
+} SW_TIMER;
+
+void sw_timer_init();
+uint32_t sw_timer_now();
+void sw_timer_start(SW_TIMER *timer, uint32_t delay_ms, uint32_t period_ms, SW_TIMER_CALLBACK callback, void *arg);
+void sw_timer_stop(SW_TIMER *timer);
+void sw_timer_delay_ms(uint32_t ms);
+uint32_t sw_timer_deadline(uint32_t ms);
+int sw_timer_passed(uint32_t deadline);
+uint32_t sw_timer_ms(uint32_t ticks);
+void sw_timer_idle();
+
+#endif /* SW_TIMER_H_ */
@@ -23,6 +23,11 @@ const XBEE_CMD ID_CMD = {"ATID", 4, 1, 4};
 const XBEE_CMD OI_CMD = {"ATOI", 4, 0, 4};
 const XBEE_CMD SH_CMD = {"ATSH", 4, 0, 6};
 const XBEE_CMD SL_CMD = {"ATSL", 4, 0, 8};
+const XBEE_CMD OP_CMD = {"ATOP", 4, 0, 16};
+const XBEE_CMD ID_EXT_CMD = {"ATID", 4, 2, 16};
+const XBEE_CMD CH_CMD = {"ATCH", 4, 0, 2};
+const XBEE_CMD SC_CMD = {"ATSC", 4, 1, 4};
+const XBEE_CMD D7_CMD = {"ATD7", 4, 1, 1};
 
 
 #endif /* XBEE_COMMANDS_H_ */
@@ -4,6 +4,9 @@
 /* Standard Includes */
 #include <stdint.h>
 #include <string.h>
+#include "energy.h"
+#include "net_state.h"
+#include "sw_timer.h"
 #include "xbee_driver.h"
 #include "xbee_commands.h"
 
@@ -11,7 +14,21 @@
 #define GOT_OK 1
 #define GOT_ERROR 0
 #define TIMEOUT 0
-#define TIMEOUT_PERIOD 3000000
+#define TIMEOUT_MS 1000				// response timeout
+#define POLL_MS 1					// RXBuffer is filled by DMA without an interrupt, sleep between scans
+/* Pause around every command mode session. The module only takes +++ after a silence of its
+ * guard time (ATGT, default 0x3E8 = 1000 ms) and answers nothing until another guard time has
+ * passed, so this has to exceed 1 s. 250 ms on top cover the 1 ms steps of sw_timer and
+ * bytes still in the UART */
+#define GUARD_MS 1250
+/* Timeout for the OK to +++. The module answers only after a second guard time, so the
+ * response timeout would run out with the reply still on the wire */
+#define CMD_MODE_TIMEOUT_MS 1500
+#define NO_RESPONSE 2
+
+uint8_t wait_OK();
+uint8_t wait_CR();
+static int enter_cmd_mode();
 
 /* DMA Control Table */
 #ifdef ewarm
@@ -30,41 +47,123 @@ extern uint8_t Data[];
 // UART Settings Calculator :
 // http://software-dl.ti.com/msp430/msp430_public_sw/mcu/msp430/MSP430BaudRateConverter/index.html
 
-/* Below are two UART configurations for different XBee modes of operation
- * These could be reduced to one, however we were not able to use SMCLK
- * for image transfer without substantial packet loss
+/* One UART configuration per XBee rate, all from SMCLK = DCO / 2 = 12 MHz (init_clocks() in main.c).
+ * SMCLK used to come from MODOSC, which is too far off for the higher rates, so images
+ * were sent at 9600 from ACLK with the module reconfigured around every image.
+ * Divider values from the baud rate table of the MSP432P4xx user's guide, fastest last.
  */
-
-/* UART configuration for using XBee command mode */
-const eUSCI_UART_Config uartConfig = {
-        EUSCI_A_UART_CLOCKSOURCE_SMCLK,          // SMCLK Clock Source
-        81,                                     // BRDIV = 78
-        6,                                     // UCxBRF = 2
-        2,                                    // UCxBRS = 0
-		EUSCI_A_UART_NO_PARITY,                  // No Parity
-        EUSCI_A_UART_LSB_FIRST,                  // LSB First
-        EUSCI_A_UART_ONE_STOP_BIT,               // One stop bit
-		EUSCI_A_UART_MODE,                       // UART mode
-		EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION  // Oversampling
+typedef struct _xbee_baud {
+	char bd;						// ATBD parameter
+	uint32_t rate;
+	eUSCI_UART_Config config;
+} XBEE_BAUD;
+
+static const XBEE_BAUD xbee_bauds[] = {
+	{ '3', 9600, { EUSCI_A_UART_CLOCKSOURCE_SMCLK, 78, 2, 0x00, EUSCI_A_UART_NO_PARITY, EUSCI_A_UART_LSB_FIRST,
+			EUSCI_A_UART_ONE_STOP_BIT, EUSCI_A_UART_MODE, EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION } },
+	{ '4', 19200, { EUSCI_A_UART_CLOCKSOURCE_SMCLK, 39, 1, 0x00, EUSCI_A_UART_NO_PARITY, EUSCI_A_UART_LSB_FIRST,
+			EUSCI_A_UART_ONE_STOP_BIT, EUSCI_A_UART_MODE, EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION } },
+	{ '5', 38400, { EUSCI_A_UART_CLOCKSOURCE_SMCLK, 19, 8, 0x65, EUSCI_A_UART_NO_PARITY, EUSCI_A_UART_LSB_FIRST,
+			EUSCI_A_UART_ONE_STOP_BIT, EUSCI_A_UART_MODE, EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION } },
+	{ '6', 57600, { EUSCI_A_UART_CLOCKSOURCE_SMCLK, 13, 0, 0x25, EUSCI_A_UART_NO_PARITY, EUSCI_A_UART_LSB_FIRST,
+			EUSCI_A_UART_ONE_STOP_BIT, EUSCI_A_UART_MODE, EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION } },
+	{ '7', 115200, { EUSCI_A_UART_CLOCKSOURCE_SMCLK, 6, 8, 0x20, EUSCI_A_UART_NO_PARITY, EUSCI_A_UART_LSB_FIRST,
+			EUSCI_A_UART_ONE_STOP_BIT, EUSCI_A_UART_MODE, EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION } }
 };
 
-/* UART configuration for sending an image via the XBee module */
-const eUSCI_UART_Config uartConfig_image =
-{
-        EUSCI_A_UART_CLOCKSOURCE_ACLK,          // ACLK Clock Source
-        03,                                     // BRDIV = 3
-        0x0,                                     // UCxBRF = 0
-        0x53,                                    // UCxBRS = 0x53
-		EUSCI_A_UART_NO_PARITY,                  // No Parity
-        EUSCI_A_UART_LSB_FIRST,                  // LSB First
-        EUSCI_A_UART_ONE_STOP_BIT,               // One stop bit
-        EUSCI_A_UART_MODE,                       // UART mode
-		EUSCI_A_UART_LOW_FREQUENCY_BAUDRATE_GENERATION  // No iversampling
-};
+#define XBEE_BAUD_COUNT (sizeof(xbee_bauds) / sizeof(xbee_bauds[0]))
+#define XBEE_BAUD_DEFAULT 0			// ATBD3, rate of the XBee after ATRE
+
+static int xbee_baud = XBEE_BAUD_DEFAULT;	// index of the rate in use
+
+uint32_t xbee_node_id = 0;
+
+uint8_t xbee_join_path = XBEE_JOIN_SCAN;
+uint32_t xbee_join_ms = 0;
+
+// switch the UART to a rate of the table, the RX DMA channel stays armed
+static void set_baud(int index) {
+    MAP_UART_disableModule(EUSCI_A2_BASE);
+    MAP_UART_initModule(EUSCI_A2_BASE, &xbee_bauds[index].config);
+    MAP_UART_enableModule(EUSCI_A2_BASE);
+    xbee_baud = index;
+}
+
+// enter and leave command mode at a rate of the table, 1 if the module answered
+static int probe_at(int index) {
+	set_baud(index);
+	sw_timer_delay_ms(GUARD_MS);	// no bytes for the guard time before +++
+	if(!enter_cmd_mode())
+		return 0;
+	new_read();
+	transmit_array(XBEE_CMD_EXIT, 5);
+	wait_OK();
+	return 1;
+}
+
+/* Function that finds the rate the XBee module is at by entering command mode at each rate.
+ * Every rate that does not answer costs a guard time and the +++ timeout, so the likely ones
+ * go first: the given index (the rate stored with the network, which the module keeps in its
+ * non-volatile memory), then ATBD3 of a module after ATRE, then the rest.
+ * Returns the index, -1 if none answers */
+static int probe_baud(int first) {
+	int i;
+
+	if(first < 0 || first >= (int)XBEE_BAUD_COUNT)
+		first = XBEE_BAUD_DEFAULT;
+	if(probe_at(first))
+		return first;
+	if(first != XBEE_BAUD_DEFAULT && probe_at(XBEE_BAUD_DEFAULT))
+		return XBEE_BAUD_DEFAULT;
+	for(i = XBEE_BAUD_COUNT - 1; i >= 0; i--) {
+		if(i != first && i != XBEE_BAUD_DEFAULT && probe_at(i))
+			return i;
+	}
+	set_baud(XBEE_BAUD_DEFAULT);
+	return -1;
+}
+
+/* Function that moves the XBee UART to the fastest rate that passes a loopback test: the
+ * rate is set with ATBD and taken over when ATCN has been answered, the UART follows,
+ * then ATBD is read back at the new rate.
+ * A rate that fails is left for the next lower one. A rate that passes is written to the
+ * XBee non-volatile memory (ATWR), so the module comes up at it after a power cycle too and
+ * probe_baud() finds it at the first try. Nothing is written when the module is at the
+ * fastest rate already */
+uint32_t xbee_negotiate_baud() {
+	char bd[2] = { 0, 0 }, response[1];
+	int i, at;
+
+	for(i = XBEE_BAUD_COUNT - 1; i > xbee_baud; i--) {
+		bd[0] = xbee_bauds[i].bd;
+		if(!xbee_CMD(BD_CMD, bd, PARAMETER, "0"))	// OK to ATCN still comes at the old rate
+			continue;
+		set_baud(i);
+		sw_timer_delay_ms(GUARD_MS);
+
+		response[0] = 0;
+		if(xbee_CMD(BD_CMD, "0", READ, response) && response[0] == bd[0]) {
+			sw_timer_delay_ms(GUARD_MS);
+			xbee_CMD(WR_CMD, "0", 0, "0");	// loopback at the new rate passed, keep it
+			break;
+		}
+
+		at = probe_baud(i);		// lost the module, find it again and try a lower rate
+		if(at < 0)
+			at = XBEE_BAUD_DEFAULT;
+		set_baud(at);
+		sw_timer_delay_ms(GUARD_MS);
+	}
+	return xbee_bauds[xbee_baud].rate;
+}
+
+uint32_t xbee_baud_rate() {
+	return xbee_bauds[xbee_baud].rate;
+}
 
 /* DMA used to fill the RXBuffer when receiving data via UART */
 void init_DMA() {
-	memset(RXBuffer, 0x00, 100);	// reset RXBuffer, so that new data can be read in
+	memset(RXBuffer, 0x00, RX_DMA_LEN);	// reset RXBuffer, so that new data can be read in
 
     /* Configuring DMA module */
     MAP_DMA_enableModule();
@@ -77,70 +176,214 @@ void init_DMA() {
     MAP_DMA_setChannelControl(UDMA_PRI_SELECT | DMA_CH5_EUSCIA2RX,
             UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_1);
     MAP_DMA_setChannelTransfer(UDMA_PRI_SELECT | DMA_CH5_EUSCIA2RX,
-            UDMA_MODE_BASIC, (void*)MAP_UART_getReceiveBufferAddressForDMA(EUSCI_A2_BASE), RXBuffer, 100);
+            UDMA_MODE_BASIC, (void*)MAP_UART_getReceiveBufferAddressForDMA(EUSCI_A2_BASE), RXBuffer, RX_DMA_LEN);
 
     /* Now that the DMA is primed and setup, enabling the channels. The EUSCI
      * hardware should take over and transfer/receive all bytes */
     MAP_DMA_enableChannel(5);
 }
 
-/* Function that initializes UART operation, initialize DMA, resets the XBee module,
- * waits for XBee module to join a network, then sends the XBee devices address to the
- * coordinator.
+/*
+ * Several AT commands in one command mode session, one guard time for all of them
+ * instead of one per command as with xbee_CMD()
  */
-void init_XBEE() {
-	char OI_response[4], SH_response[6], SL_response[8];
-	const char OI_no_connect[4] = "FFFF";
 
-    /* Selecting P3.2(RX) and P3.3(TX) in UART mode */
-    MAP_GPIO_setAsPeripheralModuleFunctionInputPin(GPIO_PORT_P3,
-            GPIO_PIN2 | GPIO_PIN3, GPIO_PRIMARY_MODULE_FUNCTION);
+// enter command mode after the guard time
+static int at_enter() {
+	sw_timer_delay_ms(GUARD_MS);
+	return enter_cmd_mode();
+}
 
-    /* Setting DCO to 12MHz */
-    CS_setDCOCenteredFrequency(CS_DCO_FREQUENCY_24);
+// send a command, with a parameter if length > 0, and wait for its OK
+static int at_set(XBEE_CMD cmd, const char param[], int length) {
+	new_read();
+	transmit_array(cmd.cmd_name, cmd.cmd_length);
+	transmit_array((char *)param, length);
+	transmit_array(XBEE_CR, 1);
+	return wait_OK() == GOT_OK;
+}
 
-    /* Configuring UART Module */
-    MAP_UART_initModule(EUSCI_A2_BASE, &uartConfig);
+// read a register, the hex digits up to the carriage return are copied to value (at most max)
+static int at_query(XBEE_CMD cmd, char value[], int max) {
+	int i;
 
-    /* Enable UART module */
-    MAP_UART_enableModule(EUSCI_A2_BASE);
+	new_read();
+	transmit_array(cmd.cmd_name, cmd.cmd_length);
+	transmit_array(XBEE_CR, 1);
+	if(!wait_CR())
+		return 0;
+	for(i = 0; i < max && RXBuffer[i] != 0x0D; i++)
+		value[i] = RXBuffer[i];
+	return i;
+}
 
-    /* Using DMA to put incoming UART in to RXBuffer */
-    init_DMA();
+static void at_exit() {
+	new_read();
+	transmit_array(XBEE_CMD_EXIT, 5);
+	wait_OK();
+}
+
+// write value as upper case hex, digits characters
+static void value_to_hex(char str[], uint32_t value, int digits) {
+	while(digits--) {
+		str[digits] = "0123456789ABCDEF"[value & 0x0F];
+		value >>= 4;
+	}
+}
+
+/* Function that reads the network the module is on, returns 0 if it is not on one */
+static int read_network(NET_STATE *state) {
+	char response[16];
+	int ok, len;
+
+	memset(state, 0, sizeof(NET_STATE));
+	if(!at_enter())
+		return 0;
+
+	ok = (len = at_query(OI_CMD, response, 4)) > 0;
+	state->oi = hex_to_value(response, len);
+	ok = ok && (len = at_query(OP_CMD, response, 16)) > 0;
+	memset(state->pan_id, '0', 16);				// ATOP drops leading zeros, ATID takes all 16 digits
+	memcpy(&state->pan_id[16 - len], response, len);
+	ok = ok && (len = at_query(CH_CMD, response, 2)) > 0;
+	state->channel = hex_to_value(response, len);
+	ok = ok && (len = at_query(DH_CMD, response, 8)) > 0;
+	state->dh = hex_to_value(response, len);
+	ok = ok && (len = at_query(DL_CMD, response, 8)) > 0;
+	state->dl = hex_to_value(response, len);
+	at_exit();
+
+	return ok && state->oi != 0xFFFF;
+}
+
+/* Function that puts the module back on the network stored in flash, without the reset
+ * and the scan of every channel. The scan channels (ATSC) are limited to the stored one
+ * and stay so until the next ATRE: changing them back would make the module leave the
+ * network again. Returns 1 once the module reports the stored operating PAN */
+static int rejoin_cached(const NET_STATE *cached) {
+	NET_STATE now;
+	char sc[4], dh[8], dl[8];
+	uint32_t deadline;
+	int ok;
+
+	if(read_network(&now) && now.oi == cached->oi && !memcmp(now.pan_id, cached->pan_id, 16)) {
+		xbee_join_path = XBEE_JOIN_KEPT;	// nothing to do, the module never left
+		return 1;
+	}
+	if(cached->channel < 0x0B || cached->channel > 0x1A)
+		return 0;
+
+	value_to_hex(sc, 1UL << (cached->channel - 0x0B), 4);
+	value_to_hex(dh, cached->dh, 8);
+	value_to_hex(dl, cached->dl, 8);
+	if(!at_enter())
+		return 0;
+	ok = at_set(ID_EXT_CMD, cached->pan_id, 16) && at_set(SC_CMD, sc, 4)
+			&& at_set(DH_CMD, dh, 8) && at_set(DL_CMD, dl, 8) && at_set(AC_CMD, 0, 0);
+	at_exit();
+	if(!ok)
+		return 0;
+
+	deadline = sw_timer_deadline(XBEE_REJOIN_MS);
+	do {
+		if(read_network(&now) && now.oi == cached->oi) {
+			xbee_join_path = XBEE_JOIN_CACHED;
+			return 1;
+		}
+	} while(!sw_timer_passed(deadline));
+	return 0;
+}
+
+/* Function that resets the XBee module and lets it scan for a network (ATID 0) */
+static void join_scan() {
+	char OI_response[4];
+	const char OI_no_connect[4] = "FFFF";
 
-    // commands to initialize the XBee module
-    // need to eliminate the 1 second delay between each XBee command by writing a function that takes an array of XBee commands
     xbee_CMD(RE_CMD, "0", WRITE_CMD | APPLY_CHANGE | WRITE_NO_PARAM, "0");
-    _delay_cycles(30000000);
+    set_baud(XBEE_BAUD_DEFAULT);	// ATRE restores ATBD3
+    sw_timer_delay_ms(GUARD_MS);
     xbee_CMD(ID_CMD, "2F0A", WRITE_CMD | APPLY_CHANGE | PARAMETER, "0");	// set pan id to random value
-    _delay_cycles(30000000);
+    sw_timer_delay_ms(GUARD_MS);
     xbee_CMD(ID_CMD, "0000", WRITE_CMD | APPLY_CHANGE | PARAMETER, "0");	// set pan id to zero to join network
-    _delay_cycles(30000000);
+    sw_timer_delay_ms(GUARD_MS);
 
     xbee_CMD(OI_CMD, "0", READ, OI_response);	// set pan id to zero, so that the XBee module joins a network
-    _delay_cycles(30000000);
+    sw_timer_delay_ms(GUARD_MS);
 
-    // wait for the node to join the network
+    // wait for the node to join the network. Every ATOI is a command mode session of its own,
+    // so polling once per guard time is as fast as the module can be asked
     while(!strncmp(OI_response, OI_no_connect, 4)) {
     	xbee_CMD(OI_CMD, "0", READ, OI_response);	// check if the operating pan id has changed (node has joined a network)
-        _delay_cycles(30000000);
+        sw_timer_delay_ms(GUARD_MS);
     }
+    xbee_join_path = XBEE_JOIN_SCAN;
+}
+
+/* Function that initializes UART operation, initialize DMA, puts the XBee module on
+ * the network (the stored one first, net_state.h), then sends the XBee devices address
+ * to the coordinator.
+ */
+void init_XBEE() {
+	char SH_response[6], SL_response[8];
+	NET_STATE cached, joined;
+	int have_cached, have_joined;
+	uint8_t phase = energy_begin(ENERGY_PHASE_XBEE_CMD);
+
+    /* Selecting P3.2(RX) and P3.3(TX) in UART mode */
+    MAP_GPIO_setAsPeripheralModuleFunctionInputPin(GPIO_PORT_P3,
+            GPIO_PIN2 | GPIO_PIN3, GPIO_PRIMARY_MODULE_FUNCTION);
+
+    /* CTS of the module. Pulled down, so a board without the line still sends, unpaced */
+    MAP_GPIO_setAsInputPinWithPullDownResistor(XBEE_CTS_PORT, XBEE_CTS_PIN);
+
+    /* Configuring UART Module, SMCLK is set up by init_clocks() */
+    set_baud(XBEE_BAUD_DEFAULT);
+
+    /* Using DMA to put incoming UART in to RXBuffer */
+    init_DMA();
+
+    // find the module, at the rate stored with the network if there is one
+    have_cached = net_state_load(&cached);
+    if(probe_baud(have_cached ? cached.baud : XBEE_BAUD_DEFAULT) < 0)
+    	set_baud(XBEE_BAUD_DEFAULT);
+
+    // rejoin the network of the last boot, reset and scan only if that fails
+    if(!have_cached || !rejoin_cached(&cached))
+    	join_scan();
+    xbee_join_ms = sw_timer_ms(sw_timer_now());
+
+    have_joined = read_network(&joined);
+    sw_timer_delay_ms(GUARD_MS);
 
 	xbee_CMD(SH_CMD, "0", READ, SH_response);	// get the serial high addr to send to coordinator
-    _delay_cycles(30000000);
+    sw_timer_delay_ms(GUARD_MS);
 	xbee_CMD(SL_CMD, "0", READ, SL_response);	// get the serial low addr to send to coordinator
-    _delay_cycles(30000000);
+    sw_timer_delay_ms(GUARD_MS);
+
+    xbee_node_id = hex_to_value(SL_response, SL_CMD.cmd_param_len);	// node ID in the image header
+
+    xbee_CMD(D7_CMD, "1", APPLY_CHANGE | PARAMETER, "0");	// CTS flow control, ATRE may have reset it
+    sw_timer_delay_ms(GUARD_MS);
+
+    xbee_negotiate_baud();	// fastest rate the UART link to the module passes the loopback at
+
+    if(have_joined) {
+    	joined.baud = xbee_baud;
+    	net_state_save(&joined);	// written only when the network or the rate changed
+    }
 
     // transmit the address of the node to the coordinator for verification
     transmit_array(SH_response, SH_CMD.cmd_param_len);
     transmit_array(SL_response, SL_CMD.cmd_param_len);
+
+    energy_end(phase);
 }
 
 // Function that resets DMA destination address for a new read
 void new_read() {
-	memset(RXBuffer, 0x00, 100);	// reset RXBuffer, so that new data can be read in
+	memset(RXBuffer, 0x00, RX_DMA_LEN);	// reset RXBuffer, so that new data can be read in
     MAP_DMA_setChannelTransfer(UDMA_PRI_SELECT | DMA_CH5_EUSCIA2RX,
-            UDMA_MODE_BASIC, (void*)MAP_UART_getReceiveBufferAddressForDMA(EUSCI_A2_BASE), RXBuffer, 100);
+            UDMA_MODE_BASIC, (void*)MAP_UART_getReceiveBufferAddressForDMA(EUSCI_A2_BASE), RXBuffer, RX_DMA_LEN);
     MAP_DMA_enableChannel(5);
 }
 
@@ -148,49 +391,58 @@ void new_read() {
 void reset_dma() {
 	memset(RXBuffer, 0x00, 1);	// reset RXBuffer, so that new data can be read in
     MAP_DMA_setChannelTransfer(UDMA_PRI_SELECT | DMA_CH5_EUSCIA2RX,
-            UDMA_MODE_BASIC, (void*)MAP_UART_getReceiveBufferAddressForDMA(EUSCI_A2_BASE), RXBuffer, 100);
+            UDMA_MODE_BASIC, (void*)MAP_UART_getReceiveBufferAddressForDMA(EUSCI_A2_BASE), RXBuffer, RX_DMA_LEN);
     MAP_DMA_enableChannel(5);
     MAP_Interrupt_enableInterrupt(INT_DMA_INT1);
     MAP_Interrupt_disableSleepOnIsrExit();
 }
 
-void transmit_image(unsigned char array[], int length) {
-    /* Disable UART module to reconfigure settings */
-    MAP_UART_disableModule(EUSCI_A2_BASE);
-
-    /* Reconfiguring UART Module for image transmission */
-    MAP_UART_initModule(EUSCI_A2_BASE, &uartConfig_image);
-
-    /* Re-enable UART module */
-    MAP_UART_enableModule(EUSCI_A2_BASE);
+// wait until CTS is low, 0 if the module keeps it high for the response timeout
+static int wait_cts() {
+	uint32_t deadline;
+
+	if(!MAP_GPIO_getInputPinValue(XBEE_CTS_PORT, XBEE_CTS_PIN))
+		return 1;
+	deadline = sw_timer_deadline(TIMEOUT_MS);
+	do {
+		sw_timer_delay_ms(POLL_MS);		// the radio empties the buffer, sleep meanwhile
+		if(!MAP_GPIO_getInputPinValue(XBEE_CTS_PORT, XBEE_CTS_PIN))
+			return 1;
+	} while(!sw_timer_passed(deadline));
+	return 0;
+}
 
+/* Function that transmits an image to the XBee module via UART, same rate as commands.
+ * Every byte waits for CTS: the UART is faster than the radio, without the pacing the
+ * module's serial buffer overruns. A module that stops taking bytes ends the image early,
+ * it stays in the flash log until the coordinator acknowledges it */
+void transmit_image(unsigned char array[], int length) {
 	int i = 0;
 	uint_fast8_t byte_to_transmit = 0;
+	uint8_t phase = energy_begin(ENERGY_PHASE_TRANSMIT);
 
+	energy_radio_tx(1);	// transparent mode, the module sends while the UART feeds it
 	for(i = 0; i < length; i++) {
 		byte_to_transmit = array[i];
+		if(!wait_cts())
+			break;
 		while (!(UCA2IFG&UCTXIFG));
 		MAP_UART_transmitData(EUSCI_A2_BASE, byte_to_transmit);
 		MAP_UART_clearInterruptFlag(EUSCI_A2_BASE, EUSCI_A_UART_TRANSMIT_INTERRUPT_FLAG );
 	}
-
-    /* Disable UART module to reconfigure settings */
-    MAP_UART_disableModule(EUSCI_A2_BASE);
-
-    /* Reconfiguring UART Module for normal operation */
-    MAP_UART_initModule(EUSCI_A2_BASE, &uartConfig);
-
-    /* Re-enable UART module */
-    MAP_UART_enableModule(EUSCI_A2_BASE);
+	energy_radio_tx(0);
+	energy_end(phase);
 }
 
-/* Function that transmits char array to XBee module via UART */
+/* Function that transmits char array to XBee module via UART, paced by CTS like an image */
 void transmit_array(char array[], int length) {
 	int i = 0;
 	uint_fast8_t byte_to_transmit = 0;
 
 	for(i = 0; i < length; i++) {
 		byte_to_transmit = array[i];
+		if(!wait_cts())
+			break;
 		while (!(UCA2IFG&UCTXIFG));
 		MAP_UART_transmitData(EUSCI_A2_BASE, byte_to_transmit);
 		MAP_UART_clearInterruptFlag(EUSCI_A2_BASE, EUSCI_A_UART_TRANSMIT_INTERRUPT_FLAG );
@@ -198,60 +450,81 @@ void transmit_array(char array[], int length) {
 }
 
 // function that searches RXBuffer for response --- should be near beginning of the buffer
-uint8_t wait_OK() {
+static uint8_t find_OK() {
 	int i = 0;
 
-	// NEED TO FIX TIMEOUT
-    MAP_SysTick_enableModule();
-    MAP_SysTick_setPeriod(TIMEOUT_PERIOD);	// 1 sec timeout
-
-    while(MAP_SysTick_getValue() != TIMEOUT_PERIOD-1) {
-		for(i = 2; i < RXBuffer_size; i++) {
-			if(RXBuffer[i - 2] == 'O' && RXBuffer[i - 1] == 'K' && RXBuffer[i] == 0x0D)
-				return GOT_OK;
-			else if(RXBuffer[i - 2] == 'E' && RXBuffer[i - 1] == 'R' && RXBuffer[i] == 'R')
-				return GOT_ERROR;
-		}
+	for(i = 2; i < RXBuffer_size; i++) {
+		if(RXBuffer[i - 2] == 'O' && RXBuffer[i - 1] == 'K' && RXBuffer[i] == 0x0D)
+			return GOT_OK;
+		else if(RXBuffer[i - 2] == 'E' && RXBuffer[i - 1] == 'R' && RXBuffer[i] == 'R')
+			return GOT_ERROR;
 	}
+	return NO_RESPONSE;
+}
 
-	MAP_SysTick_disableModule();
+/* The waits below scan RXBuffer once more after the deadline has passed, so a response
+ * that came in during the last sleep is not taken for a timeout */
 
-    return 0;
+// function that waits up to ms for OK or ERROR
+static uint8_t wait_OK_ms(uint32_t ms) {
+	uint32_t deadline = sw_timer_deadline(ms);
+	uint8_t found;
+
+	while((found = find_OK()) == NO_RESPONSE) {
+		if(sw_timer_passed(deadline))
+			return TIMEOUT;
+		sw_timer_delay_ms(POLL_MS);
+	}
+	return found;
+}
+
+uint8_t wait_OK() {
+	return wait_OK_ms(TIMEOUT_MS);
 }
 
 // function that searches RXBuffer for carriage return (end of response)
 uint8_t wait_CR() {
 	int i = 0;
+	uint32_t deadline = sw_timer_deadline(TIMEOUT_MS);
 
-	// NEED TO FIX TIMEOUT
-    MAP_SysTick_enableModule();
-    MAP_SysTick_setPeriod(TIMEOUT_PERIOD);	// 1 sec timeout
-
-	while(MAP_SysTick_getValue() != TIMEOUT_PERIOD-1) {
+	for(;;) {
 		for(i = 0; i < RXBuffer_size; i++) {
 			if(RXBuffer[i] == 0x0D)
 				return GOT_OK;
 		}
+		if(sw_timer_passed(deadline))
+			return TIMEOUT;
+		sw_timer_delay_ms(POLL_MS);
 	}
+}
 
-	MAP_SysTick_disableModule();
+// function that waits until DMA has put count bytes into RXBuffer (binary payloads can contain 0x0D)
+uint8_t wait_bytes(int count) {
+	uint32_t deadline = sw_timer_deadline(TIMEOUT_MS);
 
-	return 0;
+	for(;;) {
+		if(RX_DMA_LEN - DMA_getChannelSize(UDMA_PRI_SELECT | DMA_CH5_EUSCIA2RX) >= count)
+			return GOT_OK;
+		if(sw_timer_passed(deadline))
+			return TIMEOUT;
+		sw_timer_delay_ms(POLL_MS);
+	}
 }
 
-/* Function that sends command to XBEE module
- * XBEE_CMD cmd --- is the structure for the specific command
- * unsigned char param[] --- is the optional parameter of the command to be sent
- * unsigned char option --- determines different aspects of command (write to non-volatile XBEE mem, apply changes imm., etc.)
- */
-uint8_t xbee_CMD(XBEE_CMD cmd, char param[], unsigned char option, char *read_value) {
+// send +++ (the guard time has to have passed) and wait for the module to enter command mode
+static int enter_cmd_mode() {
+	new_read();
+	transmit_array(XBEE_CMD_START, 3);
+	return wait_OK_ms(CMD_MODE_TIMEOUT_MS) == GOT_OK;
+}
 
-	new_read(); // restart DMA to get new responses
-	transmit_array(XBEE_CMD_START, 3);	// enter command mode
-	if(!wait_OK()) // wait for OK, ERROR or TIMEOUT
+// one command mode session, the work of xbee_CMD()
+static uint8_t cmd_session(XBEE_CMD cmd, char param[], unsigned char option, char *read_value) {
+
+	if(!enter_cmd_mode())	// +++, wait for OK, ERROR or TIMEOUT
 		return 0;	// return 0, if failed
 
-	_delay_cycles(1000);
+	sw_timer_delay_ms(1);
 
 	new_read(); // restart DMA to get new response
 	transmit_array(cmd.cmd_name, cmd.cmd_length);	// send command
@@ -291,6 +564,19 @@ uint8_t xbee_CMD(XBEE_CMD cmd, char param[], unsigned char option, char *read_va
 	return 1;
 }
 
+/* Function that sends command to XBEE module
+ * XBEE_CMD cmd --- is the structure for the specific command
+ * unsigned char param[] --- is the optional parameter of the command to be sent
+ * unsigned char option --- determines different aspects of command (write to non-volatile XBEE mem, apply changes imm., etc.)
+ */
+uint8_t xbee_CMD(XBEE_CMD cmd, char param[], unsigned char option, char *read_value) {
+	uint8_t phase = energy_begin(ENERGY_PHASE_XBEE_CMD);
+	uint8_t ok = cmd_session(cmd, param, option, read_value);
+
+	energy_end(phase);
+	return ok;
+}
+
 int read_coordinates() {
 	int i = 0;
 
@@ -308,6 +594,22 @@ int read_coordinates() {
 	return 1;
 }
 
+// function that converts the ascii hex digits of an XBee response to a value, stops at the first non-digit
+uint32_t hex_to_value(const char str[], int length) {
+	uint32_t value = 0;
+	int i = 0;
+
+	for(i = 0; i < length; i++) {
+		if(str[i] >= '0' && str[i] <= '9')
+			value = value << 4 | (str[i] - '0');
+		else if(str[i] >= 'A' && str[i] <= 'F')
+			value = value << 4 | (str[i] - 'A' + 10);
+		else
+			break;
+	}
+	return value;
+}
+
 // function takes in hex value and converts to ascii hex value
 void hex_to_char(unsigned char *format_str, unsigned char hex_value) {
 	unsigned char upper = (0xF0 & hex_value) >> 4, lower = 0x0F & hex_value;	// mask upper and lower bytes
@@ -350,19 +652,18 @@ void setup_node() {
 //	hex_array_to_ascii(addr_low_str, addr_low, ADDR_LOW_LEN);
 
     xbee_CMD(ID_CMD, pan_id, WRITE_CMD | APPLY_CHANGE | PARAMETER, "0");
-    _delay_cycles(30000000);
+    sw_timer_delay_ms(GUARD_MS);
 	xbee_CMD(EE_CMD, "1", WRITE_CMD | APPLY_CHANGE | PARAMETER, "0");
 	//xbee_CMD(KY_CMD, session_key_str, WRITE_CMD | APPLY_CHANGE | PARAMETER);
-	_delay_cycles(30000000);
+	sw_timer_delay_ms(GUARD_MS);
 	xbee_CMD(KY_CMD, session_key, WRITE_CMD | APPLY_CHANGE | PARAMETER, "0");
-	_delay_cycles(30000000);
+	sw_timer_delay_ms(GUARD_MS);
 
 }
 
 // function that sets the session key
 int set_session_key() {
 	int i = 0;
-	//unsigned char session_key_str[ADDR_HIGH_LEN * 2];
 
 	if(!wait_CR())	// wait for end of response from XBee module
 		return 0;
@@ -371,13 +672,19 @@ int set_session_key() {
 	for(i = 0; i < SESSION_KEY_LEN; i++)
 		session_key[i] = RXBuffer[i + 1];
 
+	return apply_session_key();
+}
+
+// function that loads session_key into the XBee module and acknowledges the coordinator
+int apply_session_key() {
+	//unsigned char session_key_str[ADDR_HIGH_LEN * 2];
 	//hex_array_to_ascii(session_key_str, session_key, SESSION_KEY_LEN * 2);
 
 	xbee_CMD(EE_CMD, "1", WRITE_CMD | APPLY_CHANGE | PARAMETER, "0");
 	//xbee_CMD(KY_CMD, session_key_str, WRITE_CMD | APPLY_CHANGE | PARAMETER);
-	_delay_cycles(30000000);
+	sw_timer_delay_ms(GUARD_MS);
 	xbee_CMD(KY_CMD, session_key, WRITE_CMD | APPLY_CHANGE | PARAMETER, "0");
-	_delay_cycles(30000000);
+	sw_timer_delay_ms(GUARD_MS);
 
 	new_read(); // restart DMA to get new response
 
@@ -386,9 +693,9 @@ int set_session_key() {
 
 	// Send two 'OK's to the ZigBee coordinator
     transmit_array(OK_RESPONSE, 2);
-	_delay_cycles(30000000);
+	sw_timer_delay_ms(GUARD_MS);
     transmit_array(OK_RESPONSE, 2);
-	_delay_cycles(30000000);
+	sw_timer_delay_ms(GUARD_MS);
     transmit_array(OK_RESPONSE, 2);
 
 	return 1;
@@ -13,6 +13,13 @@
 #define READ 0x04
 #define PARAMETER 0x08
 
+/* DIO7/CTS of the module (pin 12) with ATD7 1, low while its serial buffer can take bytes.
+ * The RF data rate is below the UART rate, an image is paced by this line */
+#define XBEE_CTS_PORT GPIO_PORT_P2
+#define XBEE_CTS_PIN GPIO_PIN7
+
+#define RX_DMA_LEN 100			// bytes of one UART RX DMA transfer into RXBuffer, the longest message the node takes
+
 #define COORD_LENGTH 24
 char x_coord[24];
 char y_coord[24];
@@ -23,6 +30,17 @@ char pan_id[PAN_ID_LEN];
 #define SESSION_KEY_LEN 32
 char session_key[SESSION_KEY_LEN];
 
+extern uint32_t xbee_node_id;	// serial number low (ATSL) of the module, read by init_XBEE()
+
+/* How init_XBEE() got the module onto the network */
+#define XBEE_JOIN_SCAN 0				// reset and scan of all channels
+#define XBEE_JOIN_CACHED 1				// PAN and channel of net_state.h
+#define XBEE_JOIN_KEPT 2				// module was still on the stored network, only the MSP432 was reset
+#define XBEE_REJOIN_MS 10000			// direct rejoin is given up after this
+
+extern uint8_t xbee_join_path;
+extern uint32_t xbee_join_ms;		// ms after reset the node was on the network
+
 // XBEE command structure
 // cmd_param = 0 --- no parameters allowed with command
 // 			 = 1 --- parameters optional
@@ -35,6 +53,8 @@ typedef struct _xbee_cmd {
 }XBEE_CMD;
 
 void init_XBEE();
+uint32_t xbee_negotiate_baud();
+uint32_t xbee_baud_rate();
 void new_read();
 void reset_dma();
 void transmit_image(unsigned char array[], int length);
@@ -42,5 +62,9 @@ void transmit_array(char array[], int length);
 uint8_t xbee_CMD(XBEE_CMD cmd, char param[], unsigned char option, char *read_value);
 void setup_node();
 int set_session_key();
+int apply_session_key();
+uint8_t wait_bytes(int count);
+uint32_t hex_to_value(const char str[], int length);
+void hex_array_to_ascii(unsigned char *format_str, unsigned char hex_value[], int length);
 
 #endif /* XBEE_DRIVER_H_ */